@@ -0,0 +1,86 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+/*
+ *  async_writer.hpp
+ *  hector
+ *
+ *  Writes blocks of output to a stream on a background thread.
+ *
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! Blocks of output that may be waiting to be written
+#define ASYNC_WRITER_BLOCKS 4
+
+namespace Hector {
+
+/*! \brief Writes blocks of output to a stream on a background thread.
+ *
+ *  Blocks are handed over through a bounded single-producer, single-consumer
+ *  ring: the producer fills a slot and advances the tail, and the writer
+ *  thread writes the slot and advances the head.  The ring itself needs no
+ *  lock, but after each handoff the thread that made it briefly takes a
+ *  mutex to wake the other (see wake_all), which may be asleep on a
+ *  condition variable because the ring was empty (writer) or full
+ *  (producer).  So the producer waits on the disk only when it is more than
+ *  ASYNC_WRITER_BLOCKS blocks ahead.
+ *
+ *  If writing fails, the rest of the output is dropped and the error is
+ *  thrown from the next flush().
+ *
+ *  Handing over a block swaps it with the slot's old, already written
+ *  string, so block memory is reused rather than reallocated.
+ */
+class AsyncWriter {
+public:
+  AsyncWriter(std::ostream &out, const size_t blocks = ASYNC_WRITER_BLOCKS);
+  ~AsyncWriter();
+
+  void write(std::string &block);
+  void flush();
+
+private:
+  void run();
+  void wake_all();
+
+  //! The stream written to; only the writer thread touches it until flush()
+  std::ostream &out;
+
+  //! Blocks waiting to be written
+  std::vector<std::string> ring;
+
+  //! Blocks written (head) and handed over (tail) so far
+  std::atomic<size_t> head;
+  std::atomic<size_t> tail;
+
+  //! Set when the writer should finish what's queued and stop
+  std::atomic<bool> stopping;
+
+  //! The first error writing out, if any; set by the writer thread before it
+  //! advances the head, so whoever sees the head advance sees it too
+  std::exception_ptr error;
+
+  //! For sleeping when there's nothing to do
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+
+  std::thread writer;
+};
+
+} // namespace Hector
+
+#endif // ASYNC_WRITER_H
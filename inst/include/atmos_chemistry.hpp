@@ -0,0 +1,40 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef ATMOS_CHEMISTRY_H
+#define ATMOS_CHEMISTRY_H
+/*
+ *  atmos_chemistry.hpp
+ *  hector
+ *
+ *  Fused chemistry step for the CH4, OH, O3 and N2O components.
+ *
+ */
+
+namespace Hector {
+
+class Core;
+
+//------------------------------------------------------------------------------
+/*! \brief Fused atmospheric chemistry step.
+ *
+ *  Normally the OH, CH4, ozone and N2O components each run on their own and
+ *  pass lifetimes and concentrations to each other through the core. With
+ *  the core's fused_chemistry option set, whichever of them runs first in a
+ *  year calls AtmosChemistry::run, which advances all four in one pass,
+ *  handing each its inputs directly; the others then have nothing left to
+ *  do that year. The components still store their own results, so all of
+ *  their capabilities (and output) are unchanged, and the numbers are the
+ *  same as the unfused run.
+ */
+class AtmosChemistry {
+public:
+  static void run(Core *core, const double runToDate);
+};
+
+} // namespace Hector
+
+#endif // ATMOS_CHEMISTRY_H
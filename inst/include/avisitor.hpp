@@ -37,6 +37,8 @@ class OceanComponent;
 class SulfurComponent;
 class OzoneComponent;
 
+struct tracking_columns;
+
 //------------------------------------------------------------------------------
 /*! \brief AVisitor abstract class provides a base for subclasses to visit only
  *         the IVisitable subclasses that they are interested in.
@@ -65,6 +67,12 @@ public:
    */
   virtual void outputTrackingData(std::ostream &tracking_out) const {}
 
+  //------------------------------------------------------------------------------
+  /*! \brief Append Tracking Data, as columns, if applicable.
+   *  \param columns The columns to append results to.
+   */
+  virtual void outputTrackingColumns(tracking_columns &columns) const {}
+
   //------------------------------------------------------------------------------
   // Add a visit for all visitable subclasses here.
   // TODO: should we create a .cpp for these?
@@ -42,6 +42,8 @@ public:
                               const message_data info = message_data());
 
   virtual void setData(const std::string &varName, const message_data &data);
+  virtual void setSeries(const std::string &varName,
+                         const tseries<unitval> &series);
 
   virtual void prepareToRun();
 
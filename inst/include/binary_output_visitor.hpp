@@ -0,0 +1,87 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef BINARY_OUTPUT_VISITOR_H
+#define BINARY_OUTPUT_VISITOR_H
+/*
+ *  binary_output_visitor.hpp
+ *  hector
+ *
+ *  Columnar binary output of selected variables.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include "avisitor.hpp"
+
+namespace Hector {
+
+class IModelComponent;
+class Logger;
+
+/*! \brief A visitor which records selected variables in columns and writes
+ *         them to a binary file.
+ *
+ *  The variables (time series capabilities, as for R's fetchvars) are looked
+ *  up once, when the core is prepared to run; each (non-spinup) year their
+ *  values are appended to one column per variable, and the columns are
+ *  written out by write().
+ *
+ *  File layout (native byte order, all sizes unsigned):
+ *      - the magic "HCOL", a 32-bit version, a 32-bit column count and a
+ *        64-bit row count
+ *      - for each column, its name and units (each a 32-bit length and
+ *        bytes) and a type byte ('d' for 64-bit floating point)
+ *      - the data, one column after another, each row count values long
+ *  The first column is "year".  As every column is a fixed length, a reader
+ *  can seek straight to the few it wants.
+ */
+class BinaryOutputVisitor : public AVisitor {
+public:
+  BinaryOutputVisitor(const std::string &fileName,
+                      const std::vector<std::string> &variables);
+  ~BinaryOutputVisitor();
+
+  virtual bool shouldVisit(const bool in_spinup, const double date);
+  virtual void reset(const double reset_date);
+
+  virtual void visit(Core *c);
+
+  void write();
+
+private:
+  //! The file to write to
+  const std::string fileName;
+
+  //! Variables recorded, and the components providing them
+  std::vector<std::string> names;
+  std::vector<IModelComponent *> sources;
+
+  //! Units of each variable
+  std::vector<std::string> units;
+
+  //! Recorded years, and the values of each variable in them
+  std::vector<double> years;
+  std::vector<std::vector<double>> columns;
+
+  //! Date being visited
+  double current_date;
+
+  //! Whether the next visit is to record a row
+  bool recording;
+
+  //! Whether everything recorded has been written
+  bool written;
+
+  //! Log of the core visited, for write errors the destructor can't throw
+  Logger *glog;
+};
+
+} // namespace Hector
+
+#endif // BINARY_OUTPUT_VISITOR_H
@@ -19,6 +19,8 @@
 #include "carbon-cycle-model.hpp"
 #include "h_util.hpp"
 #include "logger.hpp"
+#include "profiler.hpp"
+#include "tseries.hpp"
 
 #define MAX_CARBON_MODEL_RETRIES 8
 
@@ -96,22 +98,61 @@ private:
   double eps_rel;
   //! Default stepsize (years) -- the integrator will adjust this as required
   double dt;
+  //! Stepsize given as input, which a rerun spinup starts from again
+  double dt_input;
+  //! Stepsize at the end of each year run (retries shorten it)
+  tseries<double> dt_ts;
 
   unitval eps_spinup; //! spinup epsilon (drift/tolerance), Pg C
 
+  /*! \brief Work done by the solver over one time step
+   *
+   *  Rejected steps are attempts the step size controller threw away as too
+   *  inaccurate.  Retries are restarts with a shorter target the carbon
+   *  model asked for (CARBON_CYCLE_RETRY).  final_dt is the step size the
+   *  controller proposed after the last accepted step.
+   */
+  struct solver_stats {
+    solver_stats()
+        : evaluations(0), accepted(0), rejected(0), retries(0),
+          final_dt(0.0) {}
+    unsigned long evaluations;
+    unsigned long accepted;
+    unsigned long rejected;
+    unsigned long retries;
+    double final_dt;
+  };
+  //! Statistics of the last step run
+  solver_stats stats;
+
+  //! Statistics of each year run
+  tseries<unitval> rhs_evals_ts;
+  tseries<unitval> accepted_steps_ts;
+  tseries<unitval> rejected_steps_ts;
+  tseries<unitval> retries_ts;
+  tseries<unitval> final_dt_ts;
+
+  void record_stats(double date);
+
   struct bad_derivative_exception {
     bad_derivative_exception(const int status) : errorFlag(status) {}
     int errorFlag;
   };
   // A functor to provide callbacks for the ODE solver.
   struct ODEEvalFunctor {
-    ODEEvalFunctor(CarbonCycleModel *cmodel, double *time)
-        : modelptr(cmodel), t(time) {}
+    ODEEvalFunctor(CarbonCycleModel *cmodel, double *time,
+                   profile_entry *profile, unsigned long *evaluations)
+        : modelptr(cmodel), t(time), profile(profile),
+          evaluations(evaluations) {}
     void operator()(const std::vector<double> &y, std::vector<double> &dydt,
                     double t);
     void operator()(const std::vector<double> &y, double t);
     CarbonCycleModel *modelptr;
     double *t;
+    //! Where calcderivs calls are timed (NULL if not profiling)
+    profile_entry *profile;
+    //! Count of calcderivs calls
+    unsigned long *evaluations;
   };
 
   void failure(int stat, double t0, double tmid);
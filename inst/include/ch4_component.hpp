@@ -22,10 +22,14 @@
 
 namespace Hector {
 
+// Permafrost thaw produces CH4 emissions; this converts them from Pg C
+#define PG_C_TO_TG_CH4 (1000.0 * 16.04 / 12.01)
+
 //------------------------------------------------------------------------------
 /*! \brief Methane model component.
  */
 class CH4Component : public IModelComponent {
+  friend class AtmosChemistry;
 
 public:
   CH4Component();
@@ -41,6 +45,8 @@ public:
                               const message_data info = message_data());
 
   virtual void setData(const std::string &varName, const message_data &data);
+  virtual void setSeries(const std::string &varName,
+                         const tseries<unitval> &series);
 
   virtual void prepareToRun();
 
@@ -55,6 +61,9 @@ public:
 
 private:
   virtual unitval getData(const std::string &varName, const double date);
+  void advance(const double runToDate, const double current_toh,
+               const double rh_ch4);
+
   //! emissions time series
   tseries<unitval> CH4_emissions;
   tseries<unitval> CH4;           // CH4 concentrations, ppbv CH4
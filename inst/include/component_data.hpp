@@ -27,6 +27,8 @@
 #define D_TRACKING_DATE "trackingDate"
 #define D_DO_SPINUP "do_spinup"
 #define D_MAX_SPINUP "max_spinup"
+#define D_FUSED_CHEMISTRY "fused_chemistry"
+#define D_BINARY_OUTPUT "binary_output"
 #define D_ENABLED "enabled"
 #define D_OUTPUT_ENABLED "output"
 
@@ -38,6 +40,11 @@
 #define D_CCS_EPS_REL "eps_rel"
 #define D_CCS_DT "dt"
 #define D_EPS_SPINUP "eps_spinup"
+#define D_SOLVER_RHS_EVALS "solver_rhs_evals"
+#define D_SOLVER_ACCEPTED_STEPS "solver_accepted_steps"
+#define D_SOLVER_REJECTED_STEPS "solver_rejected_steps"
+#define D_SOLVER_RETRIES "solver_retries"
+#define D_SOLVER_FINAL_DT "solver_final_dt"
 
 // forcing component
 #define D_RF_PREFIX "RF_"
@@ -333,6 +340,10 @@
 #define D_CO3_HL "HL_CO3"
 #define D_CO3 "CO3"
 #define D_TIMESTEPS "ocean_timesteps"
+#define D_OCEAN_MAX_TIMESTEP "ocean_max_timestep"
+#define D_OCEAN_BOX_VOLUME_FRAC "volume_frac"
+#define D_OCEAN_BOX_DEEP "deep"
+#define D_OCEAN_TRANSPORT "transport"
 #define D_REVELLE_HL "HL_Revelle"
 #define D_REVELLE_LL "LL_Revelle"
 
@@ -355,6 +366,8 @@
 #define D_TEMPFERTD "detritus_tempfert"
 #define D_TEMPFERTS "soil_tempfert"
 #define D_Q10_RH "q10_rh"
+#define D_Q10_TWINDOW "q10_twindow"
+#define D_Q10_TLAG "q10_tlag"
 #define D_NPP "NPP"
 #define D_RH "RH"
 #define D_RH_DETRITUS "rh_det"
@@ -396,6 +409,7 @@
 #define D_OCEAN_TAS "ocean_tas"
 #define D_LO_WARMING_RATIO "lo_warming_ratio"
 #define D_DIFFUSIVITY "diff"
+#define D_KERNEL_TOL "kernel_tol"
 #define D_AERO_SCALE "alpha"
 #define D_VOLCANIC_SCALE "volscl"
 #define D_FLUX_MIXED "heatflux_mixed"
@@ -22,12 +22,16 @@
 #include "h_exception.hpp"
 #include "ivisitable.hpp"
 #include "logger.hpp"
+#include "profiler.hpp"
+#include "unitval.hpp"
 
 namespace Hector {
 
-class unitval;
 struct message_data;
 class IModelComponent;
+class ScenarioBundle;
+struct tracking_columns;
+template <class T_data> class tseries;
 
 //------------------------------------------------------------------------------
 /*! \brief Core class.
@@ -47,6 +51,12 @@ public:
   void setData(const std::string &componentName, const std::string &varName,
                const message_data &data);
 
+  void setSeries(const std::string &componentName, const std::string &varName,
+                 const std::vector<double> &dates,
+                 const std::vector<double> &values, const unit_types units);
+  void setSeries(const std::string &componentName, const std::string &varName,
+                 const tseries<unitval> &series);
+
   void addVisitor(AVisitor *visitor);
 
   void prepareToRun();
@@ -78,15 +88,32 @@ public:
   unitval sendMessage(const std::string &message, const std::string &datum,
                       const message_data &info);
 
+  void sendSeries(const std::string &datum, const std::vector<double> &dates,
+                  const std::vector<double> &values, const unit_types units);
+
+  void fetchVars(const std::vector<std::string> &vars,
+                 const std::vector<double> &dates,
+                 std::vector<unitval> &results);
+
   unitval getData(const std::string &varName, const double date);
 
   double getStartDate() const { return startDate; };
   double getEndDate() const { return endDate; };
   double getTrackingDate() const { return trackingDate; };
   std::string getTrackingData() const;
+  void getTrackingColumns(tracking_columns &columns) const;
+  //! The last date the components have finished running. Visitors are
+  //! called after the components, so during a visit it is the visited date.
   double getCurrentDate() const { return lastDate; }
   std::string getRun_name() const { return run_name; };
   bool inSpinup() const { return in_spinup; };
+  bool fusedChemistry() const { return fused_chemistry; };
+  std::string getBinaryOutput() const { return binary_output; };
+  void setInputRecorder(ScenarioBundle *recorder) {
+    input_recorder = recorder;
+  }
+  Profiler &getProfiler() { return profiler; }
+  const Profiler &getProfiler() const { return profiler; }
   bool outputEnabled(std::string componentName) {
     return std::find(disabledOutputComponents.begin(),
                      disabledOutputComponents.end(),
@@ -131,6 +158,8 @@ private:
   //! Cause all components to run their spinup procedure.
   bool run_spinup();
 
+  profile_entry *visitorProfile(AVisitor *visitor);
+
   //------------------------------------------------------------------------------
   //! Current run name.
   std::string run_name;
@@ -163,6 +192,26 @@ private:
   //! Maximum number of spinup steps allowed.
   int max_spinup;
 
+  //------------------------------------------------------------------------------
+  //! A flag (can be set from input) to advance CH4, OH, O3 and N2O together
+  //! in one chemistry step, see AtmosChemistry.
+  bool fused_chemistry;
+
+  //------------------------------------------------------------------------------
+  //! Variables (comma separated) for columnar binary output, see
+  //! BinaryOutputVisitor; none if empty.
+  std::string binary_output;
+
+  //------------------------------------------------------------------------------
+  //! If set, every input given to setData/setSeries is also recorded here
+  //! (to compile a scenario bundle).
+  ScenarioBundle *input_recorder;
+
+  //------------------------------------------------------------------------------
+  //! Wall time and calls of each component's steps, the visitors, and
+  //! messages.  Disabled unless asked for.
+  Profiler profiler;
+
   //------------------------------------------------------------------------------
   //! A comparison object to ensure modelComponents are ordered according to
   //! dependencies.
@@ -14,12 +14,21 @@
  *
  */
 
+#include <memory>
 #include <string>
 
+#include "async_writer.hpp"
 #include "avisitor.hpp"
+#include "unitval.hpp"
 
 #define DELIMITER ","
 
+//! Bytes of output collected before writing them to the stream
+#define OUTPUT_BUFFER_SIZE (1 << 16)
+
+//! Significant digits of forcing values
+#define FORCING_PRECISION 4
+
 namespace Hector {
 
 /*! \brief A visitor which will report all results at each model period.
@@ -27,13 +36,17 @@ namespace Hector {
 class CSVOutputStreamVisitor : public AVisitor {
 public:
   CSVOutputStreamVisitor(std::ostream &outputStream,
-                         const bool printHeader = true);
+                         const bool printHeader = true,
+                         const bool background = false);
   ~CSVOutputStreamVisitor();
 
+  void flush();
+
   virtual bool shouldVisit(const bool in_spinup, const double date);
 
   virtual void visit(Core *c);
   virtual void visit(ForcingComponent *c);
+  virtual void visit(CarbonCycleSolver *c);
   virtual void visit(SimpleNbox *c);
   virtual void visit(HalocarbonComponent *c);
   virtual void visit(TemperatureComponent *c);
@@ -50,23 +63,31 @@ private:
   //! The file output stream in which the csv output will be written to.
   std::ostream &csvFile;
 
+  //! Significant digits of the values written (the stream's precision when
+  //! the visitor was made, except for forcings)
+  int precision;
+
   // Data retained while the visitor is operating
   double current_date;
 
   // Spin up Flag
   bool in_spinup;
 
-  //! Current model date, stored as a string for output
-  std::string datestring;
-
-  //! Current model mode, stored as a string for output
-  std::string spinupstring;
-
   //! Name of current run
   std::string run_name;
 
-  //! Helper function: prints beginning of each output line
-  std::string linestamp();
+  //! Beginning of each output line (date, run name and mode), preformatted
+  std::string linestamp;
+  void set_linestamp(const double date);
+
+  //! Output lines not yet written to csvFile
+  std::string buffer;
+  void write_buffer();
+
+  //! Writes full buffers on a background thread, if asked for
+  std::unique_ptr<AsyncWriter> writer;
+  void write_line(const std::string &component, const std::string &var,
+                  const unitval &x);
 
   //! pointers to other components and stuff
   Core *core;
@@ -14,7 +14,9 @@
  *
  */
 
-#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "h_exception.hpp"
 
@@ -34,9 +36,11 @@ class Core;
  * data processed form subsequent rows to provide units checking.
  *
  *  When instructed to process the class requires routing information including
- *  the variable to set so that it can identify which column to process.  It
- * will then route data as each row is read.  Note that the file will remain
- * open and available for reprocessing until it is destructed.
+ *  the variable to set so that it can identify which column to process.  The
+ *  first call to process maps the file into memory (where the platform
+ *  allows) and parses the whole table in place into numeric columns; it, and
+ *  every later call, then routes the requested column from memory, so one
+ *  reader can serve every variable in a table at the cost of a single read.
  */
 class CSVTableReader {
 public:
@@ -50,14 +54,32 @@ private:
   //! The file name to read data from.  Kept around for error reporting.
   const std::string fileName;
 
-  //! Input stream to read data from.
-  std::ifstream tableInputStream;
-
   //! Current line (that has just been read)
   int lineNum;
 
-  // Helper function to find next non-commented line
-  std::string csv_getline();
+  void load();
+
+  //! State of a table cell
+  enum cell_state { CELL_BLANK, CELL_VALUE, CELL_BAD };
+
+  //! Whether the table below has been read from the file
+  bool loaded;
+
+  //! Column names from the header row; column 0 is the index
+  std::vector<std::string> header;
+
+  //! Index (date) of each data row
+  std::vector<double> index;
+
+  //! Values and cell states, by column and then data row
+  std::vector<std::vector<double>> values;
+  std::vector<std::vector<char>> states;
+
+  //! Text of cells that aren't numbers, by (column, data row), for errors
+  std::map<std::pair<size_t, size_t>, std::string> bad_cells;
+
+  //! UNITS rows: the data row each applies from, and its column labels
+  std::vector<std::pair<size_t, std::vector<std::string>>> units_rows;
 };
 
 } // namespace Hector
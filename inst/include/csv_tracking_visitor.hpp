@@ -14,23 +14,76 @@
  *
  */
 
+#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "async_writer.hpp"
 #include "avisitor.hpp"
 #include "fluxpool.hpp"
-#include "tseries.hpp"
 
 #define DELIMITER ","
 
 namespace Hector {
+
+/*! \brief One row of tracking output: the fraction of a pool from a source
+ */
+struct tracking_record {
+  double year;
+  //! Index of the pool, see CSVFluxPoolVisitor::getPool()
+  unsigned pool;
+  //! Index of the source, see CSVFluxPoolVisitor::getSource()
+  unsigned source;
+  //! Pool value (Pg C)
+  double value;
+  double fraction;
+};
+
+/*! \brief A tracked pool: the component it's in, its name and units
+ */
+struct tracking_pool {
+  std::string component;
+  std::string name;
+  std::string units;
+};
+
+/*! \brief Tracking data as columns, one row per record
+ *
+ *  Pools and sources are given as indices into the pools and sources
+ *  tables, rather than repeating their names in every row.
+ */
+struct tracking_columns {
+  std::vector<double> year;
+  std::vector<unsigned> pool;
+  std::vector<double> pool_value;
+  std::vector<unsigned> source;
+  std::vector<double> source_fraction;
+
+  std::vector<tracking_pool> pools;
+  std::vector<std::string> sources;
+};
+
 /*! \brief A visitor which will the contents of each tracked pool at each model
  * period.
+ *
+ *  Rows are held as typed records, with pool and source names stored once
+ *  each, and only formatted as CSV when written.  Normally they are held
+ *  until the visitor is destroyed (or outputTrackingData() is called), so a
+ *  reset can drop them; when streaming, each year is written out as soon as
+ *  it's complete, optionally on a background thread.
  */
 class CSVFluxPoolVisitor : public AVisitor {
 public:
-  CSVFluxPoolVisitor(std::ostream &outputStream, const bool printHeader = true);
+  CSVFluxPoolVisitor(std::ostream &outputStream, const bool printHeader = true,
+                     const bool streaming = false,
+                     const bool background = false);
   ~CSVFluxPoolVisitor();
 
+  void flush();
+
   virtual bool shouldVisit(const bool in_spinup, const double date);
   virtual void visit(Core *c);
   virtual void visit(SimpleNbox *c);
@@ -38,32 +91,60 @@ public:
 
   void reset(const double reset_date);
   virtual void outputTrackingData(std::ostream &tracking_out) const;
+  virtual void outputTrackingColumns(tracking_columns &columns) const;
+
+  //! Records held (not yet streamed), in date order
+  const std::vector<tracking_record> &getRecords() const { return records; }
+  const tracking_pool &getPool(const unsigned i) const { return pools.at(i); }
+  const std::string &getSource(const unsigned i) const {
+    return sources.at(i);
+  }
 
 private:
   //! The file output stream in which the csv output will be written to.
   std::ostream &csvFile;
 
-  //! The buffer—holds output until ready to be returned to the core or written
-  //! to the csv file
-  tseries<string> csvBuffer;
-  string header;
+  //! Records not yet written to csvFile, in date order
+  std::vector<tracking_record> records;
+  std::string header;
+
+  //! Formatted records being handed to csvFile, or to the background writer
+  std::string buffer;
+
+  //! Writes streamed years on a background thread, if asked for
+  std::unique_ptr<AsyncWriter> writer;
+
+  //! Write each year to csvFile once it's complete?
+  const bool streaming;
+
+  //! Has anything been written to csvFile (so the header has)?
+  bool written;
+
+  //! Latest year written to csvFile
+  double written_date;
+
+  //! Pools and sources seen so far, and their indices
+  std::vector<tracking_pool> pools;
+  std::map<std::pair<std::string, std::string>, unsigned> pool_index;
+  std::vector<std::string> sources;
+  std::unordered_map<std::string, unsigned> source_index;
 
   // Data retained while the visitor is operating
   double current_date;
   double tracking_date;
 
-  //! Current model date, stored as a string for output
-  string datestring;
+  //! Name of current run
+  std::string run_name;
 
-  //! Current model mode, stored as a string for output
-  string spinupstring;
+  //! Helper function: record the sources, and their fractions, of a fluxpool
+  virtual void print_pool(const fluxpool &x, const std::string &cname);
 
-  //! Name of current run
-  string run_name;
+  //! Helper function: format records as csv
+  void format_records(std::string &out, const tracking_record *begin,
+                      const tracking_record *end) const;
 
-  //! Helper function: print one or more lines of tracking data for a given
-  //! fluxpool
-  virtual void print_pool(const fluxpool, const string);
+  //! Helper function: write out and drop the held records
+  void write_records();
 
   //! Pointers to other components and stuff
   Core *core;
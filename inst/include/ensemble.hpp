@@ -0,0 +1,84 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+/*
+ *  ensemble.hpp
+ *  hector
+ *
+ *  Runs a parameter ensemble on several threads.
+ *
+ */
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "scenario_bundle.hpp"
+#include "unitval.hpp"
+
+namespace Hector {
+
+/*! \brief Runs a parameter ensemble on several threads.
+ *
+ *  Every member is a core of its own, set up from one shared, already parsed
+ *  set of inputs (a ScenarioBundle replayed into it), then given the
+ *  member's parameter values, run, and asked for the output variables.
+ *  Members are handed out to worker threads one at a time, so a slow member
+ *  doesn't hold up the others.  Member cores don't log.
+ *
+ *  Results are stored member by member, then variable by variable, then
+ *  date by date, i.e. as an array with dimensions (dates, variables,
+ *  members) in column-major order.  A member that fails has its results
+ *  set to NaN and its error message recorded; the other members still run.
+ */
+class Ensemble {
+public:
+  Ensemble(const ScenarioBundle &inputs,
+           const std::vector<std::string> &parameters,
+           const std::vector<unit_types> &parameterUnits,
+           const std::vector<std::string> &vars,
+           const std::vector<double> &dates);
+
+  void run(const std::vector<double> &values, const size_t members,
+           unsigned threads = 0);
+
+  const std::vector<double> &getResults() const { return results; }
+  const std::vector<unit_types> &getUnits() const { return units; }
+  const std::vector<std::string> &getErrors() const { return errors; }
+
+private:
+  void runMember(const std::vector<double> &values, const size_t member);
+
+  //! The inputs every member starts from
+  const ScenarioBundle &inputs;
+
+  //! Parameters set for each member, and their units
+  std::vector<std::string> parameters;
+  std::vector<unit_types> parameterUnits;
+
+  //! Variables and dates fetched from each member
+  std::vector<std::string> vars;
+  std::vector<double> dates;
+
+  //! Number of members in the last run
+  size_t members;
+
+  //! Results of the last run: values, the units of each variable, and each
+  //! member's error message (empty if it succeeded)
+  std::vector<double> results;
+  std::vector<unit_types> units;
+  std::vector<std::string> errors;
+
+  //! Guards units, which the first member to succeed fills in
+  std::mutex units_mutex;
+  bool have_units;
+};
+
+} // namespace Hector
+
+#endif // ENSEMBLE_H
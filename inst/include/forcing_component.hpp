@@ -45,6 +45,8 @@ public:
                               const message_data info = message_data());
 
   virtual void setData(const std::string &varName, const message_data &data);
+  virtual void setSeries(const std::string &varName,
+                         const tseries<unitval> &series);
 
   virtual void prepareToRun();
 
@@ -57,9 +59,67 @@ public:
   //! IVisitable methods
   virtual void accept(AVisitor *visitor);
 
-  //! A list (map) of all computed forcings, with associated iterator
-  typedef std::map<std::string, unitval> forcings_t;
-  typedef std::map<std::string, unitval>::iterator forcingsIterator;
+  //! Slots of the forcing table. These are in the (alphabetical) order of
+  //! their names, which is the order they are written out and summed.
+  enum forcing_slot {
+    F_CH4,
+    F_BC,
+    F_C2F6,
+    F_CCl4,
+    F_CF4,
+    F_CFC11,
+    F_CFC113,
+    F_CFC114,
+    F_CFC115,
+    F_CFC12,
+    F_CH3Br,
+    F_CH3CCl3,
+    F_CH3Cl,
+    F_CO2,
+    F_H2O_STRAT,
+    F_HCFC141b,
+    F_HCFC142b,
+    F_HCFC22,
+    F_HFC125,
+    F_HFC134a,
+    F_HFC143a,
+    F_HFC227ea,
+    F_HFC23,
+    F_HFC245fa,
+    F_HFC32,
+    F_HFC4310,
+    F_N2O,
+    F_NH3,
+    F_O3_TROP,
+    F_OC,
+    F_SF6,
+    F_SO2,
+    F_ACI,
+    F_T_ALBEDO,
+    F_halon1211,
+    F_halon1301,
+    F_halon2402,
+    F_MISC,
+    F_TOTAL,
+    F_VOL,
+    N_FORCINGS
+  };
+
+  //! One year's forcings (W/m2), indexed by forcing_slot. Forcings whose
+  //! agents are disabled are absent.
+  struct forcings_t {
+    double value[N_FORCINGS] = {};
+    bool present[N_FORCINGS] = {};
+
+    void set(const forcing_slot slot, const double f) {
+      value[slot] = f;
+      present[slot] = true;
+    }
+  };
+
+  static const char *forcing_names[N_FORCINGS]; //! Capability strings by slot
+
+  static int find_slot(const std::string &varName);
 
 private:
   virtual unitval getData(const std::string &varName, const double valueIndex);
@@ -132,9 +192,7 @@ private:
 
   static const char
       *adjusted_halo_forcings[]; //! Capability strings for halocarbon forcings
-  static const char
-      *halo_forcing_names[]; //! Internal names of halocarbon forcings
-  static std::map<std::string, std::string> forcing_name_map;
+  static const forcing_slot halo_slots[]; //! Slots of halocarbon forcings
 };
 
 } // namespace Hector
@@ -0,0 +1,70 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef GZIP_FILEBUF_H
+#define GZIP_FILEBUF_H
+/*
+ *  gzip_filebuf.hpp
+ *  hector
+ *
+ *  A stream buffer writing a gzip-compressed file.
+ *
+ */
+
+#include <fstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+//! Bytes of output compressed together as one block
+#define GZIP_BLOCK_SIZE (1 << 18)
+
+namespace Hector {
+
+/*! \brief A stream buffer writing a gzip-compressed file.
+ *
+ *  Use it in place of a std::filebuf for output.  Output is compressed a
+ *  block at a time, and each block is flushed through to the file (a zlib
+ *  sync flush), so a file still being written can be read up to its last
+ *  whole block.  sync() (i.e. flushing the stream) flushes the same way;
+ *  close(), or destruction, finishes the file.
+ */
+class gzip_filebuf : public std::streambuf {
+public:
+  gzip_filebuf();
+  ~gzip_filebuf();
+
+  gzip_filebuf *open(const std::string &fileName);
+  bool is_open() const;
+  gzip_filebuf *close();
+
+protected:
+  virtual int_type overflow(int_type c);
+  virtual int sync();
+
+private:
+  bool compress(const int flush);
+
+  //! The compressed file
+  std::filebuf file;
+
+  //! Compressor state, valid while the file is open
+  z_stream zs;
+
+  //! Uncompressed output not yet compressed (the put area), and room for
+  //! compressed output
+  std::vector<char> in;
+  std::vector<char> out;
+
+  gzip_filebuf(const gzip_filebuf &);
+  gzip_filebuf &operator=(const gzip_filebuf &);
+};
+
+} // namespace Hector
+
+#endif // GZIP_FILEBUF_H
@@ -0,0 +1,52 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef H_FFT_H
+#define H_FFT_H
+/*
+ *  h_fft.hpp
+ *  hector
+ *
+ *  Radix-2 fast Fourier transform, used for batch convolutions.
+ *
+ */
+
+#include <complex>
+#include <vector>
+
+namespace Hector {
+
+//-----------------------------------------------------------------------
+/*! \brief Fast Fourier transform of a fixed power-of-two length.
+ *
+ *  Twiddle factors and the bit-reversal permutation are computed once by
+ *  the constructor, so one h_fft can transform many series of the same
+ *  length cheaply. The inverse transform includes the 1/n scaling, so
+ *  inverse(forward(x)) == x.
+ */
+class h_fft {
+public:
+  explicit h_fft(const size_t n);
+
+  void forward(std::vector<std::complex<double>> &a) const;
+  void inverse(std::vector<std::complex<double>> &a) const;
+
+  size_t size() const { return n; };
+
+  static size_t length_for(const size_t n);
+
+private:
+  void transform(std::vector<std::complex<double>> &a,
+                 const bool invert) const;
+
+  size_t n;
+  std::vector<size_t> bitrev;                //!< bit-reversed index
+  std::vector<std::complex<double>> twiddle; //!< exp(-2*pi*i*k/n), k < n/2
+};
+
+} // namespace Hector
+
+#endif // H_FFT_H
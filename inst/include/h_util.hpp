@@ -17,6 +17,9 @@
  */
 
 #include <iostream>
+#include <string>
+
+#include <stdint.h>
 
 #define H_STRINGIFY_VAR(var) #var
 
@@ -34,6 +37,40 @@ namespace Hector {
 
 void ensure_dir_exists(const std::string &dir);
 
+void append_number(std::string &s, const double x, const int precision);
+
+/*! \brief Read-only view of a whole file.
+ *
+ *  The file is memory-mapped where the platform allows, so it can be read in
+ *  place without copying it; otherwise it is read into a buffer.
+ */
+class mapped_file {
+public:
+  mapped_file(const std::string &fileName);
+  ~mapped_file();
+
+  const char *begin() const { return data; }
+  const char *end() const { return data + length; }
+  size_t size() const { return length; }
+
+private:
+  const char *data;
+  size_t length;
+  void *map;
+  std::string buffer;
+
+  mapped_file(const mapped_file &);
+  mapped_file &operator=(const mapped_file &);
+};
+
+/*! \brief Write a value's bytes to a binary file, in native byte order
+ */
+template <class T> void put_binary(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
 }
 
+void put_binary_string(std::ostream &out, const std::string &s);
+
+} // namespace Hector
+
 #endif // H_UTIL_H
@@ -31,10 +31,16 @@
 /* Core functions */
 #include "core.hpp"
 
+/* Ensembles */
+#include "ensemble.hpp"
+
 /* Setup functions */
 #include "ini_to_core_reader.hpp"
+#include "scenario_bundle.hpp"
 
 /* Output functions */
+#include "binary_output_visitor.hpp"
 #include "csv_outputstream_visitor.hpp"
+#include "csv_tracking_visitor.hpp"
 
 #endif
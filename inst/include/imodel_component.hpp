@@ -14,11 +14,14 @@
  *
  */
 
+#include <vector>
+
 #include "component_data.hpp"
 #include "component_names.hpp"
 #include "h_exception.hpp"
 #include "ivisitable.hpp"
 #include "message_data.hpp"
+#include "tseries.hpp"
 #include "unitval.hpp"
 
 namespace Hector {
@@ -83,6 +86,20 @@ public:
   virtual void setData(const std::string &varName,
                        const message_data &data) = 0;
 
+  //------------------------------------------------------------------------------
+  /*! \brief Sets a whole time series variable at once.
+   *
+   *  By default each value is passed to setData in turn; components that
+   *  take large input series override this to store them in one go, sharing
+   *  the series' data where they can (see set_series).
+   *
+   *  \param varName The name of the time series variable to set.
+   *  \param series The values to set (units U_UNDEFINED to take the expected
+   *                ones).
+   */
+  inline virtual void setSeries(const std::string &varName,
+                                const tseries<unitval> &series);
+
   //------------------------------------------------------------------------------
   /*! \brief A notification that all data are set and the component should
    * prepare to run.
@@ -174,6 +191,14 @@ private:
 // Inline methods
 IModelComponent::~IModelComponent() {}
 
+void IModelComponent::setSeries(const std::string &varName,
+                                const tseries<unitval> &series) {
+  for (tseries<unitval>::const_iterator it = series.begin();
+       it != series.end(); ++it) {
+    setData(varName, message_data(it->first, it->second));
+  }
+}
+
 } // namespace Hector
 
 #endif // IMODEL_COMPONENT_H
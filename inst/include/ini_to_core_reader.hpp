@@ -14,11 +14,15 @@
  *
  */
 
+#include <map>
+#include <memory>
+
 #include "h_exception.hpp"
 
 namespace Hector {
 
 class Core;
+class CSVTableReader;
 
 /*! \brief An adaptor class to send data read from an INI file directly to the
  *         core for routing to the proper model subcomponent.
@@ -50,6 +54,10 @@ private:
   //! an error code.
   h_exception valueHandlerException;
 
+  //! CSV tables read during this parse, by resolved path, so that each
+  //! file is read once however many variables are taken from it.
+  std::map<std::string, std::unique_ptr<CSVTableReader>> tables;
+
   static int valueHandler(void *user, const char *section, const char *name,
                           const char *value);
 
@@ -27,6 +27,7 @@ namespace Hector {
  *  This doesn't do much yet.
  */
 class N2OComponent : public IModelComponent {
+  friend class AtmosChemistry;
 
 public:
   N2OComponent();
@@ -42,6 +43,8 @@ public:
                               const message_data info = message_data());
 
   virtual void setData(const std::string &varName, const message_data &data);
+  virtual void setSeries(const std::string &varName,
+                         const tseries<unitval> &series);
 
   virtual void prepareToRun();
 
@@ -56,6 +59,7 @@ public:
 
 private:
   virtual unitval getData(const std::string &varName, const double date);
+  void advance(const double runToDate);
 
   unitval N0;     //! preindustrial N2O, ppbv N2O
   unitval UC_N2O; //! conversion from emissions to concentration
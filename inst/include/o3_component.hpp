@@ -26,6 +26,7 @@ namespace Hector {
  *  This doesn't do much yet.
  */
 class OzoneComponent : public IModelComponent {
+  friend class AtmosChemistry;
 
 public:
   OzoneComponent();
@@ -41,6 +42,8 @@ public:
                               const message_data info = message_data());
 
   virtual void setData(const std::string &varName, const message_data &data);
+  virtual void setSeries(const std::string &varName,
+                         const tseries<unitval> &series);
 
   virtual void prepareToRun();
 
@@ -55,6 +58,7 @@ public:
 
 private:
   virtual unitval getData(const std::string &varName, const double date);
+  void advance(const double runToDate, const unitval current_ch4);
 
   //! Current ozone concentration, relative to preindustrial, Dobson units
   unitval PO3;
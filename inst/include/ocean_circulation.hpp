@@ -0,0 +1,70 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef OCEAN_CIRCULATION_HPP_
+#define OCEAN_CIRCULATION_HPP_
+
+/* ocean_circulation.hpp
+ *
+ * Header file for the ocean circulation (box-to-box transport) operator.
+ *
+ */
+
+#include <vector>
+
+#include "logger.hpp"
+#include "oceanbox.hpp"
+#include "unitval.hpp"
+
+namespace Hector {
+
+class OceanCirculation {
+  /*! \brief Sparse box-to-box carbon transport operator
+   *
+   *  Holds the ocean circulation as a transport matrix in compressed sparse
+   *  row form: row i lists the boxes that box i sends carbon to, and the
+   *  fraction of its carbon (per year) that goes to each. The matrix is
+   *  assembled once from (from, to, k) entries and then applied to the boxes
+   *  with a single pass over its nonzeros per timestep.
+   */
+public:
+  OceanCirculation();
+
+  void clear();
+  void add_transport(const size_t from, const size_t to, const double k);
+  void build(const size_t nboxes);
+
+  void apply(const std::vector<oceanbox *> &boxes, const double yf);
+  void new_year();
+
+  unitval annual_flux(const size_t from, const size_t to) const;
+  std::vector<double> get_annual_fluxes() const { return annual; };
+  void set_annual_fluxes(const std::vector<double> &af);
+
+  size_t size() const { return row_start.empty() ? 0 : row_start.size() - 1; };
+  size_t nonzeros() const { return dest.size(); };
+
+  void log_state(Logger &logger,
+                 const std::vector<oceanbox *> &boxes) const;
+
+private:
+  //! Transport entries added since the last build
+  struct transport {
+    size_t from, to;
+    double k;
+  };
+  std::vector<transport> pending;
+
+  // Compressed sparse row storage
+  std::vector<size_t> row_start; //!< index of each row's first entry
+  std::vector<size_t> dest;      //!< destination box of each entry
+  std::vector<double> k;         //!< transport rate of each entry (1/yr)
+  std::vector<double> annual;    //!< flux of each entry this year (Pg C/yr)
+};
+
+} // namespace Hector
+
+#endif
@@ -14,8 +14,13 @@
  *
  */
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "carbon-cycle-model.hpp"
 #include "logger.hpp"
+#include "ocean_circulation.hpp"
 #include "ocean_csys.hpp"
 #include "oceanbox.hpp"
 #include "tseries.hpp"
@@ -29,6 +34,7 @@
 #define OCEAN_TSR_TRIGGER1                                                     \
   0.1 //!< trigger1 to reduce timestep:
       //!< absolute diff between successive annual fluxes (Pg C)
+#define OCEAN_PARSECHAR "." //!< input separator between <box> and <variable>
 
 namespace Hector {
 
@@ -100,6 +106,17 @@ private:
   oceanbox inter;     //!< intermediate box 1000m
   oceanbox deep;      //!< deep box 3000m
 
+  // Generalized N-box interior. If any interior boxes are given in the
+  // input, they replace the intermediate and deep boxes above.
+  std::vector<oceanbox> interior; //!< N-box interior boxes
+
+  // Circulation. The boxes vector points to the HL and LL surface boxes
+  // followed by the interior boxes, in transport matrix order.
+  std::vector<oceanbox *> boxes;  //!< all active boxes
+  std::vector<bool> box_is_deep;  //!< does the box count as deep ocean?
+  std::vector<double> box_deep_share; //!< share of the deep ocean volume
+  OceanCirculation circulation;   //!< box-to-box transport operator
+
   // Atmosphere conditions
   unitval SST;      //!< Ocean surface temperature anomaly, degC
   unitval CO2_conc; //!< Atmospheric CO2, ppm
@@ -124,6 +141,17 @@ private:
   unitval twi; //!< m3/s warm-intermediate exchange
   unitval tid; //!< m3/s intermediate-deep exchange
 
+  // N-box ocean configuration; empty unless given in the input
+  std::vector<std::string> nbox_names; //!< interior box names, input order
+  std::map<std::string, double>
+      nbox_volume_frac; //!< fraction of intermediate+deep ocean volume
+  std::map<std::string, bool> nbox_deep; //!< counts as deep ocean?
+  struct nbox_transport {
+    std::string from, to;
+    unitval transport; //!< m3/s
+  };
+  std::vector<nbox_transport> nbox_transports; //!< box-to-box transports
+
   /*****************************************************************
    * Input data
    *****************************************************************/
@@ -133,6 +161,13 @@ private:
    * Private helper functions
    *****************************************************************/
   fluxpool totalcpool() const;
+  unitval interior_carbon(const bool in_deep) const;
+  bool nbox_mode() const { return !nbox_names.empty(); };
+  void collect_boxes();
+  void setup_nbox(const double HL_volume, const double LL_volume,
+                  const double ID_volume, const double spy);
+  void setNboxData(const std::vector<std::string> &splitvec,
+                   const message_data &data);
   unitval annual_totalcflux(const double date, const unitval &CO2_conc,
                             const double cpoolscale = 1.0) const;
 
@@ -156,11 +191,11 @@ private:
   unitval
       preind_C_ID; //!< Carbon in the preindustrial intermediate and deep pool
 
-  // Ocean boxes over time
-  tvector<oceanbox> surfaceHL_tv;
-  tvector<oceanbox> surfaceLL_tv;
-  tvector<oceanbox> inter_tv;
-  tvector<oceanbox> deep_tv;
+  // Ocean boxes over time: dynamic state of each box (in boxes order), the
+  // source maps of box carbon (only while tracking), and circulation fluxes
+  tvector<std::vector<oceanbox_state>> box_state_tv;
+  tvector<std::vector<fluxpool>> tracked_carbon_tv;
+  tvector<std::vector<double>> circulation_flux_tv;
 
   // Ocean conditions over time
   tseries<unitval> SST_ts;
@@ -36,6 +36,25 @@
 
 namespace Hector {
 
+/*! \brief Dynamic state of an oceanbox, for recording and restoring
+ *
+ *  Plain data only: a box's configuration (name, chemistry parameters) is
+ *  fixed once the ocean is set up, so only what changes from year to year is
+ *  kept here. The source map of tracked carbon is not; the owner records it
+ *  separately, and only while tracking is on.
+ */
+struct oceanbox_state {
+  double carbon;           ///< box carbon, Pg C
+  bool tracking;           ///< is box carbon being tracked?
+  bool active_chemistry;   ///< box has active chemistry model?
+  unitval Tbox;            ///< box absolute temperature, degC
+  unitval CO2_conc;        ///< atmospheric [CO2], ppm
+  unitval dic_lastyear;    ///< DIC at start of year, for Revelle calculation
+  unitval atmosphere_flux; ///< atmosphere -> ocean flux
+  double alk;              ///< chemistry alkalinity
+  unitval TCO2o, HCO3, CO3, PCO2o, pH, OmegaCa, OmegaAr; ///< chemistry outputs
+};
+
 class oceanbox {
   /*! /brief  An ocean box
    *
@@ -43,13 +62,22 @@ class oceanbox {
    *  other boxes, may (or not) exchange carbon and heat with the atmosphere,
    *  and may (or not) have active chemistry.
    */
+public:
+  /*! \brief Result of the last chem_equilibrate call, and the inputs it was
+   *  computed from; lets reset/rerun cycles skip the calibration. Box
+   *  restores (set_state) leave it alone.
+   */
+  struct equilibrium_cache {
+    double alk;      ///< equilibrated alkalinity (0 = none yet)
+    double f_target; ///< target flux, Pg C/yr
+    double Ca;       ///< atmospheric [CO2], ppmv
+    double C;        ///< box carbon, Pg C
+    double T;        ///< box temperature, degC
+  };
+
 private:
   fluxpool carbon;
   fluxpool CarbonAdditions, CarbonSubtractions;
-  std::vector<oceanbox *> connection_list; ///< a vector of ocean box pointers
-  std::vector<double> connection_k; ///< a vector of ocean k values (fraction)
-  std::vector<int>
-      connection_window; ///< a vector of connection windows to average over
 
   std::string Name;
 
@@ -61,16 +89,14 @@ private:
   fluxpool ao_flux; //!< atmosphere -> ocean flux
   fluxpool oa_flux; //!< ocean -> atmosphere flux
 
+  equilibrium_cache equil_cache;
+
 public:
   oceanbox(); // constructor
 
-  std::map<oceanbox *, unitval>
-      annual_box_fluxes; ///< Map of our fluxes to other boxes
-
   void initbox(double C, std::string name = "");
-  void make_connection(oceanbox *ob, const double k, const int window);
   void compute_fluxes(const unitval current_Ca, const fluxpool atmosphere_cpool,
-                      const double yf, const bool do_circ = true);
+                      const double yf);
   void log_state();
   void update_state();
   void new_year(const unitval SST);
@@ -82,6 +108,12 @@ public:
   fluxpool get_ao_flux() const { return ao_flux; };
 
   void add_carbon(fluxpool C);
+  void remove_carbon(fluxpool C);
+  void restore_carbon(const fluxpool &C) { carbon = C; };
+
+  oceanbox_state get_state() const;
+  void set_state(const oceanbox_state &st);
+  std::string get_name() const { return Name; };
 
   void start_tracking();
 
@@ -97,7 +129,7 @@ public:
   bool active_chemistry; ///< box has active chemistry model?
   void chem_equilibrate(const unitval current_Ca); ///< equilibrate chemistry
                                                    ///< model to a given flux
-  double fmin(double alk, void *params);
+  double fdiff(double alk, double f_target);
 
   unitval atmosphere_flux; //!< positive is atmosphere -> ocean flux, negative
                            //!< ocean -> atmosphere
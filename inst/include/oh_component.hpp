@@ -28,6 +28,7 @@ namespace Hector {
  *  This doesn't do much yet.
  */
 class OHComponent : public IModelComponent {
+  friend class AtmosChemistry;
 
 public:
   OHComponent();
@@ -43,6 +44,8 @@ public:
                               const message_data info = message_data());
 
   virtual void setData(const std::string &varName, const message_data &data);
+  virtual void setSeries(const std::string &varName,
+                         const tseries<unitval> &series);
 
   virtual void prepareToRun();
 
@@ -57,6 +60,8 @@ public:
 
 private:
   virtual unitval getData(const std::string &varName, const double date);
+  void advance(const double runToDate, const double previous_ch4);
+
   //! emissions time series
   tseries<unitval> CO_emissions;
   tseries<unitval> NOX_emissions;
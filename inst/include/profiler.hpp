@@ -0,0 +1,112 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef PROFILER_H
+#define PROFILER_H
+/*
+ *  profiler.hpp
+ *  hector
+ *
+ *  Wall time and call counts of the parts of a model run.
+ *
+ */
+
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+// What is being timed: a component step, a visitor pass, a carbon cycle
+// model call, or a message routed through the core
+#define PROFILE_RUN "run"
+#define PROFILE_RUN_SPINUP "run_spinup"
+#define PROFILE_RESET "reset"
+#define PROFILE_VISIT "visit"
+#define PROFILE_CALCDERIVS "calcderivs"
+#define PROFILE_SLOWPARAMEVAL "slowparameval"
+#define PROFILE_MESSAGE "sendMessage"
+
+namespace Hector {
+
+//! Calls to, and total wall time in, one part of the model
+struct profile_entry {
+  profile_entry() : calls(0), seconds(0.0) {}
+  unsigned long calls;
+  double seconds;
+};
+
+/*! \brief Wall time and call counts of the parts of a model run.
+ *
+ *  Each entry is keyed by a name (a component, visitor, or for messages the
+ *  capability asked for) and what was timed (PROFILE_RUN etc.).  Nothing is
+ *  timed or counted unless the profiler is enabled; while it is disabled,
+ *  profiling costs one test of a flag per timed call.
+ *
+ *  Entries are never removed (clear() zeroes them), so a reference to one
+ *  stays valid for the life of the profiler and may be kept to time
+ *  frequent calls without looking the entry up each time.  Times of nested
+ *  calls (e.g. a message sent while a component runs) are counted in both.
+ */
+class Profiler {
+public:
+  typedef std::map<std::pair<std::string, std::string>, profile_entry>
+      entry_map;
+
+  Profiler() : enabled(false) {}
+
+  void enable(bool on) { enabled = on; }
+  bool isEnabled() const { return enabled; }
+
+  profile_entry &entry(const std::string &name, const std::string &kind) {
+    return entries[std::make_pair(name, kind)];
+  }
+  const entry_map &getEntries() const { return entries; }
+
+  void clear();
+  void write(std::ostream &out) const;
+
+private:
+  bool enabled;
+  entry_map entries;
+};
+
+/*! \brief Times one call, adding it to a profile entry when it goes out of
+ *         scope.
+ *
+ *  Given no entry (i.e. the profiler is disabled), it does nothing.
+ */
+class profile_timer {
+public:
+  explicit profile_timer(profile_entry *e) : e(e) {
+    if (e)
+      start = clock::now();
+  }
+  profile_timer(Profiler &profiler, const std::string &name, const char *kind)
+      : e(profiler.isEnabled() ? &profiler.entry(name, kind) : NULL) {
+    if (e)
+      start = clock::now();
+  }
+  ~profile_timer() {
+    if (e) {
+      ++e->calls;
+      e->seconds +=
+          std::chrono::duration<double>(clock::now() - start).count();
+    }
+  }
+
+private:
+  typedef std::chrono::steady_clock clock;
+  profile_entry *e;
+  clock::time_point start;
+
+  profile_timer(const profile_timer &);
+  profile_timer &operator=(const profile_timer &);
+};
+
+} // namespace Hector
+
+#endif // PROFILER_H
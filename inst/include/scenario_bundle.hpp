@@ -0,0 +1,94 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef SCENARIO_BUNDLE_H
+#define SCENARIO_BUNDLE_H
+/*
+ *  scenario_bundle.hpp
+ *  hector
+ *
+ *  Compiled (binary) scenario inputs.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include "message_data.hpp"
+#include "tseries.hpp"
+#include "unitval.hpp"
+
+namespace Hector {
+
+class Core;
+
+/*! \brief A scenario's inputs, compiled to a binary file.
+ *
+ *  Compiling runs the usual INI reader (and with it the CSV tables) against
+ *  a core that records every setData and setSeries it is given, in order,
+ *  converting values to numbers where it can.  The recording is written as
+ *  a versioned binary bundle.  Loading a bundle maps the file and replays
+ *  the recording into a core, so it sets up exactly as the INI file would,
+ *  with no text to parse.
+ *
+ *  Bundle layout (native byte order): the magic "HSB\0", a 32-bit version
+ *  and entry count, then the entries.  Each entry has a kind byte, the
+ *  component and variable names (32-bit length and bytes), and then
+ *      - VALUE:  date, units (32-bit) and value
+ *      - TEXT:   date, then the value and units strings
+ *      - SERIES: units, a 64-bit count, then the dates and the values
+ *  where dates and values are doubles.
+ *
+ *  A recording can also be kept in memory (record) and replayed into any
+ *  number of cores (apply); replaying only reads the bundle, so cores on
+ *  different threads may share one.  The recorded series are immutable
+ *  inputs shared by every core they are replayed into: components keep a
+ *  reference to a series rather than a copy (see tseries::share), and only
+ *  a core that changes one of its series copies it.
+ */
+class ScenarioBundle {
+public:
+  void recordData(const std::string &componentName, const std::string &varName,
+                  const message_data &data);
+  void recordSeries(const std::string &componentName,
+                    const std::string &varName,
+                    const tseries<unitval> &series);
+
+  void write(const std::string &fileName) const;
+
+  void record(Core *core, const std::string &iniFile);
+  void apply(Core *core) const;
+
+  static void compile(Core *core, const std::string &iniFile,
+                      const std::string &bundleFile);
+  static bool isBundle(const std::string &fileName);
+  static void load(Core *core, const std::string &fileName);
+
+private:
+  //! Kinds of entry
+  enum entry_kind { E_VALUE, E_TEXT, E_SERIES };
+
+  //! One recorded setData or setSeries call
+  struct entry {
+    char kind;
+    std::string component;
+    std::string var;
+    double date;
+    unit_types units;
+    double value;
+    std::string text;
+    std::string units_text;
+    tseries<unitval> series;
+  };
+
+  void resolve_units(Core *core, entry &e);
+
+  std::vector<entry> entries;
+};
+
+} // namespace Hector
+
+#endif // SCENARIO_BUNDLE_H
@@ -19,6 +19,7 @@
 #include "temperature_component.hpp"
 #include "tseries.hpp"
 #include "unitval.hpp"
+#include "window_mean.hpp"
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Weverything"
@@ -68,6 +69,8 @@ public:
                               const message_data info = message_data());
 
   virtual void setData(const std::string &varName, const message_data &data);
+  virtual void setSeries(const std::string &varName,
+                         const tseries<unitval> &series);
 
   virtual void prepareToRun();
 
@@ -193,8 +196,8 @@ private:
    *****************************************************************/
 
   double_stringmap co2fert;     //!< CO2 fertilization effect (unitless)
-  tseries<double> Tland_record; //!< Record of mean land surface/air temperature
-                                //!< values, for computing soil RH
+  window_mean Tland_record; //!< Record of mean land surface/air temperature
+                            //!< values, for computing soil RH
   bool in_spinup;               //!< flag tracking spinup state
   double tcurrent;              //!< Current time (last completed time step)
   double masstot;               //!< tracker for mass conservation
@@ -208,13 +211,14 @@ private:
    * an input file or pushed in by another model.
    *****************************************************************/
 
-  // Carbon fluxes
-  tseries<fluxpool>
+  // Carbon fluxes; checked as fluxpools when set, but stored as unitvals so
+  // they can share input series (see setSeries)
+  tseries<unitval>
       ffiEmissions; //!< fossil fuels and industry emissions, Pg C/yr
-  tseries<fluxpool>
+  tseries<unitval>
       daccsUptake; //!< direct air carbon capture and storage, Pg C/yr
-  tseries<fluxpool> lucEmissions; //!< land use change emissions, Pg C/yr
-  tseries<fluxpool> lucUptake;    //!< land use change uptake, Pg C/yr
+  tseries<unitval> lucEmissions; //!< land use change emissions, Pg C/yr
+  tseries<unitval> lucUptake;    //!< land use change uptake, Pg C/yr
 
   // Albedo
   tseries<unitval> Falbedo; //!< terrestrial albedo forcing, W/m2
@@ -300,16 +304,17 @@ private:
   /*****************************************************************
    * Private helper functions
    *****************************************************************/
-  fluxpool sum_map(fluxpool_stringmap pool)
+  fluxpool sum_map(const fluxpool_stringmap &pool)
       const; //!< sums a unitval map (collection of data)
-  double sum_map(
-      double_stringmap pool) const; //!< sums a double map (collection of data)
+  double sum_map(const double_stringmap &pool)
+      const; //!< sums a double map (collection of data)
   void log_pools(const double t,
                  const string msg); //!< prints pool status to the log file
   void set_c0(double newc0); //!< set initial co2 and adjust total carbon mass
-  fluxpool sum_fluxpool_biome_ts(const string varName, const double date,
-                                 const string biome, fluxpool_stringmap pool,
-                                 tvector<fluxpool_stringmap> pool_tv);
+  fluxpool sum_fluxpool_biome_ts(const string &varName, const double date,
+                                 const string &biome,
+                                 const fluxpool_stringmap &pool,
+                                 const tvector<fluxpool_stringmap> &pool_tv);
   bool has_biome(const std::string &biome);
   double f_frozen_weighted_mean(const string biome, const double date);
 
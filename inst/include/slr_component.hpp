@@ -77,6 +77,7 @@ private:
   Core *core;
 
   void compute_slr(const double date);
+  double tgav_deriv(const double date) const;
 
   //! logger
   Logger logger;
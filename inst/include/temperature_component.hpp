@@ -56,6 +56,8 @@ public:
                               const message_data info = message_data());
 
   virtual void setData(const std::string &varName, const message_data &data);
+  virtual void setSeries(const std::string &varName,
+                         const tseries<unitval> &series);
 
   virtual void prepareToRun();
 
@@ -68,14 +70,37 @@ public:
   //! IVisitable methods
   virtual void accept(AVisitor *visitor);
 
+  //! Temperature response to one forcing trajectory (see run_batch)
+  struct batch_result {
+    std::vector<double> tas;      //!< global mean air temperature, deg C
+    std::vector<double> tas_land; //!< air temperature over land, deg C
+    std::vector<double> sst;      //!< sea surface temperature, deg C
+    std::vector<double> heatflux; //!< heat flux into the ocean, W/m2
+  };
+
+  std::vector<batch_result>
+  run_batch(const std::vector<std::vector<double>> &forcings);
+
 private:
   virtual unitval getData(const std::string &varName, const double date);
   void invert_1d_2x2_matrix(double *x, double *y);
   void setoutputs(int tstep);
+  void fit_kernel_exponentials();
+  void update_kernel_sums(int tstep);
+  double kernel_weight(const int lag) const;
+  void extend_kernel(const int nlag);
+  void resize_buffers(const int n);
+  void grow_horizon(const int tstep);
+  void doeclim_step(const int tstep, const std::vector<double> &Q,
+                    const double past, std::vector<double> &tl,
+                    std::vector<double> &ts) const;
+  void doeclim_response(const std::vector<double> &Q, std::vector<double> &tl,
+                        std::vector<double> &ts,
+                        std::vector<double> &hflux) const;
 
   // Hard-coded DOECLIM parameters
   const double dt = 1;    // years per timestep (this is implicit in Hector)
-  int ns;                 // number of timesteps
+  int ns;                 // timesteps allocated (grows past endDate)
   const double ak = 0.31; // slope in climate feedback - land-sea heat exchange
                           // linear relationship (W/m2/K)
   const double bk = 1.59; // offset in climate feedback - land-sea heat exchange
@@ -116,21 +141,25 @@ private:
   double taukls;    // land-sea heat exchange time scale, yr
   double qco2;      // radiative forcing for atmospheric CO2 doubling
 
-  std::vector<double> KT0;
-  std::vector<double> KTA1;
-  std::vector<double> KTB1;
-  std::vector<double> KTA2;
-  std::vector<double> KTB2;
-  std::vector<double> KTA3;
-  std::vector<double> KTB3;
-
   // Components of the difference equation system B*T(i+1) = Q(i) + A*T(i)
   double B[4];
   double C[4];
-  std::vector<double> Ker;
+  std::vector<double> Ker; // diffusion kernel, indexed by lag
   double A[4];
   double IB[4];
 
+  // Sum-of-exponentials approximation of Ker, Ker[L] ~ sum_j a_j r_j^L
+  // for lags L >= 1. Each exponential's convolution with the SST history,
+  // S_j(t) = sum_{L=1}^{t} temp_sst[t-L] r_j^L, obeys
+  // S_j(t) = r_j * (S_j(t-1) + temp_sst[t-1]), so a timestep costs O(1)
+  // instead of O(t).
+  double kernel_tol;            // allowed relative error; 0 = exact kernel
+  std::vector<double> ker_rate; // r_j
+  std::vector<double> ker_amp;  // a_j
+  std::vector<double> ker_sum;  // S_j(ker_step)
+  int ker_step;                 // timestep ker_sum refers to (-1 = none)
+  bool use_ker_sums;            // false if kernel_tol is 0 or can't be met
+
   // Time series arrays that are updated with each DOECLIM time-step
   std::vector<double> temp;
   std::vector<double> temp_landair;
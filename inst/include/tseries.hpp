@@ -16,7 +16,9 @@
 
 #include <limits>
 #include <map>
+#include <memory>
 #include <sstream>
+#include <vector>
 
 #include "fluxpool.hpp"
 #include "h_exception.hpp"
@@ -28,10 +30,13 @@ namespace Hector {
 
 /*! \brief Time series data type.
  *
- *  Currently implemented as an STL map.
+ *  Currently implemented as an STL map.  The map is reference counted and
+ *  copied on write, so copies of a series (see share()) hold one map between
+ *  them until one of them is changed.  Only the map is shared: each series
+ *  has its own name, interpolation settings and interpolator.
  */
 template <class T_data> class tseries {
-  std::map<double, T_data> mapdata;
+  std::shared_ptr<std::map<double, T_data>> mapdata;
   double lastInterpYear;
   bool endinterp_allowed;
   mutable bool dirty; // does series need re-interpolating?
@@ -39,11 +44,15 @@ template <class T_data> class tseries {
   h_interpolator interpolator;
   void set_interp(double, bool, interpolation_methods);
   void fit_spline();
+  std::map<double, T_data> &writable();
 
 public:
+  typedef typename std::map<double, T_data>::const_iterator const_iterator;
+
   tseries();
 
   void set(double, T_data);
+  void set(const std::vector<double> &, const std::vector<T_data> &);
   T_data get(double) const;
   T_data get_deriv(double) const;
   bool exists(double) const;
@@ -58,6 +67,11 @@ public:
 
   void truncate(double t, bool after = true);
 
+  void share(const tseries &other);
+
+  const_iterator begin() const { return mapdata->begin(); }
+  const_iterator end() const { return mapdata->end(); }
+
   std::string name;
 };
 
@@ -277,7 +291,9 @@ template <> struct interp_helper<string> {
  *
  *  Initializes internal variables.
  */
-template <class T_data> tseries<T_data>::tseries() {
+template <class T_data>
+tseries<T_data>::tseries()
+    : mapdata(std::make_shared<std::map<double, T_data>>()) {
   set_interp(std::numeric_limits<double>::min(), false,
              DEFAULT); // default values
   dirty = false;
@@ -290,19 +306,114 @@ template <class T_data> tseries<T_data>::tseries() {
  *  Sets an (t, d) tuple, data d at time t.
  */
 template <class T_data> void tseries<T_data>::set(double t, T_data d) {
-  mapdata[t] = d;
+  writable()[t] = d;
   if (t < lastInterpYear) {
     dirty = true;
   }
 }
 
+//-----------------------------------------------------------------------
+/*! \brief 'Set' many values at once.
+ *
+ *  Sets data d[i] at time t[i] for each i.  Dates in increasing order (as
+ *  input tables are) are each inserted in constant time.
+ */
+template <class T_data>
+void tseries<T_data>::set(const std::vector<double> &t,
+                          const std::vector<T_data> &d) {
+  H_ASSERT(t.size() == d.size(), "dates and values differ in length");
+  std::map<double, T_data> &data = writable();
+  typename std::map<double, T_data>::iterator hint = data.end();
+  for (size_t i = 0; i < t.size(); ++i) {
+    hint = data.insert(hint, std::make_pair(t[i], d[i]));
+    hint->second = d[i];
+    if (t[i] < lastInterpYear) {
+      dirty = true;
+    }
+    ++hint;
+  }
+}
+
+//-----------------------------------------------------------------------
+/*! \brief Set a unitval series from plain values.
+ *
+ *  The values' units are checked against those expected once, rather than
+ *  once per value as setData does.
+ */
+inline void set_series(tseries<unitval> &series,
+                       const std::vector<double> &dates,
+                       const std::vector<double> &values,
+                       const unit_types units, const unit_types expected) {
+  unitval check(0.0, units);
+  check.expecting_unit(expected);
+
+  std::vector<unitval> data;
+  data.reserve(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    data.push_back(unitval(values[i], expected));
+  }
+  series.set(dates, data);
+}
+
+//-----------------------------------------------------------------------
+/*! \brief Make a unitval series from plain values, all in the same units.
+ */
+inline tseries<unitval> make_series(const std::vector<double> &dates,
+                                    const std::vector<double> &values,
+                                    const unit_types units) {
+  std::vector<unitval> data;
+  data.reserve(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    data.push_back(unitval(values[i], units));
+  }
+  tseries<unitval> series;
+  series.set(dates, data);
+  return series;
+}
+
+//-----------------------------------------------------------------------
+/*! \brief Set a unitval series from another series.
+ *
+ *  The values' units are checked against those expected.  If the series
+ *  is empty and the values already have the expected units, it shares the
+ *  values' map (see tseries::share) instead of copying it; otherwise they
+ *  are copied in, taking the expected units.
+ */
+inline void set_series(tseries<unitval> &series,
+                       const tseries<unitval> &values,
+                       const unit_types expected) {
+  bool as_expected = true;
+  for (tseries<unitval>::const_iterator it = values.begin();
+       it != values.end(); ++it) {
+    unitval check(0.0, it->second.units());
+    check.expecting_unit(expected);
+    as_expected = as_expected && it->second.units() == expected;
+  }
+
+  if (series.size() == 0 && as_expected) {
+    series.share(values);
+    return;
+  }
+
+  std::vector<double> dates;
+  std::vector<unitval> data;
+  dates.reserve(values.size());
+  data.reserve(values.size());
+  for (tseries<unitval>::const_iterator it = values.begin();
+       it != values.end(); ++it) {
+    dates.push_back(it->first);
+    data.push_back(unitval(it->second.value(it->second.units()), expected));
+  }
+  series.set(dates, data);
+}
+
 //-----------------------------------------------------------------------
 /*! \brief Does data exist at time (position) t?
  *
  *  Returns a bool to indicate if data exists.
  */
 template <class T_data> bool tseries<T_data>::exists(double t) const {
-  return (mapdata.find(t) != mapdata.end());
+  return (mapdata->find(t) != mapdata->end());
 }
 
 //-----------------------------------------------------------------------
@@ -315,15 +426,15 @@ template <class T_data> bool tseries<T_data>::exists(double t) const {
  *  as a constant (i.e, return the single value that we have).
  */
 template <class T_data> T_data tseries<T_data>::get(double t) const {
-  if (mapdata.size() == 1) {
-    return mapdata.begin()->second;
+  if (mapdata->size() == 1) {
+    return mapdata->begin()->second;
   }
-  typename std::map<double, T_data>::const_iterator itr = mapdata.find(t);
-  if (itr != mapdata.end())
+  typename std::map<double, T_data>::const_iterator itr = mapdata->find(t);
+  if (itr != mapdata->end())
     return (*itr).second;
   else if (t < lastInterpYear)
     return interp_helper<T_data>::interp(
-        mapdata, const_cast<tseries *>(this)->interpolator, name, dirty,
+        *mapdata, const_cast<tseries *>(this)->interpolator, name, dirty,
         endinterp_allowed, t);
   else {
     std::ostringstream errmsg;
@@ -340,13 +451,13 @@ template <class T_data> T_data tseries<T_data>::get(double t) const {
  *
  */
 template <class T_data> T_data tseries<T_data>::get_deriv(double t) const {
-  if (mapdata.size() == 1) {
+  if (mapdata->size() == 1) {
     H_THROW("More than one data point needed to calculate a derivative");
   }
 
   if (t < lastInterpYear) {
     return interp_helper<T_data>::calc_deriv(
-        mapdata, const_cast<tseries *>(this)->interpolator, name, dirty,
+        *mapdata, const_cast<tseries *>(this)->interpolator, name, dirty,
         endinterp_allowed, t);
   } else {
     std::ostringstream errmsg;
@@ -395,8 +506,8 @@ template <class T_data> void tseries<T_data>::allowPartialInterp(bool eia) {
  *  Return index of first element in series.
  */
 template <class T_data> double tseries<T_data>::firstdate() const {
-  H_ASSERT(!mapdata.empty(), "no mapdata");
-  return (*mapdata.begin()).first;
+  H_ASSERT(!mapdata->empty(), "no mapdata");
+  return (*mapdata->begin()).first;
 }
 
 //-----------------------------------------------------------------------
@@ -405,8 +516,8 @@ template <class T_data> double tseries<T_data>::firstdate() const {
  *  Return index of last element in series.
  */
 template <class T_data> double tseries<T_data>::lastdate() const {
-  H_ASSERT(!mapdata.empty(), "no mapdata");
-  return (*mapdata.rbegin()).first;
+  H_ASSERT(!mapdata->empty(), "no mapdata");
+  return (*mapdata->rbegin()).first;
 }
 
 //-----------------------------------------------------------------------
@@ -415,7 +526,7 @@ template <class T_data> double tseries<T_data>::lastdate() const {
  *  Return size of series.
  */
 template <class T_data> int tseries<T_data>::size() const {
-  return int(mapdata.size());
+  return int(mapdata->size());
 }
 
 /*! \brief truncate a time series
@@ -443,15 +554,42 @@ template <class T_data> int tseries<T_data>::size() const {
  *        compatible with whatever GCAM is doing.
  */
 template <class T> void tseries<T>::truncate(double t, bool after) {
+  std::map<double, T> &data = writable();
   typename std::map<double, T>::iterator it1, it2;
   if (after) {
-    it1 = mapdata.upper_bound(t);
-    it2 = mapdata.end();
+    it1 = data.upper_bound(t);
+    it2 = data.end();
   } else {
-    it1 = mapdata.begin();
-    it2 = mapdata.lower_bound(t);
+    it1 = data.begin();
+    it2 = data.lower_bound(t);
+  }
+  data.erase(it1, it2);
+}
+
+//-----------------------------------------------------------------------
+/*! \brief Take another series' data, sharing it rather than copying it.
+ *
+ *  This series' own data are dropped; its name and interpolation settings
+ *  are kept.  The shared map is copied if either series is later changed.
+ */
+template <class T> void tseries<T>::share(const tseries &other) {
+  mapdata = other.mapdata;
+  dirty = true;
+}
+
+//-----------------------------------------------------------------------
+/*! \brief The map, ready to be changed.
+ *
+ *  If the map is shared with another series it is copied first.  A map held
+ *  only by this series can't be picked up by another one meanwhile (that
+ *  would take a copy of this series), so the check is safe even when the
+ *  sharers are on different threads.
+ */
+template <class T> std::map<double, T> &tseries<T>::writable() {
+  if (mapdata.use_count() > 1) {
+    mapdata = std::make_shared<std::map<double, T>>(*mapdata);
   }
-  mapdata.erase(it1, it2);
+  return *mapdata;
 }
 
 } // namespace Hector
@@ -0,0 +1,57 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef WINDOW_MEAN_H
+#define WINDOW_MEAN_H
+/*
+ *  window_mean.hpp
+ *  hector
+ *
+ *  Annual record with O(1) lagged moving-window means.
+ *
+ */
+
+#include <vector>
+
+namespace Hector {
+
+//-----------------------------------------------------------------------
+/*! \brief Annual record with O(1) lagged moving-window means.
+ *
+ *  Stores one value per year, in order, together with running (prefix)
+ *  sums, so the mean over any window of years costs the same however long
+ *  the record or window. Years before the first value take the first value,
+ *  and years after the last take the last, as a tseries with end
+ *  interpolation allowed would. Truncating the record (on reset) simply
+ *  drops the later running sums.
+ */
+class window_mean {
+public:
+  window_mean();
+
+  void set_window(const int length, const int lag);
+  int get_length() const { return length; };
+  int get_lag() const { return lag; };
+
+  void set(const double date, const double value);
+  void truncate(const double date);
+  void clear();
+
+  size_t size() const { return values.size(); };
+  double mean(const double t) const;
+
+private:
+  int length; //!< number of years averaged
+  int lag;    //!< years between the end of the window and t
+
+  double first;                //!< date of values[0]
+  std::vector<double> values;  //!< one value per year from first
+  std::vector<double> running; //!< running[i] = sum of values[0..i-1]
+};
+
+} // namespace Hector
+
+#endif // WINDOW_MEAN_H
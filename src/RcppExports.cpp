@@ -2668,6 +2668,52 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// get_tracking_columns_impl
+DataFrame get_tracking_columns_impl(Environment core);
+RcppExport SEXP _hector_get_tracking_columns_impl(SEXP coreSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type core(coreSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_tracking_columns_impl(core));
+    return rcpp_result_gen;
+END_RCPP
+}
+// set_profiling
+Environment set_profiling(Environment core, bool enable);
+RcppExport SEXP _hector_set_profiling(SEXP coreSEXP, SEXP enableSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type core(coreSEXP);
+    Rcpp::traits::input_parameter< bool >::type enable(enableSEXP);
+    rcpp_result_gen = Rcpp::wrap(set_profiling(core, enable));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_profile
+DataFrame get_profile(Environment core);
+RcppExport SEXP _hector_get_profile(SEXP coreSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type core(coreSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_profile(core));
+    return rcpp_result_gen;
+END_RCPP
+}
+// write_profile
+Environment write_profile(Environment core, String file);
+RcppExport SEXP _hector_write_profile(SEXP coreSEXP, SEXP fileSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type core(coreSEXP);
+    Rcpp::traits::input_parameter< String >::type file(fileSEXP);
+    rcpp_result_gen = Rcpp::wrap(write_profile(core, file));
+    return rcpp_result_gen;
+END_RCPP
+}
 // get_biome_list
 std::vector<std::string> get_biome_list(Environment core);
 RcppExport SEXP _hector_get_biome_list(SEXP coreSEXP) {
@@ -2732,6 +2778,48 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// fetchvars_impl
+DataFrame fetchvars_impl(Environment core, CharacterVector vars, NumericVector date);
+RcppExport SEXP _hector_fetchvars_impl(SEXP coreSEXP, SEXP varsSEXP, SEXP dateSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type core(coreSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type vars(varsSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type date(dateSEXP);
+    rcpp_result_gen = Rcpp::wrap(fetchvars_impl(core, vars, date));
+    return rcpp_result_gen;
+END_RCPP
+}
+// temperature_response
+List temperature_response(Environment core, NumericMatrix forcing);
+RcppExport SEXP _hector_temperature_response(SEXP coreSEXP, SEXP forcingSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type core(coreSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type forcing(forcingSEXP);
+    rcpp_result_gen = Rcpp::wrap(temperature_response(core, forcing));
+    return rcpp_result_gen;
+END_RCPP
+}
+// run_ensemble_impl
+NumericVector run_ensemble_impl(String inifile, CharacterVector params, CharacterVector units, NumericMatrix values, CharacterVector vars, NumericVector date, int threads);
+RcppExport SEXP _hector_run_ensemble_impl(SEXP inifileSEXP, SEXP paramsSEXP, SEXP unitsSEXP, SEXP valuesSEXP, SEXP varsSEXP, SEXP dateSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< String >::type inifile(inifileSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type params(paramsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type units(unitsSEXP);
+    Rcpp::traits::input_parameter< NumericMatrix >::type values(valuesSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type vars(varsSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type date(dateSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(run_ensemble_impl(inifile, params, units, values, vars, date, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // chk_core_valid
 bool chk_core_valid(Environment core);
 RcppExport SEXP _hector_chk_core_valid(SEXP coreSEXP) {
@@ -3008,11 +3096,18 @@ static const R_CallMethodDef CallEntries[] = {
     {"_hector_run", (DL_FUNC) &_hector_run, 2},
     {"_hector_getdate", (DL_FUNC) &_hector_getdate, 1},
     {"_hector_get_tracking_data_impl", (DL_FUNC) &_hector_get_tracking_data_impl, 1},
+    {"_hector_get_tracking_columns_impl", (DL_FUNC) &_hector_get_tracking_columns_impl, 1},
+    {"_hector_set_profiling", (DL_FUNC) &_hector_set_profiling, 2},
+    {"_hector_get_profile", (DL_FUNC) &_hector_get_profile, 1},
+    {"_hector_write_profile", (DL_FUNC) &_hector_write_profile, 2},
     {"_hector_get_biome_list", (DL_FUNC) &_hector_get_biome_list, 1},
     {"_hector_create_biome_impl", (DL_FUNC) &_hector_create_biome_impl, 2},
     {"_hector_delete_biome_impl", (DL_FUNC) &_hector_delete_biome_impl, 2},
     {"_hector_rename_biome", (DL_FUNC) &_hector_rename_biome, 3},
     {"_hector_sendmessage", (DL_FUNC) &_hector_sendmessage, 6},
+    {"_hector_fetchvars_impl", (DL_FUNC) &_hector_fetchvars_impl, 3},
+    {"_hector_temperature_response", (DL_FUNC) &_hector_temperature_response, 2},
+    {"_hector_run_ensemble_impl", (DL_FUNC) &_hector_run_ensemble_impl, 7},
     {"_hector_chk_core_valid", (DL_FUNC) &_hector_chk_core_valid, 1},
     {NULL, NULL, 0}
 };
@@ -0,0 +1,128 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  async_writer.cpp
+ *  hector
+ *
+ *  Writes blocks of output to a stream on a background thread.
+ *
+ */
+
+#include "async_writer.hpp"
+#include "h_exception.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor; starts the writer thread
+ *  \param out The stream to write to.
+ *  \param blocks How many blocks may be waiting before write() waits.
+ */
+AsyncWriter::AsyncWriter(ostream &out, const size_t blocks)
+    : out(out), ring(blocks), head(0), tail(0), stopping(false) {
+  writer = thread(&AsyncWriter::run, this);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Destructor; writes everything queued and stops the writer thread
+ */
+AsyncWriter::~AsyncWriter() {
+  stopping = true;
+  wake_all();
+  writer.join();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Queue a block to be written
+ *  \param block The output; it is taken, and left empty.
+ *
+ *  Waits only if the queue is full.
+ */
+void AsyncWriter::write(string &block) {
+  if (block.empty()) {
+    return;
+  }
+
+  const size_t t = tail.load(memory_order_relaxed);
+  if (t - head.load(memory_order_acquire) == ring.size()) {
+    unique_lock<mutex> lock(sleep_mutex);
+    wake.wait(lock, [&] {
+      return t - head.load(memory_order_acquire) < ring.size();
+    });
+  }
+
+  string &slot = ring[t % ring.size()];
+  slot.swap(block);
+  block.clear();
+  tail.store(t + 1, memory_order_release);
+  wake_all();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Wait for everything queued to be written, and flush the stream
+ *  \exception The error from writing, if any block failed to be written.
+ */
+void AsyncWriter::flush() {
+  {
+    unique_lock<mutex> lock(sleep_mutex);
+    wake.wait(lock, [&] {
+      return head.load(memory_order_acquire) ==
+             tail.load(memory_order_relaxed);
+    });
+  }
+  if (error) {
+    rethrow_exception(error);
+  }
+  out.flush();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Wake whichever thread is sleeping
+ *
+ *  Taking the mutex first means a thread that has just checked its condition
+ *  is either asleep or will see the change, so no wakeup is lost.
+ */
+void AsyncWriter::wake_all() {
+  { lock_guard<mutex> lock(sleep_mutex); }
+  wake.notify_all();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief The writer thread: write blocks as they arrive until stopped
+ */
+void AsyncWriter::run() {
+  while (true) {
+    const size_t h = head.load(memory_order_relaxed);
+    if (h == tail.load(memory_order_acquire)) {
+      if (stopping) {
+        return;
+      }
+      unique_lock<mutex> lock(sleep_mutex);
+      wake.wait(lock, [&] {
+        return h != tail.load(memory_order_acquire) || stopping;
+      });
+      continue;
+    }
+
+    string &slot = ring[h % ring.size()];
+    if (!error) {
+      try {
+        out.write(slot.data(), slot.size());
+        H_ASSERT(out, "error writing output stream");
+      } catch (...) {
+        error = current_exception();
+      }
+    }
+    slot.clear();
+    head.store(h + 1, memory_order_release);
+    wake_all();
+  }
+}
+
+} // namespace Hector
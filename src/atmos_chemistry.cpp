@@ -0,0 +1,76 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  atmos_chemistry.cpp
+ *  hector
+ *
+ *  Fused chemistry step for the CH4, OH, O3 and N2O components.
+ *
+ */
+
+#include "atmos_chemistry.hpp"
+#include "ch4_component.hpp"
+#include "core.hpp"
+#include "n2o_component.hpp"
+#include "o3_component.hpp"
+#include "oh_component.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Find the component providing a capability, if it is enabled
+ */
+template <class T>
+static T *find_component(Core *core, const std::string &capability) {
+  if (!core->checkCapability(capability))
+    return NULL;
+  return dynamic_cast<T *>(core->getComponentByCapability(capability));
+}
+
+//------------------------------------------------------------------------------
+/*! \brief               Advance CH4, OH, O3 and N2O by one year
+ *  \param[in] core      the model core
+ *  \param[in] runToDate year to compute
+ *  \details The species are advanced in the order the unfused components run
+ *           (OH from last year's CH4, CH4 from this year's OH lifetime, O3
+ *           from this year's CH4), so the results are identical. O3 and N2O
+ *           may be disabled; OH and CH4 need each other.
+ */
+void AtmosChemistry::run(Core *core, const double runToDate) {
+  OHComponent *oh = find_component<OHComponent>(core, D_LIFETIME_OH);
+  CH4Component *ch4 = find_component<CH4Component>(core, D_CH4_CONC);
+  OzoneComponent *o3 = find_component<OzoneComponent>(core, D_ATMOSPHERIC_O3);
+  N2OComponent *n2o = find_component<N2OComponent>(core, D_N2O_CONC);
+  H_ASSERT(oh && ch4, "fused chemistry needs the OH and CH4 components");
+
+  // ---------- OH lifetime, from last year's CH4 ----------
+  oh->advance(runToDate, ch4->CH4.get(oh->oldDate).value(U_PPBV_CH4));
+
+  // ---------- CH4 ----------
+  if (ch4->CH4_constrain.size() && ch4->CH4_constrain.exists(runToDate)) {
+    ch4->advance(runToDate, 0.0, 0.0);
+  } else {
+    // The carbon cycle computes this flux each year, so it can't be fetched
+    // once for the run; it is the one input that still comes via the core
+    const double rh_ch4 =
+        core->sendMessage(M_GETDATA, D_RH_CH4).value(U_PGC_YR) *
+        PG_C_TO_TG_CH4;
+    ch4->advance(runToDate, oh->TAU_OH.get(runToDate).value(U_YRS), rh_ch4);
+  }
+
+  // ---------- Tropospheric O3, from this year's CH4 ----------
+  if (o3)
+    o3->advance(runToDate, ch4->CH4.get(runToDate));
+
+  // ---------- N2O ----------
+  if (n2o)
+    n2o->advance(runToDate);
+}
+
+} // namespace Hector
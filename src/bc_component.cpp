@@ -95,6 +95,21 @@ void BlackCarbonComponent::setData(const string &varName,
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void BlackCarbonComponent::setSeries(const string &varName,
+                                     const tseries<unitval> &series) {
+  try {
+    if (varName == D_EMISSIONS_BC) {
+      set_series(BC_emissions, series, U_TG);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void BlackCarbonComponent::prepareToRun() {
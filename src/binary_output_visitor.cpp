@@ -0,0 +1,173 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  binary_output_visitor.cpp
+ *  hector
+ *
+ *  Columnar binary output of selected variables.
+ *
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <stdint.h>
+
+#include "binary_output_visitor.hpp"
+#include "core.hpp"
+#include "h_util.hpp"
+#include "imodel_component.hpp"
+
+//! First bytes of every output file
+#define COLUMNS_MAGIC "HCOL"
+
+//! Output file format version
+#define COLUMNS_VERSION 1
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ *  \param fileName The file to write to.
+ *  \param variables The variables (capabilities) to record.
+ */
+BinaryOutputVisitor::BinaryOutputVisitor(const string &fileName,
+                                         const vector<string> &variables)
+    : fileName(fileName), names(variables), units(variables.size()),
+      columns(variables.size()), current_date(0), recording(false),
+      written(true), glog(NULL) {}
+
+//------------------------------------------------------------------------------
+/*! \brief Destructor
+ *
+ *  Writes the file if there is anything not yet written.  A destructor
+ *  mustn't throw, so a write error is only logged to the visited core's log
+ *  (that core must still exist); call write() first to see it.
+ */
+BinaryOutputVisitor::~BinaryOutputVisitor() {
+  if (!written) {
+    try {
+      write();
+    } catch (h_exception &e) {
+      if (glog) {
+        Logger &log = *glog;
+        H_LOG(log, Logger::SEVERE)
+            << "binary output not written: " << e.what() << endl;
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+bool BinaryOutputVisitor::shouldVisit(const bool in_spinup, const double date) {
+  current_date = date;
+  recording = !in_spinup;
+  return recording;
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void BinaryOutputVisitor::reset(const double reset_date) {
+  size_t keep = 0;
+  while (keep < years.size() && years[keep] <= reset_date) {
+    ++keep;
+  }
+  years.resize(keep);
+  for (size_t i = 0; i < columns.size(); ++i) {
+    columns[i].resize(keep);
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Record this year's values
+ *
+ *  The core visits once before spinup, to let visitors set up; that's when
+ *  the variables are looked up, so an unknown one is an error before the run
+ *  starts.  The variables are time series, asked for by date as R's fetchvars
+ *  does; parameters (which don't take a date) can't be recorded.  All of a
+ *  year's values are fetched before any is appended, so a failed visit
+ *  leaves the columns as they were.
+ *  \exception h_exception If a variable can't be fetched for this date.
+ */
+void BinaryOutputVisitor::visit(Core *c) {
+  glog = &c->getGlobalLogger();
+  if (sources.empty()) {
+    for (size_t i = 0; i < names.size(); ++i) {
+      H_ASSERT(c->checkCapability(names[i]),
+               "Unknown output variable: " + names[i]);
+      sources.push_back(c->getComponentByCapability(names[i]));
+    }
+  }
+  if (!recording) {
+    return;
+  }
+  recording = false;
+
+  const message_data date(current_date);
+  vector<unitval> row;
+  row.reserve(names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    try {
+      row.push_back(sources[i]->sendMessage(M_GETDATA, names[i], date));
+    } catch (h_exception &e) {
+      H_RETHROW(e, "Could not record time series " + names[i]);
+    }
+  }
+
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (years.empty()) {
+      units[i] = row[i].unitsName();
+    }
+    columns[i].push_back(row[i].value(row[i].units()));
+  }
+  years.push_back(current_date);
+  written = false;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Write the recorded columns to the output file
+ *  \exception h_exception If the file can't be written.
+ */
+void BinaryOutputVisitor::write() {
+  ofstream out(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+  if (!out) {
+    H_THROW("Could not open " + fileName + " error: " + strerror(errno));
+  }
+
+  out.write(COLUMNS_MAGIC, 4);
+  put_binary(out, uint32_t(COLUMNS_VERSION));
+  put_binary(out, uint32_t(names.size() + 1));
+  put_binary(out, uint64_t(years.size()));
+
+  put_binary_string(out, "year");
+  put_binary_string(out, "");
+  put_binary(out, 'd');
+  for (size_t i = 0; i < names.size(); ++i) {
+    put_binary_string(out, names[i]);
+    put_binary_string(out, units[i]);
+    put_binary(out, 'd');
+  }
+
+  out.write(reinterpret_cast<const char *>(years.data()),
+            years.size() * sizeof(double));
+  for (size_t i = 0; i < columns.size(); ++i) {
+    out.write(reinterpret_cast<const char *>(columns[i].data()),
+              columns[i].size() * sizeof(double));
+  }
+
+  out.close();
+  if (!out) {
+    H_THROW("Error writing " + fileName);
+  }
+  written = true;
+}
+
+} // namespace Hector
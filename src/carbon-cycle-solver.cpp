@@ -28,11 +28,57 @@
 
 namespace Hector {
 
+namespace {
+/*! \brief An odeint controlled stepper that counts the steps it takes.
+ *
+ *  Wraps another controlled stepper, so integrate_adaptive steps exactly as
+ *  it would with that stepper, while accepted and rejected steps are counted
+ *  and the step size proposed after each accepted step is kept.
+ */
+template <class Stepper> class counting_stepper {
+public:
+  typedef boost::numeric::odeint::controlled_stepper_tag stepper_category;
+
+  counting_stepper(const Stepper &stepper, unsigned long *accepted,
+                   unsigned long *rejected, double *final_dt)
+      : stepper(stepper), accepted(accepted), rejected(rejected),
+        final_dt(final_dt) {}
+
+  template <class System, class State, class Time>
+  boost::numeric::odeint::controlled_step_result
+  try_step(System system, State &x, Time &t, Time &dt) {
+    boost::numeric::odeint::controlled_step_result res =
+        stepper.try_step(system, x, t, dt);
+    if (res == boost::numeric::odeint::success) {
+      ++*accepted;
+      *final_dt = dt;
+    } else {
+      ++*rejected;
+    }
+    return res;
+  }
+
+private:
+  Stepper stepper;
+  unsigned long *accepted;
+  unsigned long *rejected;
+  double *final_dt;
+};
+
+template <class Stepper>
+counting_stepper<Stepper> make_counting(const Stepper &stepper,
+                                        unsigned long *accepted,
+                                        unsigned long *rejected,
+                                        double *final_dt) {
+  return counting_stepper<Stepper>(stepper, accepted, rejected, final_dt);
+}
+} // namespace
+
 //------------------------------------------------------------------------------
 /*! \brief Constructor
  */
 CarbonCycleSolver::CarbonCycleSolver()
-    : nc(0), eps_abs(1.0e-6), eps_rel(1.0e-6), dt(0.3) {}
+    : nc(0), eps_abs(1.0e-6), eps_rel(1.0e-6), dt(0.3), dt_input(0.3) {}
 
 //------------------------------------------------------------------------------
 /*! \brief Deconstructor
@@ -57,6 +103,13 @@ void CarbonCycleSolver::init(Core *coreptr) {
   // We want to run after the carbon box models, to give them a chance to
   // initialize
   core->registerDependency(D_ATMOSPHERIC_CO2, getComponentName());
+
+  // Register the data we can provide
+  core->registerCapability(D_SOLVER_RHS_EVALS, getComponentName());
+  core->registerCapability(D_SOLVER_ACCEPTED_STEPS, getComponentName());
+  core->registerCapability(D_SOLVER_REJECTED_STEPS, getComponentName());
+  core->registerCapability(D_SOLVER_RETRIES, getComponentName());
+  core->registerCapability(D_SOLVER_FINAL_DT, getComponentName());
 }
 
 //------------------------------------------------------------------------------
@@ -97,7 +150,7 @@ void CarbonCycleSolver::setData(const std::string &varName,
       ;
     } else if (varName == D_CCS_DT) {
       H_ASSERT(data.date == Core::undefinedIndex(), "date not allowed");
-      dt = data.getUnitval(U_UNDEFINED);
+      dt = dt_input = data.getUnitval(U_UNDEFINED);
     } else if (varName == D_EPS_SPINUP) {
       H_ASSERT(data.date == Core::undefinedIndex(), "date not allowed");
       eps_spinup = data.getUnitval(U_PGC);
@@ -131,6 +184,10 @@ void CarbonCycleSolver::prepareToRun() {
   H_ASSERT(nc > 0, "nc must be > 0");
   // resize the array of carbon pool values
   c.resize(nc);
+
+  // Nothing run yet at the start date; spinup overwrites this
+  stats = solver_stats();
+  record_stats(t);
 }
 
 //------------------------------------------------------------------------------
@@ -140,17 +197,65 @@ unitval CarbonCycleSolver::getData(const std::string &varName,
 
   unitval returnval;
 
-  H_ASSERT(date == Core::undefinedIndex(),
-           "Date not allowed for CarbonCycleSolver");
-
-  H_THROW("Caller is requesting unknown variable: " + varName);
+  if (date == Core::undefinedIndex()) {
+    // The last step run (which may be a spinup step)
+    if (varName == D_SOLVER_RHS_EVALS) {
+      returnval = unitval(stats.evaluations, U_UNITLESS);
+    } else if (varName == D_SOLVER_ACCEPTED_STEPS) {
+      returnval = unitval(stats.accepted, U_UNITLESS);
+    } else if (varName == D_SOLVER_REJECTED_STEPS) {
+      returnval = unitval(stats.rejected, U_UNITLESS);
+    } else if (varName == D_SOLVER_RETRIES) {
+      returnval = unitval(stats.retries, U_UNITLESS);
+    } else if (varName == D_SOLVER_FINAL_DT) {
+      returnval = unitval(stats.final_dt, U_YRS);
+    } else {
+      H_THROW("Caller is requesting unknown variable: " + varName);
+    }
+  } else {
+    if (varName == D_SOLVER_RHS_EVALS) {
+      returnval = rhs_evals_ts.get(date);
+    } else if (varName == D_SOLVER_ACCEPTED_STEPS) {
+      returnval = accepted_steps_ts.get(date);
+    } else if (varName == D_SOLVER_REJECTED_STEPS) {
+      returnval = rejected_steps_ts.get(date);
+    } else if (varName == D_SOLVER_RETRIES) {
+      returnval = retries_ts.get(date);
+    } else if (varName == D_SOLVER_FINAL_DT) {
+      returnval = final_dt_ts.get(date);
+    } else {
+      H_THROW("Caller is requesting unknown variable: " + varName);
+    }
+  }
 
   return returnval;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Record the statistics of the step just run
+ *  \param date The date to record them at.
+ */
+void CarbonCycleSolver::record_stats(double date) {
+  rhs_evals_ts.set(date, unitval(stats.evaluations, U_UNITLESS));
+  accepted_steps_ts.set(date, unitval(stats.accepted, U_UNITLESS));
+  rejected_steps_ts.set(date, unitval(stats.rejected, U_UNITLESS));
+  retries_ts.set(date, unitval(stats.retries, U_UNITLESS));
+  final_dt_ts.set(date, unitval(stats.final_dt, U_YRS));
+  dt_ts.set(date, dt);
+}
+
 void CarbonCycleSolver::reset(double time) {
-  // Only state maintained by this component is the time counter
+  // State maintained by this component is the time counter, the stepsize
+  // and the solver statistics
   t = time;
+  dt = dt_ts.exists(time) ? dt_ts.get(time) : dt_input;
+  dt_ts.truncate(time);
+  rhs_evals_ts.truncate(time);
+  accepted_steps_ts.truncate(time);
+  rejected_steps_ts.truncate(time);
+  retries_ts.truncate(time);
+  final_dt_ts.truncate(time);
+  stats = solver_stats();
   in_spinup =
       false; // reset this in case we will be expected to rerun the spinup.
   H_LOG(logger, Logger::NOTICE)
@@ -177,7 +282,12 @@ void CarbonCycleSolver::ODEEvalFunctor::operator()(const std::vector<double> &y,
                                                    double t) {
   // Note the std guarantees that vectors are contiguous, so we can convert to
   // array by taking the address of the first value.
-  int status = modelptr->calcderivs(t, &y[0], &dydt[0]);
+  int status;
+  {
+    profile_timer timer(profile);
+    status = modelptr->calcderivs(t, &y[0], &dydt[0]);
+  }
+  ++*evaluations;
 
   if (status != ODE_SUCCESS) {
     bad_derivative_exception e(status);
@@ -232,9 +342,19 @@ void CarbonCycleSolver::run(const double tnew) {
   cmodel->getCValues(t, &c[0]);
 
   double t0 = t; // stash this in case we need to report & diagnose an error
+  stats = solver_stats();
   // Now integrate from the beginning of the time step using the updated
   // slow params.  Note we can discard t0 and the values in cc
-  cmodel->slowparameval(t, &c[0]);
+  Profiler &profiler = core->getProfiler();
+  {
+    profile_timer timer(profiler, cmodel->getComponentName(),
+                        PROFILE_SLOWPARAMEVAL);
+    cmodel->slowparameval(t, &c[0]);
+  }
+  profile_entry *derivs_profile =
+      profiler.isEnabled()
+          ? &profiler.entry(cmodel->getComponentName(), PROFILE_CALCDERIVS)
+          : NULL;
   int retry = 0;
 
   H_LOG(logger, Logger::DEBUG)
@@ -252,18 +372,21 @@ void CarbonCycleSolver::run(const double tnew) {
           << "->" << tnew << ")" << std::endl;
 
       int stat = ODE_SUCCESS;
-      ODEEvalFunctor odeFunctor(cmodel, &t);
+      ODEEvalFunctor odeFunctor(cmodel, &t, derivs_profile,
+                                &stats.evaluations);
       try {
         using namespace boost::numeric::odeint;
         typedef runge_kutta_dopri5<std::vector<double>> error_stepper_type;
         integrate_adaptive(
-            make_controlled<error_stepper_type>(eps_abs, eps_rel), odeFunctor,
-            c, t_start, t_target, dt, odeFunctor);
+            make_counting(make_controlled<error_stepper_type>(eps_abs, eps_rel),
+                          &stats.accepted, &stats.rejected, &stats.final_dt),
+            odeFunctor, c, t_start, t_target, dt, odeFunctor);
       } catch (bad_derivative_exception &e) {
         stat = e.errorFlag;
       }
 
       if (stat == CARBON_CYCLE_RETRY) {
+        ++stats.retries;
         H_LOG(logger, Logger::NOTICE) << "Carbon model requests retry #"
                                       << ++retry << " at t= " << t << std::endl;
         t_target = t_start + (t_target - t_start) / 2.0;
@@ -298,6 +421,9 @@ void CarbonCycleSolver::run(const double tnew) {
   H_LOG(logger, Logger::DEBUG) << "cvals\terrors\n";
 
   cmodel->record_state(tnew);
+  if (!core->inSpinup()) {
+    record_stats(tnew);
+  }
 
   H_LOG(logger, Logger::NOTICE) << std::endl;
 }
@@ -365,6 +491,7 @@ bool CarbonCycleSolver::run_spinup(const int step) {
   // Record the state as the state at the model start time.  This
   // will be repeatedly overwritten until the spinup is complete.
   cmodel->record_state(core->getStartDate());
+  record_stats(core->getStartDate());
 
   return spunup;
 }
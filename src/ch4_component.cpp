@@ -13,6 +13,7 @@
  */
 
 #include "ch4_component.hpp"
+#include "atmos_chemistry.hpp"
 #include "avisitor.hpp"
 #include "core.hpp"
 #include "h_util.hpp"
@@ -130,6 +131,23 @@ void CH4Component::setData(const string &varName, const message_data &data) {
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void CH4Component::setSeries(const string &varName,
+                             const tseries<unitval> &series) {
+  try {
+    if (varName == D_EMISSIONS_CH4) {
+      set_series(CH4_emissions, series, U_TG_CH4);
+    } else if (varName == D_CONSTRAINT_CH4) {
+      set_series(CH4_constrain, series, U_PPBV_CH4);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void CH4Component::prepareToRun() {
@@ -148,6 +166,34 @@ void CH4Component::prepareToRun() {
 //------------------------------------------------------------------------------
 // documentation is inherited
 void CH4Component::run(const double runToDate) {
+  if (core->fusedChemistry()) {
+    // The fused chemistry step advances CH4 along with the other species
+    if (oldDate < runToDate)
+      AtmosChemistry::run(core, runToDate);
+    return;
+  }
+
+  double current_toh = 0.0;
+  double rh_ch4 = 0.0;
+  if (!(CH4_constrain.size() && CH4_constrain.exists(runToDate))) {
+    current_toh =
+        core->sendMessage(M_GETDATA, D_LIFETIME_OH, runToDate).value(U_YRS);
+    rh_ch4 = core->sendMessage(M_GETDATA, D_RH_CH4).value(U_PGC_YR) *
+             PG_C_TO_TG_CH4;
+  }
+
+  advance(runToDate, current_toh, rh_ch4);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief                 Compute the CH4 concentration for one year
+ *  \param[in] runToDate   year to compute
+ *  \param[in] current_toh OH lifetime this year (yr)
+ *  \param[in] rh_ch4      CH4 emissions from thawed permafrost (Tg CH4/yr)
+ *  \details Unused if the concentration is constrained this year.
+ */
+void CH4Component::advance(const double runToDate, const double current_toh,
+                           const double rh_ch4) {
   H_ASSERT(!core->inSpinup() && runToDate - oldDate == 1,
            "timestep must equal 1");
 
@@ -158,17 +204,10 @@ void CH4Component::run(const double runToDate) {
     // modified from Wigley et al, 2002
     // https://doi.org/10.1175/1520-0442(2002)015%3C2690:RFDTRG%3E2.0.CO;2
     const double current_ch4em = CH4_emissions.get(runToDate).value(U_TG_CH4);
-    const double current_toh =
-        core->sendMessage(M_GETDATA, D_LIFETIME_OH, runToDate).value(U_YRS);
     H_LOG(logger, Logger::DEBUG)
         << "Year " << runToDate << " current_toh = " << current_toh
         << std::endl;
 
-// Permafrost thaw produces CH4 emissions
-#define PG_C_TO_TG_CH4 (1000.0 * 16.04 / 12.01)
-    const double rh_ch4 =
-        core->sendMessage(M_GETDATA, D_RH_CH4).value(U_PGC_YR) * PG_C_TO_TG_CH4;
-
     // Additional, background CH4 natural emissions
     const double ch4n = CH4N.value(U_TG_CH4);
     const double emisTocon =
@@ -13,11 +13,13 @@
  */
 
 #include <fstream>
+#include <typeinfo>
 // some boost headers generate warnings under clang; not our problem, ignore
 // 2023 and Boost 1.81.0_1: string.hpp still generates two warnings
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Weverything"
 #include "boost/algorithm/string.hpp"
+#include "boost/core/demangle.hpp"
 #pragma clang diagnostic pop
 
 #include "avisitor.hpp"
@@ -38,6 +40,7 @@
 #include "oc_component.hpp"
 #include "ocean_component.hpp"
 #include "oh_component.hpp"
+#include "scenario_bundle.hpp"
 #include "simpleNbox.hpp"
 #include "slr_component.hpp"
 #include "so2_component.hpp"
@@ -58,7 +61,8 @@ using namespace std;
 Core::Core(Logger::LogLevel loglvl, bool echotoscreen, bool echotofile)
     : setup_complete(false), run_name(""), startDate(-1.0), endDate(-1.0),
       lastDate(-1.0), trackingDate(9999), isInited(false), do_spinup(true),
-      max_spinup(2000), in_spinup(false) {
+      max_spinup(2000), fused_chemistry(false), input_recorder(NULL),
+      in_spinup(false) {
   glog.open(string(MODEL_NAME), echotoscreen, echotofile, loglvl);
 }
 
@@ -208,6 +212,18 @@ std::string Core::getTrackingData() const {
   return tracking_out.str();
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Return the carbon tracking data stored in the csvFluxPoolVisitor, as
+ *         columns
+ *  \param columns Filled with the tracking data.
+ */
+void Core::getTrackingColumns(tracking_columns &columns) const {
+  columns = tracking_columns();
+  for (auto visitorIt : modelVisitors) {
+    visitorIt->outputTrackingColumns(columns);
+  }
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Route a setData to the component specified by componentName or parse
  *         the data if componentName is equal to Core::getComponentName().
@@ -218,6 +234,10 @@ std::string Core::getTrackingData() const {
  */
 void Core::setData(const string &componentName, const string &varName,
                    const message_data &data) {
+  if (input_recorder) {
+    input_recorder->recordData(componentName, varName, data);
+  }
+
   if (componentName == getComponentName()) {
     try {
       if (varName == D_RUN_NAME) {
@@ -238,6 +258,12 @@ void Core::setData(const string &componentName, const string &varName,
       } else if (varName == D_MAX_SPINUP) {
         H_ASSERT(data.date == undefinedIndex(), "date not allowed");
         max_spinup = data.getUnitval(U_UNDEFINED);
+      } else if (varName == D_FUSED_CHEMISTRY) {
+        H_ASSERT(data.date == undefinedIndex(), "date not allowed");
+        fused_chemistry = (data.getUnitval(U_UNDEFINED) > 0);
+      } else if (varName == D_BINARY_OUTPUT) {
+        H_ASSERT(data.date == undefinedIndex(), "date not allowed");
+        binary_output = data.value_str;
       } else {
         H_THROW("Unknown variable name while parsing " + getComponentName() +
                 ": " + varName);
@@ -267,6 +293,56 @@ void Core::setData(const string &componentName, const string &varName,
   }
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Route a whole time series to the component specified by
+ *         componentName.
+ *
+ *  Equivalent to calling setData with each (date, value) pair, but the
+ *  component is looked up once and may store the series in one go.
+ *
+ *  \param componentName The name of the component to forward the series to.
+ *  \param varName The time series variable to set.
+ *  \param dates The dates to set.
+ *  \param values The value for each date.
+ *  \param units Units of the values (U_UNDEFINED to take the expected ones).
+ *  \exception h_exception If either the componentName or varName was not
+ * recognized, or the variable isn't a time series.
+ */
+void Core::setSeries(const string &componentName, const string &varName,
+                     const vector<double> &dates, const vector<double> &values,
+                     const unit_types units) {
+  H_ASSERT(dates.size() == values.size(),
+           "dates and values differ in length for " + varName);
+  setSeries(componentName, varName, make_series(dates, values, units));
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Route a whole time series to the component specified by
+ *         componentName.
+ *
+ *  As above, but the component may keep a reference to the series' data
+ *  rather than a copy (see tseries::share), so cores set up from one series
+ *  (e.g. from one ScenarioBundle) share its storage.
+ *
+ *  \param componentName The name of the component to forward the series to.
+ *  \param varName The time series variable to set.
+ *  \param series The values to set.
+ *  \exception h_exception If either the componentName or varName was not
+ * recognized, or the variable isn't a time series.
+ */
+void Core::setSeries(const string &componentName, const string &varName,
+                     const tseries<unitval> &series) {
+  if (input_recorder) {
+    input_recorder->recordSeries(componentName, varName, series);
+  }
+  if (componentName == getComponentName() || varName == D_ENABLED ||
+      varName == D_OUTPUT_ENABLED) {
+    H_THROW("Variable " + varName + " in " + componentName +
+            " is not a time series");
+  }
+  getComponentByName(componentName)->setSeries(varName, series);
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Add a visitor which will be called after each model time-step.
  *
@@ -397,11 +473,14 @@ bool Core::run_spinup() {
   int step = 0;
   while (!spunup && ++step < max_spinup) {
     spunup = true;
-    for (auto mc : modelComponents)
+    for (auto mc : modelComponents) {
+      profile_timer timer(profiler, mc.first, PROFILE_RUN_SPINUP);
       spunup = spunup && mc.second->run_spinup(step);
+    }
     // Let visitors attempt to collect data if necessary
     for (auto vis : modelVisitors) {
       if (vis->shouldVisit(in_spinup, step)) {
+        profile_timer timer(visitorProfile(vis));
         accept(vis);
       }
     } // for
@@ -475,6 +554,7 @@ void Core::run(double runtodate) {
   // done_with_spinup() signal to the components--a lot of work.
   for (auto visitorIt : modelVisitors) {
     if (visitorIt->shouldVisit(true, lastDate)) {
+      profile_timer timer(visitorProfile(visitorIt));
       accept(visitorIt);
     }
   }
@@ -492,12 +572,17 @@ void Core::run(double runtodate) {
     }
 
     for (auto it : modelComponents) {
+      profile_timer timer(profiler, it.first, PROFILE_RUN);
       it.second->run(currDate);
     }
+    // Components have finished this date, so visitors (and anything else)
+    // may ask for its values by date
+    lastDate = currDate;
 
     // Let visitors attempt to collect data if necessary
     for (auto vis : modelVisitors) {
       if (vis->shouldVisit(in_spinup, currDate)) {
+        profile_timer timer(visitorProfile(vis));
         accept(vis);
       }
     }
@@ -526,6 +611,7 @@ void Core::reset(double resetdate) {
   // Order all components to reset
   for (auto mc : modelComponents) {
     H_LOG(glog, Logger::DEBUG) << "Resetting component: " << mc.first << endl;
+    profile_timer timer(profiler, mc.first, PROFILE_RESET);
     mc.second->reset(resetdate);
   }
 
@@ -707,24 +793,31 @@ unitval Core::getData(const std::string &varName, const double date) {
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Look up component and send message in one operation.
- *  \param message  The message to pass (typically "getData").
- *  \param datum    The datum caller is interested in.
- *  \param info     Extra information, message-specific.
- *  \exception h_exception If the componentName was not recognized.
+/*! \brief The capability named by a datum, dropping any biome prefix.
  */
-unitval Core::sendMessage(const std::string &message, const std::string &datum,
-                          const message_data &info) {
+static std::string capabilityOf(const std::string &datum) {
   std::vector<std::string> datum_split;
   boost::split(datum_split, datum, boost::is_any_of(SNBOX_PARSECHAR));
   H_ASSERT(datum_split.size() < 3,
            "max of one separator allowed in variable names");
-  std::string datum_capability;
   if (datum_split.size() == 2) {
-    datum_capability = datum_split[1];
+    return datum_split[1];
   } else {
-    datum_capability = datum_split[0];
+    return datum_split[0];
   }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Look up component and send message in one operation.
+ *  \param message  The message to pass (typically "getData").
+ *  \param datum    The datum caller is interested in.
+ *  \param info     Extra information, message-specific.
+ *  \exception h_exception If the componentName was not recognized.
+ */
+unitval Core::sendMessage(const std::string &message, const std::string &datum,
+                          const message_data &info) {
+  const std::string datum_capability = capabilityOf(datum);
+  profile_timer timer(profiler, datum_capability, PROFILE_MESSAGE);
 
   if (message == M_GETDATA || message == M_DUMP_TO_DEEP_OCEAN) {
     // M_GETDATA is used extensively by components to query each other re state
@@ -777,6 +870,83 @@ unitval Core::sendMessage(const std::string &message, const std::string &datum,
   }
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Set a whole time series input in one operation.
+ *
+ *  Equivalent to sending M_SETDATA for each (date, value) pair, but each
+ *  component taking the input is looked up once and handed the whole series
+ *  (see IModelComponent::setSeries).
+ *
+ *  \param datum    The input to set.
+ *  \param dates    The dates to set.
+ *  \param values   The value for each date.
+ *  \param units    Units of the values.
+ *  \exception h_exception If no component takes the input, or it isn't a
+ *                         time series.
+ */
+void Core::sendSeries(const std::string &datum,
+                      const std::vector<double> &dates,
+                      const std::vector<double> &values,
+                      const unit_types units) {
+  pair<componentMapIterator, componentMapIterator> itpr =
+      componentInputs.equal_range(capabilityOf(datum));
+  if (itpr.first == itpr.second) {
+    H_LOG(glog, Logger::SEVERE) << "No such input: " << datum << "  Aborting.";
+    H_THROW("Invalid datum in sendSeries.");
+  }
+
+  H_ASSERT(dates.size() == values.size(),
+           "dates and values differ in length for " + datum);
+  const tseries<unitval> series = make_series(dates, values, units);
+  for (componentMapIterator it = itpr.first; it != itpr.second; ++it) {
+    setSeries(it->second, datum, series);
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Get several variables at several dates in one operation.
+ *
+ *  Equivalent to sending M_GETDATA for each (variable, date) pair, but each
+ *  variable's component is looked up once. When profiling, each pair counts
+ *  as one message for the variable's capability, as sendMessage would.
+ *
+ *  \param vars     The variables to get.
+ *  \param dates    The dates to get them at (undefinedIndex() for none).
+ *  \param results  Filled with the values, all dates of the first variable,
+ *                  then all dates of the second, and so on.
+ *  \exception h_exception If a variable is unknown, or any of the components
+ *                         can't provide it.
+ */
+void Core::fetchVars(const std::vector<std::string> &vars,
+                     const std::vector<double> &dates,
+                     std::vector<unitval> &results) {
+  H_ASSERT(isInited, "fetchVars not available until core is initialized.");
+
+  results.resize(vars.size() * dates.size());
+  vector<unitval>::iterator out = results.begin();
+  for (const std::string &var : vars) {
+    const std::string capability = capabilityOf(var);
+    componentMapIterator it = componentCapabilities.find(capability);
+    H_ASSERT(it != componentCapabilities.end(), "Unknown model datum: " + var);
+    profile_entry *entry = profiler.isEnabled()
+                               ? &profiler.entry(capability, PROFILE_MESSAGE)
+                               : NULL;
+
+    if (it->second == CORE_COMPONENT_NAME) {
+      for (double date : dates) {
+        profile_timer timer(entry);
+        *out++ = getData(var, date);
+      }
+    } else {
+      IModelComponent *component = getComponentByName(it->second);
+      for (double date : dates) {
+        profile_timer timer(entry);
+        *out++ = component->sendMessage(M_GETDATA, var, message_data(date));
+      }
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Add an additional model component to be run.
  *  \param modelComponent The model component to add.
@@ -791,6 +961,19 @@ void Core::addModelComponent(IModelComponent *modelComponent) {
   modelComponents[modelComponent->getComponentName()] = modelComponent;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief The profile entry for a visitor's passes, if profiling
+ *  \return The entry, named for the visitor's class, or NULL if the profiler
+ *          is disabled.
+ */
+profile_entry *Core::visitorProfile(AVisitor *visitor) {
+  if (!profiler.isEnabled()) {
+    return NULL;
+  }
+  return &profiler.entry(boost::core::demangle(typeid(*visitor).name()),
+                         PROFILE_VISIT);
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void Core::accept(AVisitor *visitor) {
@@ -15,14 +15,8 @@
 #include <fstream>
 #include <regex>
 
-// some boost headers generate warnings under clang; not our problem, ignore
-// 2023 and Boost 1.81.0_1: lexical_cast.hpp still generates many warnings
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Weverything"
-#include <boost/lexical_cast.hpp>
-#pragma clang diagnostic pop
-
 #include "bc_component.hpp"
+#include "carbon-cycle-solver.hpp"
 #include "ch4_component.hpp"
 #include "core.hpp"
 #include "csv_outputstream_visitor.hpp"
@@ -48,10 +42,13 @@ using namespace std;
 /*! \brief Constructor
  *  \param outputStream The file to write the csv output to
  *  \param printHeader Boolean controlling whether we print a header or not
+ *  \param background Write output on a background thread, so the model
+ *                    waits on the disk only if it gets well ahead of it
  */
 CSVOutputStreamVisitor::CSVOutputStreamVisitor(ostream &outputStream,
-                                               const bool printHeader)
-    : csvFile(outputStream) {
+                                               const bool printHeader,
+                                               const bool background)
+    : csvFile(outputStream), precision(int(outputStream.precision())) {
   if (printHeader) {
 
     // Save the current time (real world not Hector current time) to write out
@@ -72,14 +69,55 @@ CSVOutputStreamVisitor::CSVOutputStreamVisitor(ostream &outputStream,
   }
   run_name = "";
   current_date = 0;
-  datestring = "";
-  spinupstring = "";
+  in_spinup = false;
+  set_linestamp(current_date);
+
+  if (background) {
+    writer.reset(new AsyncWriter(csvFile));
+  }
 }
 
 //------------------------------------------------------------------------------
 /*! \brief Destructor
+ *
+ *  Writes out anything still buffered.
  */
-CSVOutputStreamVisitor::~CSVOutputStreamVisitor() {}
+CSVOutputStreamVisitor::~CSVOutputStreamVisitor() {
+  // A destructor mustn't throw; call flush() first to see write errors
+  try {
+    flush();
+  } catch (...) {
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Write out all buffered lines and flush the output stream
+ *
+ *  Lines are collected in memory and written in large blocks; call this at
+ *  the end of a run (it is also called on destruction).
+ *
+ *  \exception h_exception If output couldn't be written.
+ */
+void CSVOutputStreamVisitor::flush() {
+  write_buffer();
+  if (writer) {
+    writer->flush();
+  } else {
+    csvFile.flush();
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Hand the buffered lines to the stream, or to the background writer
+ */
+void CSVOutputStreamVisitor::write_buffer() {
+  if (writer) {
+    writer->write(buffer);
+  } else {
+    csvFile.write(buffer.data(), buffer.size());
+    buffer.clear();
+  }
+}
 
 //------------------------------------------------------------------------------
 // documentation is inherited
@@ -87,19 +125,49 @@ bool CSVOutputStreamVisitor::shouldVisit(const bool is, const double date) {
 
   current_date = date;
   in_spinup = is;
-  datestring = boost::lexical_cast<string>(date);
-  spinupstring = boost::lexical_cast<string>(in_spinup);
+  set_linestamp(date);
 
   // visit all model periods
   return true;
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Return text that starts every output line
+/*! \brief Set the text that starts every output line for a date
+ */
+void CSVOutputStreamVisitor::set_linestamp(const double date) {
+  linestamp.clear();
+  append_number(linestamp, date, 17); // as boost::lexical_cast would
+  linestamp += DELIMITER;
+  linestamp += run_name;
+  linestamp += DELIMITER;
+  linestamp += in_spinup ? "1" : "0";
+  linestamp += DELIMITER;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Buffer one output line
+ *  \param component Component name
+ *  \param var Variable name
+ *  \param x Value, written with the current precision
+ *
+ *  Lines are formatted here and the stream's own state is never used, since
+ *  a background writer may be writing to it.
  */
-std::string CSVOutputStreamVisitor::linestamp() {
-  return (datestring + DELIMITER + run_name + DELIMITER + spinupstring +
-          DELIMITER);
+void CSVOutputStreamVisitor::write_line(const string &component,
+                                        const string &var, const unitval &x) {
+  buffer += linestamp;
+  buffer += component;
+  buffer += DELIMITER;
+  buffer += var;
+  buffer += DELIMITER;
+  append_number(buffer, x.value(x.units()), precision);
+  buffer += DELIMITER;
+  buffer += x.unitsName();
+  buffer += '\n';
+
+  if (buffer.size() >= OUTPUT_BUFFER_SIZE) {
+    write_buffer();
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -107,38 +175,31 @@ std::string CSVOutputStreamVisitor::linestamp() {
 void CSVOutputStreamVisitor::visit(Core *c) {
   run_name = c->getRun_name();
   core = c;
+  set_linestamp(current_date);
 }
 
 // TODO: consolidate these macros into the two MESSAGE ones,
 // and shift string literals to D_xxxx definitions
 
-// Macro to send a variable with associated unitval units to some output stream
-// Takes s (stream), c (component), xname (variable name), x (output variable)
-#define STREAM_UNITVAL(s, c, xname, x)                                         \
-  {                                                                            \
-    s << linestamp() << c->getComponentName() << DELIMITER << xname            \
-      << DELIMITER << x.value(x.units()) << DELIMITER << x.unitsName()         \
-      << std::endl;                                                            \
-  }
+// Macro to send a variable with associated unitval units to the output
+// Takes c (component), xname (variable name), x (output variable)
+#define STREAM_UNITVAL(c, xname, x)                                            \
+  { write_line(c->getComponentName(), xname, x); }
 
-// Macro to send a variable with associated unitval units to some output stream
+// Macro to send a variable with associated unitval units to the output
 // This uses new sendMessage interface in imodel_component
-// Takes s (stream), c (component), xname (variable name)
-#define STREAM_MESSAGE(s, c, xname)                                            \
+// Takes c (component), xname (variable name)
+#define STREAM_MESSAGE(c, xname)                                               \
   {                                                                            \
-    unitval x = c->sendMessage(M_GETDATA, xname);                              \
-    s << linestamp() << c->getComponentName() << DELIMITER << xname            \
-      << DELIMITER << x.value(x.units()) << DELIMITER << x.unitsName()         \
-      << std::endl;                                                            \
+    write_line(c->getComponentName(), xname,                                   \
+               c->sendMessage(M_GETDATA, xname));                              \
   }
 // Macro for date-dependent variables
-// Takes s (stream), c (component), xname (variable name), date
-#define STREAM_MESSAGE_DATE(s, c, xname, date)                                 \
+// Takes c (component), xname (variable name), date
+#define STREAM_MESSAGE_DATE(c, xname, date)                                    \
   {                                                                            \
-    unitval x = c->sendMessage(M_GETDATA, xname, message_data(date));          \
-    s << linestamp() << c->getComponentName() << DELIMITER << xname            \
-      << DELIMITER << x.value(x.units()) << DELIMITER << x.unitsName()         \
-      << std::endl;                                                            \
+    write_line(c->getComponentName(), xname,                                   \
+               c->sendMessage(M_GETDATA, xname, message_data(date)));          \
   }
 
 //------------------------------------------------------------------------------
@@ -146,19 +207,39 @@ void CSVOutputStreamVisitor::visit(Core *c) {
 void CSVOutputStreamVisitor::visit(ForcingComponent *c) {
   if (!core->outputEnabled(c->getComponentName()))
     return;
-  streamsize oldPrecision = csvFile.precision(4);
+  const int oldPrecision = precision;
+  precision = FORCING_PRECISION;
 
+  // NB precision is deliberately left at FORCING_PRECISION here; the output
+  // has always been written that way from the first year before the base
+  // year on
   if (c->currentYear < c->baseyear)
     return;
 
-  ForcingComponent::forcings_t forcings = c->forcings_ts.get(c->currentYear);
+  const ForcingComponent::forcings_t &forcings =
+      c->forcings_ts.get(c->currentYear);
 
-  // Walk through the forcings map, outputting everything
-  for (auto f : forcings) {
-    STREAM_UNITVAL(csvFile, c, f.first, f.second);
+  // Walk through the forcings table, outputting everything present
+  for (int i = 0; i < ForcingComponent::N_FORCINGS; ++i) {
+    if (forcings.present[i]) {
+      STREAM_UNITVAL(c, ForcingComponent::forcing_names[i],
+                     unitval(forcings.value[i], U_W_M2));
+    }
   }
 
-  csvFile.precision(oldPrecision);
+  precision = oldPrecision;
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void CSVOutputStreamVisitor::visit(CarbonCycleSolver *c) {
+  if (!core->outputEnabled(c->getComponentName()))
+    return;
+  STREAM_MESSAGE(c, D_SOLVER_RHS_EVALS);
+  STREAM_MESSAGE(c, D_SOLVER_ACCEPTED_STEPS);
+  STREAM_MESSAGE(c, D_SOLVER_REJECTED_STEPS);
+  STREAM_MESSAGE(c, D_SOLVER_RETRIES);
+  STREAM_MESSAGE(c, D_SOLVER_FINAL_DT);
 }
 
 //------------------------------------------------------------------------------
@@ -170,47 +251,47 @@ void CSVOutputStreamVisitor::visit(SimpleNbox *c) {
   // Global outputs
   // Note if there are multiple biomes, these values will be totals, summed
   // across all biomes
-  STREAM_MESSAGE(csvFile, c, D_NBP);
-  STREAM_UNITVAL(csvFile, c, D_NPP, c->final_npp[SNBOX_DEFAULT_BIOME]);
-  STREAM_UNITVAL(csvFile, c, D_RH, c->final_rh[SNBOX_DEFAULT_BIOME]);
-  STREAM_UNITVAL(csvFile, c, D_RH_CH4, c->final_rh[SNBOX_DEFAULT_BIOME]);
-  STREAM_MESSAGE_DATE(csvFile, c, D_CO2_CONC, current_date);
-  STREAM_MESSAGE(csvFile, c, D_ATMOSPHERIC_CO2);
-  STREAM_MESSAGE(csvFile, c, D_ATMOSPHERIC_C_RESIDUAL);
-  STREAM_MESSAGE(csvFile, c, D_VEGC);
-  STREAM_MESSAGE(csvFile, c, D_DETRITUSC);
-  STREAM_MESSAGE(csvFile, c, D_SOILC);
-  STREAM_MESSAGE(csvFile, c, D_PERMAFROSTC);
-  STREAM_MESSAGE(csvFile, c, D_THAWEDPC);
-  STREAM_MESSAGE(csvFile, c, D_F_FROZEN);
-  STREAM_MESSAGE(csvFile, c, D_EARTHC);
+  STREAM_MESSAGE(c, D_NBP);
+  STREAM_UNITVAL(c, D_NPP, c->final_npp[SNBOX_DEFAULT_BIOME]);
+  STREAM_UNITVAL(c, D_RH, c->final_rh[SNBOX_DEFAULT_BIOME]);
+  STREAM_UNITVAL(c, D_RH_CH4, c->final_rh[SNBOX_DEFAULT_BIOME]);
+  STREAM_MESSAGE_DATE(c, D_CO2_CONC, current_date);
+  STREAM_MESSAGE(c, D_ATMOSPHERIC_CO2);
+  STREAM_MESSAGE(c, D_ATMOSPHERIC_C_RESIDUAL);
+  STREAM_MESSAGE(c, D_VEGC);
+  STREAM_MESSAGE(c, D_DETRITUSC);
+  STREAM_MESSAGE(c, D_SOILC);
+  STREAM_MESSAGE(c, D_PERMAFROSTC);
+  STREAM_MESSAGE(c, D_THAWEDPC);
+  STREAM_MESSAGE(c, D_F_FROZEN);
+  STREAM_MESSAGE(c, D_EARTHC);
 
   // Biome-specific outputs: <biome>.<variable>
   if (c->veg_c.size() > 1) {
     SimpleNbox::fluxpool_stringmap::const_iterator it;
     for (auto b : c->veg_c) {
       std::string biome = b.first;
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_NPP,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_NPP,
                      c->final_npp[biome]);
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_RH,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_RH,
                      c->final_rh[biome]);
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_RH_CH4,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_RH_CH4,
                      c->RH_ch4[biome]);
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_VEGC,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_VEGC,
                      c->veg_c[biome]);
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_DETRITUSC,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_DETRITUSC,
                      c->detritus_c[biome]);
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_SOILC,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_SOILC,
                      c->soil_c[biome]);
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_PERMAFROSTC,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_PERMAFROSTC,
                      c->permafrost_c[biome]);
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_THAWEDPC,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_THAWEDPC,
                      c->thawed_permafrost_c[biome]);
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_F_FROZEN,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_F_FROZEN,
                      unitval(c->f_frozen[biome], U_UNITLESS));
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_TEMPFERTD,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_TEMPFERTD,
                      unitval(c->tempfertd[biome], U_UNITLESS));
-      STREAM_UNITVAL(csvFile, c, biome + SNBOX_PARSECHAR + D_TEMPFERTS,
+      STREAM_UNITVAL(c, biome + SNBOX_PARSECHAR + D_TEMPFERTS,
                      unitval(c->tempferts[biome], U_UNITLESS));
     }
   }
@@ -222,7 +303,7 @@ void CSVOutputStreamVisitor::visit(HalocarbonComponent *c) {
   // TODO: how to get emissions in the gas specific units?
   if (!core->outputEnabled(c->getComponentName()))
     return;
-  STREAM_MESSAGE(csvFile, c, D_HC_CONCENTRATION);
+  STREAM_MESSAGE(c, D_HC_CONCENTRATION);
 }
 
 //------------------------------------------------------------------------------
@@ -230,12 +311,12 @@ void CSVOutputStreamVisitor::visit(HalocarbonComponent *c) {
 void CSVOutputStreamVisitor::visit(TemperatureComponent *c) {
   if (!core->outputEnabled(c->getComponentName()))
     return;
-  STREAM_MESSAGE(csvFile, c, D_GLOBAL_TAS);
-  STREAM_MESSAGE(csvFile, c, D_FLUX_MIXED);
-  STREAM_MESSAGE(csvFile, c, D_FLUX_INTERIOR)
-  STREAM_MESSAGE(csvFile, c, D_HEAT_FLUX);
-  STREAM_MESSAGE(csvFile, c, D_LAND_TAS);
-  STREAM_MESSAGE(csvFile, c, D_SST);
+  STREAM_MESSAGE(c, D_GLOBAL_TAS);
+  STREAM_MESSAGE(c, D_FLUX_MIXED);
+  STREAM_MESSAGE(c, D_FLUX_INTERIOR)
+  STREAM_MESSAGE(c, D_HEAT_FLUX);
+  STREAM_MESSAGE(c, D_LAND_TAS);
+  STREAM_MESSAGE(c, D_SST);
 }
 
 //------------------------------------------------------------------------------
@@ -243,33 +324,34 @@ void CSVOutputStreamVisitor::visit(TemperatureComponent *c) {
 void CSVOutputStreamVisitor::visit(OceanComponent *c) {
   if (!core->outputEnabled(c->getComponentName()))
     return;
-  STREAM_MESSAGE(csvFile, c, D_ATM_OCEAN_FLUX_HL);
-  STREAM_MESSAGE(csvFile, c, D_ATM_OCEAN_FLUX_LL);
-  STREAM_MESSAGE(csvFile, c, D_CARBON_DO);
-  STREAM_MESSAGE(csvFile, c, D_CARBON_HL);
-  STREAM_MESSAGE(csvFile, c, D_CARBON_IO);
-  STREAM_MESSAGE(csvFile, c, D_CARBON_LL);
-  STREAM_MESSAGE(csvFile, c, D_DIC_HL);
-  STREAM_MESSAGE(csvFile, c, D_DIC_LL);
-  STREAM_MESSAGE(csvFile, c, D_HL_DO);
-  STREAM_MESSAGE(csvFile, c, D_OCEAN_C_UPTAKE);
-  STREAM_MESSAGE(csvFile, c, D_OMEGAAR_HL);
-  STREAM_MESSAGE(csvFile, c, D_OMEGAAR_LL);
-  STREAM_MESSAGE(csvFile, c, D_OMEGACA_HL);
-  STREAM_MESSAGE(csvFile, c, D_OMEGACA_LL);
-  STREAM_MESSAGE(csvFile, c, D_PCO2_HL);
-  STREAM_MESSAGE(csvFile, c, D_PCO2_LL);
-  STREAM_MESSAGE(csvFile, c, D_PH_HL);
-  STREAM_MESSAGE(csvFile, c, D_PH_LL);
-  STREAM_MESSAGE(csvFile, c, D_TEMP_HL);
-  STREAM_MESSAGE(csvFile, c, D_TEMP_LL);
-  STREAM_MESSAGE(csvFile, c, D_OCEAN_C);
-  STREAM_MESSAGE(csvFile, c, D_CO3_HL);
-  STREAM_MESSAGE(csvFile, c, D_CO3_LL);
+  STREAM_MESSAGE(c, D_ATM_OCEAN_FLUX_HL);
+  STREAM_MESSAGE(c, D_ATM_OCEAN_FLUX_LL);
+  STREAM_MESSAGE(c, D_CARBON_DO);
+  STREAM_MESSAGE(c, D_CARBON_HL);
+  STREAM_MESSAGE(c, D_CARBON_IO);
+  STREAM_MESSAGE(c, D_CARBON_LL);
+  STREAM_MESSAGE(c, D_DIC_HL);
+  STREAM_MESSAGE(c, D_DIC_LL);
+  STREAM_MESSAGE(c, D_HL_DO);
+  STREAM_MESSAGE(c, D_OCEAN_C_UPTAKE);
+  STREAM_MESSAGE(c, D_OMEGAAR_HL);
+  STREAM_MESSAGE(c, D_OMEGAAR_LL);
+  STREAM_MESSAGE(c, D_OMEGACA_HL);
+  STREAM_MESSAGE(c, D_OMEGACA_LL);
+  STREAM_MESSAGE(c, D_PCO2_HL);
+  STREAM_MESSAGE(c, D_PCO2_LL);
+  STREAM_MESSAGE(c, D_PH_HL);
+  STREAM_MESSAGE(c, D_PH_LL);
+  STREAM_MESSAGE(c, D_TEMP_HL);
+  STREAM_MESSAGE(c, D_TEMP_LL);
+  STREAM_MESSAGE(c, D_OCEAN_C);
+  STREAM_MESSAGE(c, D_CO3_HL);
+  STREAM_MESSAGE(c, D_CO3_LL);
   if (!in_spinup) {
-    STREAM_MESSAGE(csvFile, c, D_REVELLE_HL);
-    STREAM_MESSAGE(csvFile, c, D_REVELLE_LL);
+    STREAM_MESSAGE(c, D_REVELLE_HL);
+    STREAM_MESSAGE(c, D_REVELLE_LL);
   }
+  STREAM_MESSAGE(c, D_OCEAN_MAX_TIMESTEP);
 }
 
 //------------------------------------------------------------------------------
@@ -278,22 +360,20 @@ void CSVOutputStreamVisitor::visit(slrComponent *c) {
   if (!core->outputEnabled(c->getComponentName()))
     return;
   if (current_date == max(c->refperiod_high, c->normalize_year)) {
-    std::string olddatestring = datestring;
     for (int i = core->getStartDate() + 1; i < current_date; i++) {
       // TODO: this is a hack; need to fool the linestamp routine above
-      datestring =
-          boost::lexical_cast<string>(i); // convert to string and store
-      STREAM_MESSAGE_DATE(csvFile, c, D_SLR, i);
-      STREAM_MESSAGE_DATE(csvFile, c, D_SLR_NO_ICE, i);
+      set_linestamp(i);
+      STREAM_MESSAGE_DATE(c, D_SLR, i);
+      STREAM_MESSAGE_DATE(c, D_SLR_NO_ICE, i);
     }
-    datestring = olddatestring;
+    set_linestamp(current_date);
   }
   if (current_date >=
       max(c->refperiod_high, c->normalize_year)) { // output all previous years
-    STREAM_MESSAGE_DATE(csvFile, c, D_SL_RC, current_date);
-    STREAM_MESSAGE_DATE(csvFile, c, D_SLR, current_date);
-    STREAM_MESSAGE_DATE(csvFile, c, D_SL_RC_NO_ICE, current_date);
-    STREAM_MESSAGE_DATE(csvFile, c, D_SLR_NO_ICE, current_date);
+    STREAM_MESSAGE_DATE(c, D_SL_RC, current_date);
+    STREAM_MESSAGE_DATE(c, D_SLR, current_date);
+    STREAM_MESSAGE_DATE(c, D_SL_RC_NO_ICE, current_date);
+    STREAM_MESSAGE_DATE(c, D_SLR_NO_ICE, current_date);
   }
 }
 
@@ -316,7 +396,7 @@ void CSVOutputStreamVisitor::visit(OrganicCarbonComponent *c) {
 void CSVOutputStreamVisitor::visit(OzoneComponent *c) {
   if (!core->outputEnabled(c->getComponentName()))
     return;
-  STREAM_MESSAGE_DATE(csvFile, c, D_ATMOSPHERIC_O3, current_date);
+  STREAM_MESSAGE_DATE(c, D_ATMOSPHERIC_O3, current_date);
 }
 
 //------------------------------------------------------------------------------
@@ -324,7 +404,7 @@ void CSVOutputStreamVisitor::visit(OzoneComponent *c) {
 void CSVOutputStreamVisitor::visit(OHComponent *c) {
   if (!core->outputEnabled(c->getComponentName()))
     return;
-  STREAM_MESSAGE_DATE(csvFile, c, D_LIFETIME_OH, current_date);
+  STREAM_MESSAGE_DATE(c, D_LIFETIME_OH, current_date);
 }
 
 //------------------------------------------------------------------------------
@@ -332,7 +412,7 @@ void CSVOutputStreamVisitor::visit(OHComponent *c) {
 void CSVOutputStreamVisitor::visit(CH4Component *c) {
   if (!core->outputEnabled(c->getComponentName()))
     return;
-  STREAM_MESSAGE_DATE(csvFile, c, D_CH4_CONC, current_date);
+  STREAM_MESSAGE_DATE(c, D_CH4_CONC, current_date);
 }
 
 //------------------------------------------------------------------------------
@@ -340,7 +420,7 @@ void CSVOutputStreamVisitor::visit(CH4Component *c) {
 void CSVOutputStreamVisitor::visit(N2OComponent *c) {
   if (!core->outputEnabled(c->getComponentName()))
     return;
-  STREAM_MESSAGE_DATE(csvFile, c, D_N2O_CONC, current_date);
+  STREAM_MESSAGE_DATE(c, D_N2O_CONC, current_date);
 }
 
 } // namespace Hector
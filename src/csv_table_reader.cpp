@@ -12,8 +12,22 @@
  *
  */
 
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <vector>
 
+// Use std::from_chars to convert numbers where the standard library has it
+// for doubles; otherwise fall back to strtod. The R package (see Makevars)
+// and the standalone build are both C++17, so only standard libraries
+// without floating-point from_chars (e.g. libstdc++ before GCC 11) fall back.
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
 // some boost headers generate warnings under clang; not our problem, ignore
 // 2023 and Boost 1.81.0_1: lexical_cast.hpp still generates many warnings
 #pragma clang diagnostic push
@@ -21,34 +35,89 @@
 #include <boost/lexical_cast.hpp>
 #pragma clang diagnostic pop
 
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/trim.hpp>
-#include <errno.h>
+#include <boost/algorithm/string/join.hpp>
 
 #include "core.hpp"
 #include "csv_table_reader.hpp"
+#include "h_util.hpp"
 #include "message_data.hpp"
 
 namespace Hector {
 
 using namespace std;
 
+//! A [begin, end) piece of the file, e.g. one line or one cell
+typedef pair<const char *, const char *> text_span;
+
+//------------------------------------------------------------------------------
+/*! \brief Remove white space (including any \\r) from both ends of a span
+ */
+static text_span trim_span(const char *b, const char *e) {
+  while (b < e && isspace(static_cast<unsigned char>(*b)))
+    ++b;
+  while (e > b && isspace(static_cast<unsigned char>(e[-1])))
+    --e;
+  return text_span(b, e);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Split a line at commas into trimmed cells
+ */
+static void split_cells(const char *b, const char *e,
+                        vector<text_span> &cells) {
+  cells.clear();
+  for (;;) {
+    const char *comma = static_cast<const char *>(memchr(b, ',', e - b));
+    if (!comma) {
+      cells.push_back(trim_span(b, e));
+      return;
+    }
+    cells.push_back(trim_span(b, comma));
+    b = comma + 1;
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Convert a whole (trimmed, non-empty) cell to a double
+ *  \returns false if the cell isn't entirely a number
+ */
+static bool parse_double(const text_span &cell, double &value) {
+  const char *b = cell.first;
+  const char *e = cell.second;
+  // from_chars rejects a leading plus sign, which the lexical_cast this
+  // replaced accepted, so skip one (but not a sign after it).
+  if (b < e && *b == '+') {
+    ++b;
+    if (b < e && *b == '-')
+      return false;
+  }
+  if (b == e) {
+    return false;
+  }
+#ifdef __cpp_lib_to_chars
+  const from_chars_result result = from_chars(b, e, value);
+  return result.ec == errc() && result.ptr == e;
+#else
+  const string str(b, e);
+  char *str_end;
+  errno = 0;
+  value = strtod(str.c_str(), &str_end);
+  return errno == 0 && str_end == str.c_str() + str.size();
+#endif
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Constructor
  *
- *  Attempts to open the given file name.
+ *  Checks that the given file can be opened; it is read on the first call to
+ *  process.
  *
  *  \param fileName The name of a csv file to read from.
  *  \exception h_exception If there were errors when opening the file.
  */
 CSVTableReader::CSVTableReader(const string &fileName) : fileName(fileName) {
-  // allow exceptions from bad io operations
-  tableInputStream.exceptions(ifstream::failbit | ifstream::badbit);
-
-  try {
-    // attempt to open the file
-    tableInputStream.open(fileName.c_str());
-  } catch (ifstream::failure e) {
+  ifstream test(fileName.c_str());
+  if (!test) {
     // the macro errno in combination with strerror seem to be much more
     // informative than error message from the exception
     string errorStr =
@@ -56,145 +125,200 @@ CSVTableReader::CSVTableReader(const string &fileName) : fileName(fileName) {
     H_THROW(errorStr);
   }
   lineNum = 0;
+  loaded = false;
 }
 
 //------------------------------------------------------------------------------
 /*! \brief Destructor
- *
- *  Closes the input stream.
  */
-CSVTableReader::~CSVTableReader() {
-  try {
-    tableInputStream.close();
-  } catch (ifstream::failure e) {
-    // ignoring close errors
-  }
-}
+CSVTableReader::~CSVTableReader() {}
 
 //------------------------------------------------------------------------------
-/*! \brief Helper function
+/*! \brief Read and parse the whole table
+ *
+ *  The file is mapped into memory and tokenized in place; numbers are
+ *  converted straight from the file's text.  Lines starting with a semicolon
+ *  or hash are comments, and blank lines are skipped.  The first remaining
+ *  line is the header and gives the column names.  Each following row is
+ *  either a UNITS row, whose labels are kept to apply to the data rows after
+ *  it, or a data row, whose first column is the index and whose other cells
+ *  are converted to numbers.  Blank cells are skipped when the table is
+ *  processed; cells that aren't numbers are only an error if their column is
+ *  requested.  Extra white space is removed from every cell.
  *
- *  Get the next line that doesn't start with a semicolon.
+ *  \exception h_exception For any I/O errors, a missing header or an index
+ *  that isn't a number.
  */
-string CSVTableReader::csv_getline() {
-  string s;
-  bool semicolon = true;
-  bool hash = true;
-
-  while ((semicolon || hash) && !tableInputStream.eof() &&
-         tableInputStream.peek() != -1) {
-    getline(tableInputStream, s); // TODO: this depends on Unix line endings
+void CSVTableReader::load() {
+  header.clear();
+  index.clear();
+  values.clear();
+  states.clear();
+  bad_cells.clear();
+  units_rows.clear();
+
+  const mapped_file file(fileName);
+  const char *pos = file.begin();
+  const char *const end = file.end();
+  vector<text_span> cells;
+  lineNum = 0;
+
+  while (pos < end) {
+    const char *eol = static_cast<const char *>(memchr(pos, '\n', end - pos));
+    if (!eol) {
+      eol = end;
+    }
+    const char *line = pos;
+    pos = eol + 1;
     ++lineNum;
-    semicolon = s[0] == ';';
-    hash = s[0] == '#';
+
+    // Skip comments, and blank lines. A stray windows line ending which may
+    // have made its way in from a mixed line ending file is blank as well.
+    if (line < eol && (*line == ';' || *line == '#')) {
+      continue;
+    }
+    const text_span trimmed = trim_span(line, eol);
+    if (trimmed.first == trimmed.second) {
+      continue;
+    }
+
+    split_cells(line, eol, cells);
+
+    if (header.empty()) {
+      // the header line; the first column is the index column
+      for (size_t col = 0; col < cells.size(); ++col) {
+        header.push_back(string(cells[col].first, cells[col].second));
+      }
+      values.resize(header.size());
+      states.resize(header.size());
+      continue;
+    }
+
+    if (string(cells[0].first, cells[0].second) == "UNITS") {
+      // this row of the table is specifying units for all columns
+      vector<string> labels;
+      for (size_t col = 0; col < cells.size(); ++col) {
+        labels.push_back(string(cells[col].first, cells[col].second));
+      }
+      units_rows.push_back(make_pair(index.size(), labels));
+      continue;
+    }
+
+    // this row is a regular row of data
+    // the first column is assumed to be the index
+    double date;
+    if (!parse_double(cells[0], date)) {
+      H_THROW("Could not convert index to double on line: " +
+              boost::lexical_cast<string>(lineNum) + ", value: " +
+              string(cells[0].first, cells[0].second));
+    }
+    index.push_back(date);
+    const size_t r = index.size() - 1;
+
+    for (size_t col = 1; col < header.size(); ++col) {
+      double value = 0.0;
+      char state = CELL_BLANK;
+      if (col < cells.size() && cells[col].first != cells[col].second) {
+        if (parse_double(cells[col], value)) {
+          state = CELL_VALUE;
+        } else {
+          state = CELL_BAD;
+          bad_cells[make_pair(col, r)] =
+              string(cells[col].first, cells[col].second);
+        }
+      }
+      values[col].push_back(value);
+      states[col].push_back(state);
+    }
   }
-  return s;
+
+  H_ASSERT(!header.empty(), "no header line in " + fileName);
+  loaded = true;
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Process the CSV file looking for the given varName and route the data
- *         into the core.
+/*! \brief Route the column for the given varName into the core.
  *
- *  The input stream will be reset to allow to processing multiple times from
- *  this reader.  Next the header row is read and searched to find the column
- *  which varName is contained in.  Then each row of the table is read.  Should
- * the the first column be UNITS it will use the row to set the units string to
- * pass along with read data to provide units checking.  Otherwise it will
- * assume the first column is the time series index and consistent columns for
- * each row. Each value will be routed through the core as rows are read.  Extra
- *  white space will be removed before sending the value into the core.
+ *  The table is read and parsed on the first call (see load()); later calls,
+ *  for this or other variables, are served from memory.  The header is
+ *  searched to find the column which varName is contained in, and each
+ *  non-blank value in it is routed through the core with its index as the
+ *  date.  Units come from the most recent UNITS row above the value, if
+ *  any, and are checked by the receiving component.
  *
  *  \param core A pointer to the model core to route data through.
  *  \param componentName The model component to set varName in.
  *  \param varName The variable name to look for in the CSV file and set.
  *  \exception h_exception For any I/O errors, improper formatting, and
- * inability to find varName.  Also any errors while trying to setData will also
- * be propagated.
+ * inability to find varName.  Also any errors while trying to setSeries will
+ * also be propagated.
  */
-
 void CSVTableReader::process(Core *core, const string &componentName,
                              const string &varName) {
-  using namespace boost;
-  try {
-    // reset the stream in case we are re-reading from this stream
-    tableInputStream.clear();
-    tableInputStream.seekg(0, ifstream::beg);
-    lineNum = 0;
-
-    string line;
-    vector<string> row;
-    string unitsLabel;
-    size_t columnIndex = 0; // code for "not found", takes advantage of skipping
-                            // col==0 in the loop below.
-
-    // read the header line and attempt to find varName. The first column is
-    // not considered because that should be the index column.
-    line = csv_getline();
-    H_ASSERT(!line.empty(), "line empty");
-    split(row, line, is_any_of(","));
-    //        const int headerRowSize = row.size();
-    for (size_t col = 1; col < row.size() && columnIndex == 0; ++col) {
-      // ignore white space before comparing variable names
-      trim(row[col]);
-      if (row[col] == varName) {
-        columnIndex = col;
-      }
-    }
-    if (columnIndex == 0) {
-      H_THROW("Could not find a column for " + varName + " in " + fileName +
-              " header=" + line);
+  if (!loaded) {
+    load();
+  }
+
+  // find varName. The first column is not considered because that should be
+  // the index column.
+  size_t columnIndex = 0;
+  for (size_t col = 1; col < header.size() && columnIndex == 0; ++col) {
+    if (header[col] == varName) {
+      columnIndex = col;
     }
+  }
+  if (columnIndex == 0) {
+    H_THROW("Could not find a column for " + varName + " in " + fileName +
+            " header=" + boost::algorithm::join(header, ","));
+  }
 
-    // we are all set to process the table
-    // note that getline sets the fail bit when it hits eof which is not what
-    // want, a work around is to check peek
-    int lines_read = 0;
-    while (!tableInputStream.eof() && tableInputStream.peek() != -1) {
-      // read the next row to process
-      line = csv_getline();
-      lines_read++;
-
-      // Ignore blank lines. A stray windows line ending which may have made
-      // its way in from a mixed line ending file can be skipped as well.
-      if (line.empty() || line[0] == '\r') {
-        continue;
-      }
+  const vector<double> &column = values[columnIndex];
+  const vector<char> &state = states[columnIndex];
+  unit_types units = U_UNDEFINED;
+  size_t next_units = 0;
 
-      split(row, line, is_any_of(","));
-
-      // remove extra white space from the table value
-      trim(row[0]);
-      trim(row[columnIndex]);
-
-      if (row[0] == "UNITS") {
-        // this row of the table is specifying units for all columns
-        // we only need to keep track of the value for the column of interest
-        unitsLabel = row[columnIndex];
-      } else {
-        // this row is a regular row of data
-        // the first column is assumed to be the index
-        double tseriesIndex = lexical_cast<double>(row[0]);
-
-        // route the data to the appropriate model component
-        if (!row[columnIndex].empty()) { // ignore blanks
-          message_data data(row[columnIndex]);
-          data.date = tseriesIndex;
-          data.units_str = unitsLabel;
-          core->setData(componentName, varName, data);
-        }
+  // the values are passed along a series at a time, a new series starting
+  // whenever the units change
+  vector<double> dates;
+  vector<double> series;
+  dates.reserve(index.size());
+  series.reserve(index.size());
+
+  for (size_t r = 0; r < index.size(); ++r) {
+    // pick up units from any UNITS row above this one
+    while (next_units < units_rows.size() &&
+           units_rows[next_units].first <= r) {
+      const vector<string> &labels = units_rows[next_units].second;
+      const string label =
+          columnIndex < labels.size() ? labels[columnIndex] : string();
+      const unit_types new_units =
+          label.empty() ? U_UNDEFINED : unitval::parseUnitsName(label);
+      if (new_units != units && !dates.empty()) {
+        core->setSeries(componentName, varName, dates, series, units);
+        dates.clear();
+        series.clear();
       }
+      units = new_units;
+      ++next_units;
     }
 
-  } catch (ifstream::failure e) {
-    string errorStr = "I/O exception while processing " + fileName +
-                      " error: " + strerror(errno);
-    H_THROW(errorStr);
-  } catch (bad_lexical_cast &castException) {
-    H_THROW("Could not convert index to double on line: " +
-            lexical_cast<string>(lineNum) +
-            ", exception: " + castException.what());
+    if (state[r] == CELL_BLANK) { // ignore blanks
+      continue;
+    } else if (state[r] == CELL_BAD) {
+      H_THROW("Could not convert value " +
+              bad_cells[make_pair(columnIndex, r)] + " for " + varName +
+              " in " + fileName);
+    }
+
+    dates.push_back(index[r]);
+    series.push_back(column[r]);
+  }
+
+  // route the data to the appropriate model component
+  if (!dates.empty()) {
+    core->setSeries(componentName, varName, dates, series, units);
   }
-  // h_exceptions from setData should just be passed along
+  // h_exceptions from setSeries should just be passed along
 }
 
 } // namespace Hector
@@ -14,13 +14,6 @@
 
 #include <fstream>
 
-// some boost headers generate warnings under clang; not our problem, ignore
-// 2023 and Boost 1.81.0_1: lexical_cast.hpp still generates many warnings
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Weverything"
-#include <boost/lexical_cast.hpp>
-#pragma clang diagnostic pop
-
 #include "core.hpp"
 #include "csv_tracking_visitor.hpp"
 #include "h_util.hpp"
@@ -36,31 +29,57 @@ using namespace std;
 /*! \brief Constructor
  *  \param outputStream The file to write the csv output to
  *  \param printHeader Boolean controlling whether we print a header or not
+ *  \param streaming Write each year out as soon as it's complete, rather
+ *                   than holding everything until destruction; the visitor
+ *                   can then only be reset to a date not yet written
+ *  \param background Write output on a background thread, so the model
+ *                    waits on the disk only if it gets well ahead of it
  */
 CSVFluxPoolVisitor::CSVFluxPoolVisitor(ostream &outputStream,
-                                       const bool printHeader)
-    : csvFile(outputStream) {
-  stringstream hdr;
+                                       const bool printHeader,
+                                       const bool streaming,
+                                       const bool background)
+    : csvFile(outputStream), streaming(streaming), written(false),
+      written_date(-1), current_date(0), tracking_date(0), core(NULL) {
   if (printHeader) {
     // Store table header
-    hdr << "year" << DELIMITER << "component" << DELIMITER << "pool_name"
-        << DELIMITER << "pool_value" << DELIMITER << "pool_units" << DELIMITER
-        << "source_name" << DELIMITER << "source_fraction" << endl;
+    header = string("year") + DELIMITER + "component" + DELIMITER +
+             "pool_name" + DELIMITER + "pool_value" + DELIMITER +
+             "pool_units" + DELIMITER + "source_name" + DELIMITER +
+             "source_fraction" + "\n";
+  }
+
+  if (background) {
+    writer.reset(new AsyncWriter(csvFile));
   }
-  header = hdr.str();
 }
 
 //------------------------------------------------------------------------------
 /*! \brief Destructor
  */
 CSVFluxPoolVisitor::~CSVFluxPoolVisitor() {
-  // Write out the buffer to the csv file before closing down
+  // Write out the buffer to the csv file before closing down. A destructor
+  // mustn't throw; call flush() first to see write errors
+  try {
+    flush();
+  } catch (...) {
+  }
+}
 
-  if (csvBuffer.size()) {
-    csvFile << header; // the header (or an empty string)
-    for (double yr = csvBuffer.firstdate(); yr <= csvBuffer.lastdate(); yr++) {
-      csvFile << csvBuffer.get(yr);
-    }
+//------------------------------------------------------------------------------
+/*! \brief Write out all held records and flush the output stream
+ *
+ *  Nothing can be reset to before the records written; call this at the end
+ *  of a run (it is also called on destruction).
+ *
+ *  \exception h_exception If output couldn't be written.
+ */
+void CSVFluxPoolVisitor::flush() {
+  write_records();
+  if (writer) {
+    writer->flush();
+  } else {
+    csvFile.flush();
   }
 }
 
@@ -68,9 +87,15 @@ CSVFluxPoolVisitor::~CSVFluxPoolVisitor() {
 // documentation is inherited
 bool CSVFluxPoolVisitor::shouldVisit(const bool in_spinup, const double date) {
   current_date = date;
-  datestring = boost::lexical_cast<string>(date);
-  // visit all model periods that are >= the initial tracking date
-  return date >= tracking_date;
+  // once a later year starts, earlier ones are complete
+  if (streaming && !records.empty() && records.back().year < date) {
+    write_records();
+  }
+  // visit all model periods that are >= the initial tracking date, once: a
+  // run resumed (e.g. after a reset) starts by visiting the last date again
+  const bool recorded = date <= written_date ||
+                        (!records.empty() && records.back().year >= date);
+  return date >= tracking_date && !recorded;
 }
 
 //------------------------------------------------------------------------------
@@ -82,22 +107,33 @@ void CSVFluxPoolVisitor::visit(Core *c) {
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Print the sources, and associated fractions, of a fluxpool
+/*! \brief Record the sources, and associated fractions, of a fluxpool
  */
-void CSVFluxPoolVisitor::print_pool(const fluxpool x, const string cname) {
+void CSVFluxPoolVisitor::print_pool(const fluxpool &x, const string &cname) {
   if (x.tracking) {
-    stringstream output;
-    // there might already be "diff" output
-    if (csvBuffer.exists(current_date)) {
-      output << csvBuffer.get(current_date);
+    const pair<string, string> key(cname, x.name);
+    auto p = pool_index.find(key);
+    if (p == pool_index.end()) {
+      const tracking_pool pool = {cname, x.name, x.unitsName()};
+      pools.push_back(pool);
+      p = pool_index.insert(make_pair(key, unsigned(pools.size() - 1))).first;
     }
-    vector<string> sources = x.get_sources();
-    for (auto &s : sources) {
-      output << datestring << DELIMITER << cname << DELIMITER << x.name
-             << DELIMITER << x.value(U_PGC) << DELIMITER << x.unitsName()
-             << DELIMITER << s << DELIMITER << x.get_fraction(s) << endl;
+
+    tracking_record r;
+    r.year = current_date;
+    r.pool = p->second;
+    r.value = x.value(U_PGC);
+    for (auto &s : x.get_sources()) {
+      auto src = source_index.find(s);
+      if (src == source_index.end()) {
+        sources.push_back(s);
+        src = source_index.insert(make_pair(s, unsigned(sources.size() - 1)))
+                  .first;
+      }
+      r.source = src->second;
+      r.fraction = x.get_fraction(s);
+      records.push_back(r);
     }
-    csvBuffer.set(current_date, output.str());
   }
 }
 
@@ -129,29 +165,114 @@ void CSVFluxPoolVisitor::visit(OceanComponent *c) {
 
   const string cname = c->getComponentName();
 
-  print_pool(c->surfaceHL.get_carbon(), cname);
-  print_pool(c->surfaceLL.get_carbon(), cname);
-  print_pool(c->inter.get_carbon(), cname);
-  print_pool(c->deep.get_carbon(), cname);
+  for (size_t i = 0; i < c->boxes.size(); i++) {
+    print_pool(c->boxes[i]->get_carbon(), cname);
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Format records as csv lines
+ *
+ *  Numbers are formatted as a default ostream would (the year as
+ *  boost::lexical_cast would), as this output always has been.
+ */
+void CSVFluxPoolVisitor::format_records(string &out,
+                                        const tracking_record *begin,
+                                        const tracking_record *end) const {
+  for (const tracking_record *r = begin; r != end; ++r) {
+    const tracking_pool &pool = pools[r->pool];
+    append_number(out, r->year, 17);
+    out += DELIMITER;
+    out += pool.component;
+    out += DELIMITER;
+    out += pool.name;
+    out += DELIMITER;
+    append_number(out, r->value, 6);
+    out += DELIMITER;
+    out += pool.units;
+    out += DELIMITER;
+    out += sources[r->source];
+    out += DELIMITER;
+    append_number(out, r->fraction, 6);
+    out += '\n';
+  }
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Assemble the time series strings into the given tracking output
+/*! \brief Write the held records to the csv file (or hand them to the
+ *  background writer), and drop them
+ */
+void CSVFluxPoolVisitor::write_records() {
+  if (records.empty()) {
+    return;
+  }
+
+  if (!written) {
+    buffer += header; // the header (or an empty string)
+    written = true;
+  }
+  format_records(buffer, records.data(), records.data() + records.size());
+  if (writer) {
+    writer->write(buffer);
+  } else {
+    csvFile.write(buffer.data(), buffer.size());
+    buffer.clear();
+  }
+
+  written_date = records.back().year;
+  records.clear();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Assemble the held records into the given tracking output
  * stream. \param tracking_out The output stream to write results into.
  */
 void CSVFluxPoolVisitor::outputTrackingData(ostream &tracking_out) const {
-  if (csvBuffer.size()) {
-    tracking_out << header; // the header (or an empty string)
-    for (double yr = csvBuffer.firstdate(); yr <= csvBuffer.lastdate(); yr++) {
-      tracking_out << csvBuffer.get(yr);
-    }
+  if (records.size()) {
+    string out = header; // the header (or an empty string)
+    format_records(out, records.data(), records.data() + records.size());
+    tracking_out << out;
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Append the held records to the given tracking columns
+ *  \param columns The columns to append to; their pool and source tables are
+ *                 extended with ours.
+ */
+void CSVFluxPoolVisitor::outputTrackingColumns(
+    tracking_columns &columns) const {
+  const unsigned pool_offset = unsigned(columns.pools.size());
+  const unsigned source_offset = unsigned(columns.sources.size());
+  columns.pools.insert(columns.pools.end(), pools.begin(), pools.end());
+  columns.sources.insert(columns.sources.end(), sources.begin(),
+                         sources.end());
+
+  const size_t n = columns.year.size() + records.size();
+  columns.year.reserve(n);
+  columns.pool.reserve(n);
+  columns.pool_value.reserve(n);
+  columns.source.reserve(n);
+  columns.source_fraction.reserve(n);
+  for (const tracking_record &r : records) {
+    columns.year.push_back(r.year);
+    columns.pool.push_back(pool_offset + r.pool);
+    columns.pool_value.push_back(r.value);
+    columns.source.push_back(source_offset + r.source);
+    columns.source_fraction.push_back(r.fraction);
   }
 }
 
 //------------------------------------------------------------------------------
 // documentation is inherited
 void CSVFluxPoolVisitor::reset(const double reset_date) {
-  csvBuffer.truncate(reset_date);
+  H_ASSERT(reset_date >= written_date,
+           "tracking output has already been written past the reset date");
+  vector<tracking_record>::iterator keep = records.begin();
+  while (keep != records.end() && keep->year <= reset_date) {
+    ++keep;
+  }
+  records.erase(keep, records.end());
 }
 
 } // namespace Hector
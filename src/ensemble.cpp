@@ -0,0 +1,139 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  ensemble.cpp
+ *  hector
+ *
+ *  Runs a parameter ensemble on several threads.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
+#include "component_data.hpp"
+#include "core.hpp"
+#include "ensemble.hpp"
+#include "h_exception.hpp"
+#include "logger.hpp"
+#include "message_data.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ *  \param inputs The parsed inputs each member starts from.  They must
+ *                outlive the ensemble and not change while it runs.
+ *  \param parameters The capabilities set for each member.
+ *  \param parameterUnits The units of each parameter's values.
+ *  \param vars The variables to fetch from each member.
+ *  \param dates The dates to fetch them at (Core::undefinedIndex() for
+ *               variables without a date).
+ */
+Ensemble::Ensemble(const ScenarioBundle &inputs,
+                   const vector<string> &parameters,
+                   const vector<unit_types> &parameterUnits,
+                   const vector<string> &vars, const vector<double> &dates)
+    : inputs(inputs), parameters(parameters), parameterUnits(parameterUnits),
+      vars(vars), dates(dates), members(0), have_units(false) {
+  H_ASSERT(parameters.size() == parameterUnits.size(),
+           "need units for each ensemble parameter");
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Run the ensemble
+ *  \param values The parameter values: a members x parameters matrix in
+ *                column-major order, so member m's value for parameter p is
+ *                values[m + p * members].
+ *  \param members The number of members.
+ *  \param threads The number of threads to run them on; 0 (the default)
+ *                 uses one per hardware thread.
+ *  \exception h_exception If values is the wrong size.  Errors in members
+ *                         are recorded (see getErrors), not thrown.
+ */
+void Ensemble::run(const vector<double> &values, const size_t members,
+                   unsigned threads) {
+  H_ASSERT(values.size() == members * parameters.size(),
+           "need a value for each ensemble member and parameter");
+
+  this->members = members;
+  results.assign(members * vars.size() * dates.size(),
+                 numeric_limits<double>::quiet_NaN());
+  units.assign(vars.size(), U_UNDEFINED);
+  errors.assign(members, "");
+  have_units = false;
+
+  if (threads == 0) {
+    threads = max(thread::hardware_concurrency(), 1u);
+  }
+  threads = unsigned(min(size_t(threads), members));
+
+  // Each worker takes the next member not yet started until none are left
+  atomic<size_t> next(0);
+  auto work = [&]() {
+    for (size_t m = next++; m < members; m = next++) {
+      runMember(values, m);
+    }
+  };
+
+  vector<thread> workers;
+  for (unsigned i = 1; i < threads; ++i) {
+    workers.push_back(thread(work));
+  }
+  work();
+  for (thread &t : workers) {
+    t.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Run one member, storing its results or error
+ *
+ *  Only this member's slots of results and errors are written, so members
+ *  may run concurrently.
+ */
+void Ensemble::runMember(const vector<double> &values, const size_t member) {
+  try {
+    Core core(Logger::SEVERE, false, false);
+    core.init();
+    inputs.apply(&core);
+    for (size_t p = 0; p < parameters.size(); ++p) {
+      core.sendMessage(M_SETDATA, parameters[p],
+                       message_data(unitval(values[member + p * members],
+                                            parameterUnits[p])));
+    }
+    core.prepareToRun();
+    core.run();
+
+    vector<unitval> fetched;
+    core.fetchVars(vars, dates, fetched);
+    vector<double>::iterator out =
+        results.begin() + member * vars.size() * dates.size();
+    for (const unitval &v : fetched) {
+      *out++ = v.value(v.units());
+    }
+
+    lock_guard<mutex> lock(units_mutex);
+    if (!have_units) {
+      for (size_t i = 0; i < vars.size(); ++i) {
+        units[i] = fetched[i * dates.size()].units();
+      }
+      have_units = !dates.empty();
+    }
+  } catch (const exception &e) {
+    errors[member] = e.what();
+    fill(results.begin() + member * vars.size() * dates.size(),
+         results.begin() + (member + 1) * vars.size() * dates.size(),
+         numeric_limits<double>::quiet_NaN());
+  }
+}
+
+} // namespace Hector
@@ -21,12 +21,7 @@
 
  */
 
-// some boost headers generate warnings under clang; not our problem, ignore
-// 2023 and Boost 1.81.0_1: array.hpp still generates one warning
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Weverything"
-#include <boost/array.hpp>
-#pragma clang diagnostic pop
+#include <map>
 #include <math.h>
 
 #include "avisitor.hpp"
@@ -34,25 +29,32 @@
 
 namespace Hector {
 
-/* These next two arrays and the map that connects them are a
- * workaround for the problems created by storing the halocarbon
- * forcings in the halocarbon components.  Because the halocarbon
- * components don't know about the base year adjustments, they can't
- * provide the forcings relative to the base year, which is what
- * outside callers will generally want.  Internally, however, we still
- * need to be able to get the raw forcings from the halocarbon
- * components, so we can't just change everything to point at the
- * forcing component (which would return the base year adjusted value).
+/* The halocarbon forcings are stored in the halocarbon components, which
+ * don't know about the base year adjustments, so they can't provide the
+ * forcings relative to the base year, which is what outside callers will
+ * generally want.  Internally, however, we still need to be able to get
+ * the raw forcings from the halocarbon components, so we can't just
+ * change everything to point at the forcing component (which would return
+ * the base year adjusted value).
  *
- * The solution we adopted was to create a second set of capabilities
- * to refer to the adjusted values, and we let the forcing component
- * intercept those.  However, the forcing values themselves are stored
- * under the names used for the unadjusted values, so we have to have
- * a name translation table so that we can find the data that the
- * message is asking for.  In the end, the whole process winds up
- * being a little ugly, but it gets the job done.
+ * The solution we adopted was to create a second set of capabilities to
+ * refer to the adjusted values, and we let the forcing component intercept
+ * those.  adjusted_halo_forcings[i] is the adjusted value of the forcing in
+ * slot halo_slots[i], whose unadjusted capability is forcing_names[slot].
  */
 
+const char *ForcingComponent::forcing_names[N_FORCINGS] = {
+    D_RF_CH4,       D_RF_BC,        D_RF_C2F6,      D_RF_CCl4,
+    D_RF_CF4,       D_RF_CFC11,     D_RF_CFC113,    D_RF_CFC114,
+    D_RF_CFC115,    D_RF_CFC12,     D_RF_CH3Br,     D_RF_CH3CCl3,
+    D_RF_CH3Cl,     D_RF_CO2,       D_RF_H2O_STRAT, D_RF_HCFC141b,
+    D_RF_HCFC142b,  D_RF_HCFC22,    D_RF_HFC125,    D_RF_HFC134a,
+    D_RF_HFC143a,   D_RF_HFC227ea,  D_RF_HFC23,     D_RF_HFC245fa,
+    D_RF_HFC32,     D_RF_HFC4310,   D_RF_N2O,       D_RF_NH3,
+    D_RF_O3_TROP,   D_RF_OC,        D_RF_SF6,       D_RF_SO2,
+    D_RF_ACI,       D_RF_T_ALBEDO,  D_RF_halon1211, D_RF_halon1301,
+    D_RF_halon2402, D_RF_MISC,      D_RF_TOTAL,     D_RF_VOL};
+
 const char *ForcingComponent::adjusted_halo_forcings[N_HALO_FORCINGS] = {
     D_RFADJ_CF4,      D_RFADJ_C2F6,      D_RFADJ_HFC23,     D_RFADJ_HFC32,
     D_RFADJ_HFC4310,  D_RFADJ_HFC125,    D_RFADJ_HFC134a,   D_RFADJ_HFC143a,
@@ -62,16 +64,14 @@ const char *ForcingComponent::adjusted_halo_forcings[N_HALO_FORCINGS] = {
     D_RFADJ_HCFC142b, D_RFADJ_halon1211, D_RFADJ_halon1301, D_RFADJ_halon2402,
     D_RFADJ_CH3Cl,    D_RFADJ_CH3Br};
 
-const char *ForcingComponent::halo_forcing_names[N_HALO_FORCINGS] = {
-    D_RF_CF4,      D_RF_C2F6,      D_RF_HFC23,     D_RF_HFC32,
-    D_RF_HFC4310,  D_RF_HFC125,    D_RF_HFC134a,   D_RF_HFC143a,
-    D_RF_HFC227ea, D_RF_HFC245fa,  D_RF_SF6,       D_RF_CFC11,
-    D_RF_CFC12,    D_RF_CFC113,    D_RF_CFC114,    D_RF_CFC115,
-    D_RF_CCl4,     D_RF_CH3CCl3,   D_RF_HCFC22,    D_RF_HCFC141b,
-    D_RF_HCFC142b, D_RF_halon1211, D_RF_halon1301, D_RF_halon2402,
-    D_RF_CH3Cl,    D_RF_CH3Br};
-
-std::map<std::string, std::string> ForcingComponent::forcing_name_map;
+const ForcingComponent::forcing_slot
+    ForcingComponent::halo_slots[N_HALO_FORCINGS] = {
+        F_CF4,      F_C2F6,      F_HFC23,     F_HFC32,     F_HFC4310,
+        F_HFC125,   F_HFC134a,   F_HFC143a,   F_HFC227ea,  F_HFC245fa,
+        F_SF6,      F_CFC11,     F_CFC12,     F_CFC113,    F_CFC114,
+        F_CFC115,   F_CCl4,      F_CH3CCl3,   F_HCFC22,    F_HCFC141b,
+        F_HCFC142b, F_halon1211, F_halon1301, F_halon2402, F_CH3Cl,
+        F_CH3Br};
 
 using namespace std;
 
@@ -134,7 +134,6 @@ void ForcingComponent::init(Core *coreptr) {
   core->registerCapability(D_RF_ACI, getComponentName());
   for (int i = 0; i < N_HALO_FORCINGS; ++i) {
     core->registerCapability(adjusted_halo_forcings[i], getComponentName());
-    forcing_name_map[adjusted_halo_forcings[i]] = halo_forcing_names[i];
   }
 
   // Register our dependencies
@@ -254,6 +253,23 @@ void ForcingComponent::setData(const string &varName,
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void ForcingComponent::setSeries(const string &varName,
+                                 const tseries<unitval> &series) {
+  try {
+    if (varName == D_FTOT_CONSTRAIN) {
+      set_series(Ftot_constrain, series, U_W_M2);
+    } else if (varName == D_RF_MISC) {
+      set_series(Fmisc_ts, series, U_W_M2);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void ForcingComponent::prepareToRun() {
@@ -280,7 +296,7 @@ void ForcingComponent::prepareToRun() {
   H_ASSERT(delta_n2o >= -1 && delta_n2o <= 1, "bad delta N2O value");
   H_ASSERT(delta_co2 >= -1 && delta_co2 <= 1, "bad delta CO2 value");
 
-  baseyear_forcings.clear();
+  baseyear_forcings = forcings_t();
 }
 
 //------------------------------------------------------------------------------
@@ -288,7 +304,7 @@ void ForcingComponent::prepareToRun() {
 void ForcingComponent::run(const double runToDate) {
 
   // Calculate instantaneous radiative forcing for any & all agents
-  // As each is computed, push it into 'forcings' map for Ftot calculation.
+  // As each is computed, store it in the 'forcings' table for Ftot calculation.
   // Note that forcings have to be mutually exclusive, there are no subtotals
   // for different species.
   H_LOG(logger, Logger::DEBUG) << "-----------------------------" << std::endl;
@@ -342,7 +358,7 @@ void ForcingComponent::run(const double runToDate) {
       }
       double sarf_co2 = (alpha_prime + n2o_alpha) * log(CO2_conc / C0);
       double fco2 = (sarf_co2 * delta_co2) + sarf_co2;
-      forcings[D_RF_CO2].set(fco2, U_W_M2);
+      forcings.set(F_CO2, fco2);
 
       // ---------- N2O ----------
       // N2O SARF is calculated using simplified expressions from IPCC
@@ -354,7 +370,7 @@ void ForcingComponent::run(const double runToDate) {
           (a2 * sqrt(CO2_conc) + b2 * sqrt(Na) + c2 * sqrt(Ma) + d2) *
           (sqrt(Na) - sqrt(N0));
       double fn2o = (delta_n2o * sarf_n2o) + sarf_n2o;
-      forcings[D_RF_N2O].set(fn2o, U_W_M2);
+      forcings.set(F_N2O, fn2o);
 
       // ---------- CH4 ----------
       // CH4 SARF is calculated using simplified expressions from IPCC
@@ -363,7 +379,7 @@ void ForcingComponent::run(const double runToDate) {
       double sarf_ch4 =
           (a3 * sqrt(Ma) + b3 * sqrt(Na) + d3) * (sqrt(Ma) - sqrt(M0));
       double fch4 = (delta_ch4 * sarf_ch4) + sarf_ch4;
-      forcings[D_RF_CH4].set(fch4, U_W_M2);
+      forcings.set(F_CH4, fch4);
 
       // ---------- Stratospheric H2O based on CH4 oxidation ----------
       // The stratospheric water vapour RF based on changes in CH4
@@ -373,7 +389,7 @@ void ForcingComponent::run(const double runToDate) {
       const double stratH2O_base =
           0.0485; // W m-2 Strat H2O RF (1850 to 2014) from 7.3.2.6 IPCC AR6
       const double fh2o_strat = stratH2O_base * ((Ma - M0) / (Ma_base - M0)); //
-      forcings[D_RF_H2O_STRAT].set(fh2o_strat, U_W_M2);
+      forcings.set(F_H2O_STRAT, fh2o_strat);
     }
 
     // ---------- Troposheric Ozone ----------
@@ -383,26 +399,19 @@ void ForcingComponent::run(const double runToDate) {
                                              message_data(runToDate))
                                .value(U_DU_O3);
       const double fo3_trop = 0.042 * ozone;
-      forcings[D_RF_O3_TROP].set(fo3_trop, U_W_M2);
+      forcings.set(F_O3_TROP, fo3_trop);
     }
 
     // ---------- Halocarbons ----------
-    boost::array<string, 26> halos = {
-        {D_RF_CF4,      D_RF_C2F6,      D_RF_HFC23,     D_RF_HFC32,
-         D_RF_HFC4310,  D_RF_HFC125,    D_RF_HFC134a,   D_RF_HFC143a,
-         D_RF_HFC227ea, D_RF_HFC245fa,  D_RF_SF6,       D_RF_CFC11,
-         D_RF_CFC12,    D_RF_CFC113,    D_RF_CFC114,    D_RF_CFC115,
-         D_RF_CCl4,     D_RF_CH3CCl3,   D_RF_HCFC22,    D_RF_HCFC141b,
-         D_RF_HCFC142b, D_RF_halon1211, D_RF_halon1301, D_RF_halon2402,
-         D_RF_CH3Cl,    D_RF_CH3Br}};
-
     // Halocarbons can be disabled individually via the input file, so we run
     // through all possible ones
-    for (auto hc : halos) {
+    for (int i = 0; i < N_HALO_FORCINGS; ++i) {
+      const char *hc = forcing_names[halo_slots[i]];
       if (core->checkCapability(hc)) {
         // Forcing values are actually computed by the halocarbon itself
-        forcings[hc] =
-            core->sendMessage(M_GETDATA, hc, message_data(runToDate));
+        forcings.set(halo_slots[i],
+                     core->sendMessage(M_GETDATA, hc, message_data(runToDate))
+                         .value(U_W_M2));
       }
     }
 
@@ -423,27 +432,27 @@ void ForcingComponent::run(const double runToDate) {
           core->sendMessage(M_GETDATA, D_EMISSIONS_BC, message_data(runToDate))
               .value(U_TG);
       double fbc = rho_bc * E_BC;
-      forcings[D_RF_BC].set(fbc, U_W_M2);
+      forcings.set(F_BC, fbc);
 
       // ---------- Organic carbon ----------
       double E_OC =
           core->sendMessage(M_GETDATA, D_EMISSIONS_OC, message_data(runToDate))
               .value(U_TG);
       double foc = rho_oc * E_OC;
-      forcings[D_RF_OC].set(foc, U_W_M2);
+      forcings.set(F_OC, foc);
 
       // ---------- Sulphate Aerosols ----------
       unitval SO2_emission = core->sendMessage(M_GETDATA, D_EMISSIONS_SO2,
                                                message_data(runToDate));
       double fso2 = rho_so2 * SO2_emission.value(U_GG_S);
-      forcings[D_RF_SO2].set(fso2, U_W_M2);
+      forcings.set(F_SO2, fso2);
 
       // ---------- NH3 ----------
       double E_NH3 =
           core->sendMessage(M_GETDATA, D_EMISSIONS_NH3, message_data(runToDate))
               .value(U_TG);
       double fnh3 = rho_nh3 * E_NH3;
-      forcings[D_RF_NH3].set(fnh3, U_W_M2);
+      forcings.set(F_NH3, fnh3);
 
       // ---------- RFaci ----------
       // ERF from aerosol-cloud interactions (RFaci)
@@ -451,32 +460,36 @@ void ForcingComponent::run(const double runToDate) {
       double aci_rf =
           -1 * aci_beta *
           log(1 + (SO2_emission / s_SO2) + ((E_BC + E_OC) / s_BCOC));
-      forcings[D_RF_ACI].set(aci_rf, U_W_M2);
+      forcings.set(F_ACI, aci_rf);
     }
 
     // ---------- Terrestrial albedo ----------
     if (core->checkCapability(D_RF_T_ALBEDO)) {
-      forcings[D_RF_T_ALBEDO] =
-          core->sendMessage(M_GETDATA, D_RF_T_ALBEDO, message_data(runToDate));
+      forcings.set(F_T_ALBEDO, core->sendMessage(M_GETDATA, D_RF_T_ALBEDO,
+                                                 message_data(runToDate))
+                                   .value(U_W_M2));
     }
 
     // ---------- Volcanic forcings ----------
     if (core->checkCapability(D_VOLCANIC_SO2)) {
       // The volcanic forcings are read in from an ini file.
-      forcings[D_RF_VOL] =
-          core->sendMessage(M_GETDATA, D_VOLCANIC_SO2, message_data(runToDate));
+      forcings.set(F_VOL, core->sendMessage(M_GETDATA, D_VOLCANIC_SO2,
+                                            message_data(runToDate))
+                              .value(U_W_M2));
     }
 
     // ---------- Miscellaneous forcings ----------
     // Miscellaneous forcings read in from an ini file.
-    forcings[D_RF_MISC] = Fmisc_ts.get(runToDate);
+    forcings.set(F_MISC, Fmisc_ts.get(runToDate).value(U_W_M2));
 
     // ---------- Total ----------
     // Calculate based as the sum of the different radiative forcings or as the
     // user supplied constraint.
-    unitval Ftot(0.0, U_W_M2); // W/m2
-    for (auto f : forcings) {
-      Ftot = Ftot + f.second;
+    double Ftot = 0.0; // W/m2
+    for (int i = 0; i < N_FORCINGS; ++i) {
+      if (forcings.present[i] && i != F_TOTAL) {
+        Ftot += forcings.value[i];
+      }
     }
 
     // Otherwise if the user has supplied total forcing data, use that instead.
@@ -484,9 +497,9 @@ void ForcingComponent::run(const double runToDate) {
       H_LOG(logger, Logger::WARNING)
           << "** Overwriting total forcing with user-supplied value"
           << std::endl;
-      forcings[D_RF_TOTAL] = Ftot_constrain.get(runToDate);
+      forcings.set(F_TOTAL, Ftot_constrain.get(runToDate).value(U_W_M2));
     } else {
-      forcings[D_RF_TOTAL] = Ftot;
+      forcings.set(F_TOTAL, Ftot);
     }
 
     //---------- Change to relative forcing ----------
@@ -502,14 +515,18 @@ void ForcingComponent::run(const double runToDate) {
 
     // Subtract base year forcing values from forcings, i.e. make them relative
     // to base year
-    for (auto f : forcings) {
-      forcings[f.first] = f.second - baseyear_forcings[f.first];
+    for (int i = 0; i < N_FORCINGS; ++i) {
+      if (!forcings.present[i])
+        continue;
+      H_ASSERT(baseyear_forcings.present[i],
+               string("no base year value for ") + forcing_names[i]);
       H_LOG(logger, Logger::DEBUG)
-          << "forcing " << f.first << " in " << runToDate << " is " << f.second
-          << std::endl;
+          << "forcing " << forcing_names[i] << " in " << runToDate << " is "
+          << forcings.value[i] << std::endl;
+      forcings.value[i] -= baseyear_forcings.value[i];
     }
     H_LOG(logger, Logger::DEBUG)
-        << "forcing total is " << forcings[D_RF_TOTAL] << std::endl;
+        << "forcing total is " << forcings.value[F_TOTAL] << std::endl;
 
     // Store the forcings that we have calculated
     forcings_ts.set(runToDate, forcings);
@@ -552,28 +569,37 @@ unitval ForcingComponent::getData(const std::string &varName,
       return returnval;
     }
 
-    // Look up the forcing name and value
-    forcings_t forcings(forcings_ts.get(getdate));
-
-    std::string forcing_name;
-    auto forcit = forcing_name_map.find(varName);
-    if (forcit != forcing_name_map.end()) {
-      forcing_name = forcing_name_map[varName];
-    } else {
-      forcing_name = varName;
-    }
-    std::map<std::string, unitval>::const_iterator forcing =
-        forcings.find(forcing_name);
-    if (forcing != forcings.end()) {
-      returnval = forcing->second; // from the forcing map
-    } else {
-      H_THROW("Caller is requesting unknown variable: " + varName);
-    }
+    // Look up the forcing slot and value
+    const int slot = find_slot(varName);
+    H_ASSERT(slot >= 0, "Caller is requesting unknown variable: " + varName);
+    const forcings_t &forcings = forcings_ts.get(getdate);
+    H_ASSERT(forcings.present[slot],
+             "Caller is requesting unknown variable: " + varName);
+    returnval.set(forcings.value[slot], U_W_M2);
   }
 
   return returnval;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief             Find the forcing slot for a capability name
+ *  \param[in] varName forcing name, or adjusted halocarbon forcing name
+ *  \returns           the slot, or -1 if varName isn't a forcing
+ */
+int ForcingComponent::find_slot(const std::string &varName) {
+  static const std::map<std::string, int> slots = [] {
+    std::map<std::string, int> m;
+    for (int i = 0; i < N_FORCINGS; ++i)
+      m[forcing_names[i]] = i;
+    for (int i = 0; i < N_HALO_FORCINGS; ++i)
+      m[adjusted_halo_forcings[i]] = halo_slots[i];
+    return m;
+  }();
+
+  auto it = slots.find(varName);
+  return it == slots.end() ? -1 : it->second;
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void ForcingComponent::reset(double time) {
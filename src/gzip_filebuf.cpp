@@ -0,0 +1,130 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  gzip_filebuf.cpp
+ *  hector
+ *
+ *  A stream buffer writing a gzip-compressed file.
+ *
+ */
+
+#include "gzip_filebuf.hpp"
+
+//! zlib windowBits selecting a gzip (rather than zlib) wrapper
+#define GZIP_WINDOW_BITS (15 + 16)
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor; the buffer is not open
+ */
+gzip_filebuf::gzip_filebuf() : in(GZIP_BLOCK_SIZE), out(GZIP_BLOCK_SIZE) {
+  setp(0, 0);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Destructor; finishes the file if it is open
+ */
+gzip_filebuf::~gzip_filebuf() { close(); }
+
+//------------------------------------------------------------------------------
+/*! \brief Open a file for compressed output
+ *  \param fileName The file to write; conventionally it ends ".gz".
+ *  \returns this, or NULL if the file can't be opened (as std::filebuf).
+ */
+gzip_filebuf *gzip_filebuf::open(const string &fileName) {
+  if (is_open() || !file.open(fileName.c_str(), ios::out | ios::binary)) {
+    return NULL;
+  }
+
+  zs.zalloc = Z_NULL;
+  zs.zfree = Z_NULL;
+  zs.opaque = Z_NULL;
+  if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GZIP_WINDOW_BITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    file.close();
+    return NULL;
+  }
+  setp(in.data(), in.data() + in.size());
+  return this;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Is a file open?
+ */
+bool gzip_filebuf::is_open() const { return file.is_open(); }
+
+//------------------------------------------------------------------------------
+/*! \brief Compress what's left, finish the file, and close it
+ *  \returns this, or NULL if the file wasn't open or couldn't be finished.
+ */
+gzip_filebuf *gzip_filebuf::close() {
+  if (!is_open()) {
+    return NULL;
+  }
+  const bool ok = compress(Z_FINISH);
+  deflateEnd(&zs);
+  setp(0, 0);
+  return file.close() && ok ? this : NULL;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compress the put area and write the result to the file
+ *  \param flush The zlib flush mode: Z_SYNC_FLUSH to end a block, or
+ *               Z_FINISH to end the file.
+ *  \returns Whether everything was written.
+ */
+bool gzip_filebuf::compress(const int flush) {
+  zs.next_in = reinterpret_cast<Bytef *>(pbase());
+  zs.avail_in = uInt(pptr() - pbase());
+
+  int status;
+  do {
+    zs.next_out = reinterpret_cast<Bytef *>(out.data());
+    zs.avail_out = uInt(out.size());
+    status = deflate(&zs, flush);
+    if (status == Z_STREAM_ERROR) {
+      return false;
+    }
+    const streamsize n = out.size() - zs.avail_out;
+    if (file.sputn(out.data(), n) != n) {
+      return false;
+    }
+    // zlib has more to give if it filled the output buffer
+  } while (zs.avail_out == 0 || (flush == Z_FINISH && status != Z_STREAM_END));
+
+  setp(in.data(), in.data() + in.size());
+  return true;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief The put area is full: compress it as a block, then take c
+ */
+gzip_filebuf::int_type gzip_filebuf::overflow(int_type c) {
+  if (!is_open() || !compress(Z_SYNC_FLUSH)) {
+    return traits_type::eof();
+  }
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compress everything written so far through to the file
+ */
+int gzip_filebuf::sync() {
+  if (!is_open()) {
+    return 0;
+  }
+  return compress(Z_SYNC_FLUSH) && file.pubsync() == 0 ? 0 : -1;
+}
+
+} // namespace Hector
@@ -0,0 +1,110 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  h_fft.cpp
+ *  hector
+ *
+ *  Radix-2 fast Fourier transform, used for batch convolutions.
+ *
+ */
+
+#include <cmath>
+
+// The MinGW C++ compiler doesn't seem to pull in the cmath constants? (see
+// #384) As a workaround, we define M_PI here if needed
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#include "h_exception.hpp"
+#include "h_fft.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//-----------------------------------------------------------------------
+/*! \brief          Constructor
+ *  \param[in] len  transform length; must be a power of two
+ */
+h_fft::h_fft(const size_t len) : n(len) {
+  H_ASSERT(n > 0 && (n & (n - 1)) == 0, "FFT length must be a power of two");
+
+  int bits = 0;
+  while ((size_t(1) << bits) < n)
+    bits++;
+
+  bitrev.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    size_t r = 0;
+    for (int b = 0; b < bits; b++)
+      r |= ((i >> b) & 1) << (bits - 1 - b);
+    bitrev[i] = r;
+  }
+
+  // Each factor is computed directly, rather than by repeated
+  // multiplication, to keep round-off independent of n
+  twiddle.resize(n / 2);
+  for (size_t k = 0; k < n / 2; k++)
+    twiddle[k] = polar(1.0, -2.0 * M_PI * double(k) / double(n));
+}
+
+//-----------------------------------------------------------------------
+/*! \brief       Smallest power of two that is at least n
+ */
+size_t h_fft::length_for(const size_t n) {
+  size_t len = 1;
+  while (len < n)
+    len <<= 1;
+  return len;
+}
+
+//-----------------------------------------------------------------------
+/*! \brief            In-place forward transform
+ *  \param[in,out] a  series of length size()
+ */
+void h_fft::forward(vector<complex<double>> &a) const { transform(a, false); }
+
+//-----------------------------------------------------------------------
+/*! \brief            In-place inverse transform, scaled by 1/n
+ *  \param[in,out] a  series of length size()
+ */
+void h_fft::inverse(vector<complex<double>> &a) const {
+  transform(a, true);
+  const double scale = 1.0 / double(n);
+  for (size_t i = 0; i < n; i++)
+    a[i] *= scale;
+}
+
+//-----------------------------------------------------------------------
+/*! \brief Iterative Cooley-Tukey butterfly passes
+ */
+void h_fft::transform(vector<complex<double>> &a, const bool invert) const {
+  H_ASSERT(a.size() == n, "series length doesn't match FFT length");
+
+  for (size_t i = 0; i < n; i++) {
+    if (i < bitrev[i])
+      swap(a[i], a[bitrev[i]]);
+  }
+
+  for (size_t len = 2; len <= n; len <<= 1) {
+    const size_t half = len / 2;
+    const size_t stride = n / len;
+    for (size_t start = 0; start < n; start += len) {
+      for (size_t j = 0; j < half; j++) {
+        const complex<double> w =
+            invert ? conj(twiddle[j * stride]) : twiddle[j * stride];
+        const complex<double> u = a[start + j];
+        const complex<double> v = a[start + j + half] * w;
+        a[start + j] = u + v;
+        a[start + j + half] = u - v;
+      }
+    }
+  }
+}
+
+} // namespace Hector
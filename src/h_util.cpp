@@ -12,6 +12,28 @@
  *
  */
 
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+// Use std::to_chars to format numbers where the standard library has it for
+// doubles; otherwise fall back to snprintf.
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+// Memory-map files where we can; otherwise read them into memory.
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define H_USE_MMAP 1
+#endif
+
 #include "h_util.hpp"
 #include "h_exception.hpp"
 
@@ -81,4 +103,79 @@ void ensure_dir_exists(const std::string &dir) {
 #endif
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Append a number to a string, formatted as an ostream would in its
+ *         default notation with the given precision
+ */
+void append_number(string &s, const double x, const int precision) {
+  char buf[64];
+#ifdef __cpp_lib_to_chars
+  const std::to_chars_result result = std::to_chars(
+      buf, buf + sizeof(buf), x, std::chars_format::general, precision);
+  s.append(buf, result.ptr);
+#else
+  const int n = snprintf(buf, sizeof(buf), "%.*g", precision, x);
+  s.append(buf, n);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Map (or read) a whole file
+ * \param fileName The file to read.
+ * \exception h_exception If the file can't be opened or mapped.
+ */
+mapped_file::mapped_file(const string &fileName)
+    : data(NULL), length(0), map(NULL) {
+#ifdef H_USE_MMAP
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    const string errorStr = "I/O exception while processing " + fileName +
+                            " error: " + strerror(errno);
+    if (fd >= 0)
+      close(fd);
+    H_THROW(errorStr);
+  }
+  length = st.st_size;
+  if (length > 0) {
+    map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (map == MAP_FAILED) {
+    map = NULL;
+    H_THROW("Could not map " + fileName + " error: " + strerror(errno));
+  }
+  data = static_cast<const char *>(map);
+#else
+  ifstream in(fileName.c_str(), ios::in | ios::binary);
+  if (!in) {
+    H_THROW("I/O exception while processing " + fileName +
+            " error: " + strerror(errno));
+  }
+  buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  data = buffer.data();
+  length = buffer.size();
+#endif
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Unmap the file
+ */
+mapped_file::~mapped_file() {
+#ifdef H_USE_MMAP
+  if (map) {
+    munmap(map, length);
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Write a string to a binary file: its length (uint32_t), then its
+ *  bytes
+ */
+void put_binary_string(ostream &out, const string &s) {
+  put_binary(out, uint32_t(s.size()));
+  out.write(s.data(), s.size());
+}
+
 } // namespace Hector
@@ -156,6 +156,23 @@ void HalocarbonComponent::setData(const string &varName,
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void HalocarbonComponent::setSeries(const string &varName,
+                                    const tseries<unitval> &series) {
+  try {
+    if (varName == myGasName + EMISSIONS_EXTENSION) {
+      set_series(emissions, series, U_GG);
+    } else if (varName == myGasName + CONC_CONSTRAINT_EXTENSION) {
+      set_series(Ha_constrain, series, U_PPTV);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void HalocarbonComponent::prepareToRun() {
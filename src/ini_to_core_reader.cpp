@@ -75,6 +75,10 @@ void INIToCoreReader::parse(const string &filename) {
   iniFilePath = filename;
   int errorCode = ini_parse(filename.c_str(), valueHandler, this);
 
+  // the tables are only shared within one INI file; they may change on disk
+  // before the next one is parsed
+  tables.clear();
+
   // handle c errors by turning them into exceptions which can be handled later
   if (errorCode == -1) {
     H_THROW("Could not open " + filename);
@@ -163,8 +167,12 @@ int INIToCoreReader::valueHandler(void *user, const char *section,
       }
 #endif
 
-      CSVTableReader tableReader(csvFileName);
-      tableReader.process(reader->core, section, nameStr);
+      // read each table once and keep it for the rest of the INI file
+      unique_ptr<CSVTableReader> &tableReader = reader->tables[csvFileName];
+      if (!tableReader) {
+        tableReader.reset(new CSVTableReader(csvFileName));
+      }
+      tableReader->process(reader->core, section, nameStr);
     } else {
       // the typical variableName = value case
       // note that this implies name is not a time series variable and the
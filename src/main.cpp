@@ -15,19 +15,43 @@
 #include <fstream>
 #include <iostream>
 
+#include "binary_output_visitor.hpp"
 #include "core.hpp"
 #include "csv_outputstream_visitor.hpp"
 #include "csv_tracking_visitor.hpp"
+#include "gzip_filebuf.hpp"
 #include "h_exception.hpp"
 #include "h_reader.hpp"
 #include "h_util.hpp"
 #include "ini_to_core_reader.hpp"
 #include "logger.hpp"
+#include "scenario_bundle.hpp"
 
 #include "unitval.hpp"
 
 using namespace std;
 
+//-----------------------------------------------------------------------
+/*! \brief Split a comma separated list of variables
+ *  \param vars The list, e.g. "global_tas,CO2_concentration".
+ *  \param variables Filled with the (whitespace trimmed) variable names.
+ */
+static void split_variables(const string &vars, vector<string> &variables) {
+  variables.clear();
+  size_t start = 0;
+  while (start <= vars.size()) {
+    size_t comma = vars.find(',', start);
+    if (comma == string::npos)
+      comma = vars.size();
+    const size_t first = vars.find_first_not_of(" \t", start);
+    if (first < comma) {
+      const size_t last = vars.find_last_not_of(" \t", comma - 1);
+      variables.push_back(vars.substr(first, last + 1 - first));
+    }
+    start = comma + 1;
+  }
+}
+
 //-----------------------------------------------------------------------
 /*! \brief Entry point for HECTOR wrapper.
  *
@@ -42,11 +66,30 @@ int main(int argc, char *const argv[]) {
     Logger &glog = core.getGlobalLogger();
     H_LOG(glog, Logger::NOTICE) << MODEL_NAME << " wrapper start" << endl;
 
-    // Parse the main configuration file
+    // Compile a scenario bundle: hector --compile-scenario <ini> <bundle>
+    if (argc > 1 && string(argv[1]) == "--compile-scenario") {
+      if (argc != 4) {
+        H_THROW("Usage: <program> --compile-scenario <config file name> "
+                "<bundle file name>")
+      }
+      H_LOG(glog, Logger::NOTICE) << "Compiling " << argv[2] << " to "
+                                  << argv[3] << endl;
+      core.init();
+      ScenarioBundle::compile(&core, argv[2], argv[3]);
+      H_LOG(glog, Logger::NOTICE) << "Hector wrapper end" << endl;
+      glog.close();
+      return 0;
+    }
+
+    // Parse the main configuration file, or find a compiled bundle
+    bool bundle = false;
     if (argc > 1) {
       if (ifstream(argv[1])) {
         H_LOG(glog, Logger::NOTICE) << "Reading input file " << argv[1] << endl;
-        h_reader reader(argv[1], INI_style);
+        bundle = ScenarioBundle::isBundle(argv[1]);
+        if (!bundle) {
+          h_reader reader(argv[1], INI_style);
+        }
       } else {
         H_LOG(glog, Logger::SEVERE)
             << "Couldn't find input file " << argv[1] << endl;
@@ -57,19 +100,49 @@ int main(int argc, char *const argv[]) {
       H_THROW("Usage: <program> <config file name>")
     }
 
+    // Options following the configuration file:
+    //   --binary-output <var>,<var>,...  columnar binary output of variables
+    //                                    (overrides binary_output in [core])
+    //   --gzip                           gzip the CSV output files
+    //   --profile                        write time spent in each component
+    vector<string> binaryVariables;
+    bool gzipOutput = false;
+    for (int i = 2; i < argc; ++i) {
+      const string option = argv[i];
+      if (option == "--gzip") {
+        gzipOutput = true;
+      } else if (option == "--profile") {
+        core.getProfiler().enable(true);
+      } else if (option == "--binary-output" && i + 1 < argc) {
+        split_variables(argv[++i], binaryVariables);
+      } else {
+        H_THROW("Usage: <program> <config file name> [--binary-output "
+                "<variable>,<variable>,...] [--gzip] [--profile]")
+      }
+    }
+
     // Initialize the core and send input data to it
     H_LOG(glog, Logger::NOTICE)
         << "Creating and initializing the core." << endl;
     core.init();
 
     H_LOG(glog, Logger::NOTICE) << "Setting data in the core." << endl;
-    INIToCoreReader coreParser(&core);
-    coreParser.parse(argv[1]);
+    if (bundle) {
+      ScenarioBundle::load(&core, argv[1]);
+    } else {
+      INIToCoreReader coreParser(&core);
+      coreParser.parse(argv[1]);
+    }
+    if (binaryVariables.empty()) {
+      split_variables(core.getBinaryOutput(), binaryVariables);
+    }
 
     // Create visitors
     H_LOG(glog, Logger::NOTICE) << "Adding visitors to the core." << endl;
     filebuf csvoutputStreamFile;
     filebuf csvFluxPoolTrackingFile;
+    gzip_filebuf gzipOutputStreamFile;
+    gzip_filebuf gzipFluxPoolTrackingFile;
 
     // Open the stream output file, which has an optional run name (specified in
     // the INI file) in it First ensure that OUTPUT_DIRECTORY exists so that we
@@ -79,37 +152,54 @@ int main(int argc, char *const argv[]) {
     ensure_dir_exists(OUTPUT_DIRECTORY);
 
     string rn = core.getRun_name();
-    if (rn == "")
-      csvoutputStreamFile.open(
-          string(string(OUTPUT_DIRECTORY) + "outputstream.csv").c_str(),
-          ios::out);
-    else
-      csvoutputStreamFile.open(
-          string(string(OUTPUT_DIRECTORY) + "outputstream_" + rn + ".csv")
-              .c_str(),
-          ios::out);
-    // Open the simpleNbox tracking output file, similarly named
-    if (rn == "")
-      csvFluxPoolTrackingFile.open(
-          string(string(OUTPUT_DIRECTORY) + "tracking.csv").c_str(), ios::out);
-    else
-      csvFluxPoolTrackingFile.open(
-          string(string(OUTPUT_DIRECTORY) + "tracking_" + rn + ".csv").c_str(),
-          ios::out);
-
-    ostream outputStream(&csvoutputStreamFile);
-    CSVOutputStreamVisitor csvOutputStreamVisitor(outputStream);
+    const string suffix = (rn == "" ? "" : "_" + rn) + ".csv";
+    // The simpleNbox tracking output file is similarly named
+    const string outputStreamName =
+        string(OUTPUT_DIRECTORY) + "outputstream" + suffix;
+    const string trackingName = string(OUTPUT_DIRECTORY) + "tracking" + suffix;
+    streambuf *outputStreamBuf = &csvoutputStreamFile;
+    streambuf *trackingBuf = &csvFluxPoolTrackingFile;
+    if (gzipOutput) {
+      gzipOutputStreamFile.open(outputStreamName + ".gz");
+      gzipFluxPoolTrackingFile.open(trackingName + ".gz");
+      outputStreamBuf = &gzipOutputStreamFile;
+      trackingBuf = &gzipFluxPoolTrackingFile;
+    } else {
+      csvoutputStreamFile.open(outputStreamName.c_str(), ios::out);
+      csvFluxPoolTrackingFile.open(trackingName.c_str(), ios::out);
+    }
+
+    ostream outputStream(outputStreamBuf);
+    CSVOutputStreamVisitor csvOutputStreamVisitor(outputStream, true, true);
     core.addVisitor(&csvOutputStreamVisitor);
 
-    ostream trackingStream(&csvFluxPoolTrackingFile);
-    CSVFluxPoolVisitor csvFluxPoolVisitor(trackingStream);
+    ostream trackingStream(trackingBuf);
+    CSVFluxPoolVisitor csvFluxPoolVisitor(trackingStream, true, true, true);
     core.addVisitor(&csvFluxPoolVisitor);
 
+    // Columnar binary output, if any variables were asked for
+    BinaryOutputVisitor binaryOutputVisitor(
+        string(OUTPUT_DIRECTORY) +
+            (rn == "" ? "outputcolumns.bin" : "outputcolumns_" + rn + ".bin"),
+        binaryVariables);
+    if (!binaryVariables.empty())
+      core.addVisitor(&binaryOutputVisitor);
+
     H_LOG(glog, Logger::NOTICE) << "Calling prepareToRun()\n";
     core.prepareToRun();
 
     H_LOG(glog, Logger::NOTICE) << "Running the core." << endl;
     core.run();
+    csvOutputStreamVisitor.flush();
+    csvFluxPoolVisitor.flush();
+    if (!binaryVariables.empty())
+      binaryOutputVisitor.write();
+
+    if (core.getProfiler().isEnabled()) {
+      const string profileName = string(OUTPUT_DIRECTORY) + "profile" + suffix;
+      ofstream profileFile(profileName.c_str());
+      core.getProfiler().write(profileFile);
+    }
 
     H_LOG(glog, Logger::NOTICE) << "Hector wrapper end" << endl;
     glog.close();
@@ -13,6 +13,7 @@
  */
 
 #include "n2o_component.hpp"
+#include "atmos_chemistry.hpp"
 #include "avisitor.hpp"
 #include "core.hpp"
 #include "h_util.hpp"
@@ -131,6 +132,25 @@ void N2OComponent::setData(const string &varName, const message_data &data) {
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void N2OComponent::setSeries(const string &varName,
+                             const tseries<unitval> &series) {
+  try {
+    if (varName == D_EMISSIONS_N2O) {
+      set_series(N2O_emissions, series, U_TG_N);
+    } else if (varName == D_NAT_EMISSIONS_N2O) {
+      set_series(N2O_natural_emissions, series, U_TG_N);
+    } else if (varName == D_CONSTRAINT_N2O) {
+      set_series(N2O_constrain, series, U_PPBV_N2O);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void N2OComponent::prepareToRun() {
@@ -150,6 +170,21 @@ void N2OComponent::prepareToRun() {
 //------------------------------------------------------------------------------
 // documentation is inherited
 void N2OComponent::run(const double runToDate) {
+  if (core->fusedChemistry()) {
+    // The fused chemistry step advances N2O along with the other species
+    if (oldDate < runToDate)
+      AtmosChemistry::run(core, runToDate);
+    return;
+  }
+
+  advance(runToDate);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief               Compute the N2O concentration for one year
+ *  \param[in] runToDate year to compute
+ */
+void N2OComponent::advance(const double runToDate) {
 
   H_ASSERT(!core->inSpinup() && runToDate - oldDate == 1,
            "timestep must equal 1");
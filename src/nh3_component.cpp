@@ -92,6 +92,21 @@ void NH3Component::setData(const string &varName, const message_data &data) {
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void NH3Component::setSeries(const string &varName,
+                             const tseries<unitval> &series) {
+  try {
+    if (varName == D_EMISSIONS_NH3) {
+      set_series(NH3_emissions, series, U_TG);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void NH3Component::prepareToRun() {
@@ -14,6 +14,7 @@
 
 #include <math.h>
 
+#include "atmos_chemistry.hpp"
 #include "avisitor.hpp"
 #include "core.hpp"
 #include "h_util.hpp"
@@ -112,6 +113,25 @@ void OzoneComponent::setData(const string &varName, const message_data &data) {
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OzoneComponent::setSeries(const string &varName,
+                               const tseries<unitval> &series) {
+  try {
+    if (varName == D_EMISSIONS_NOX) {
+      set_series(NOX_emissions, series, U_TG_N);
+    } else if (varName == D_EMISSIONS_CO) {
+      set_series(CO_emissions, series, U_TG_CO);
+    } else if (varName == D_EMISSIONS_NMVOC) {
+      set_series(NMVOC_emissions, series, U_TG_NMVOC);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void OzoneComponent::prepareToRun() {
@@ -124,6 +144,23 @@ void OzoneComponent::prepareToRun() {
 //------------------------------------------------------------------------------
 // documentation is inherited
 void OzoneComponent::run(const double runToDate) {
+  if (core->fusedChemistry()) {
+    // The fused chemistry step advances O3 along with the other species
+    if (oldDate < runToDate)
+      AtmosChemistry::run(core, runToDate);
+    return;
+  }
+
+  advance(runToDate, core->sendMessage(M_GETDATA, D_CH4_CONC, runToDate));
+}
+
+//------------------------------------------------------------------------------
+/*! \brief                 Compute the O3 concentration for one year
+ *  \param[in] runToDate   year to compute
+ *  \param[in] current_ch4 CH4 concentration this year
+ */
+void OzoneComponent::advance(const double runToDate,
+                             const unitval current_ch4) {
 
   // Calculate O3 based on NOX, CO, NMVOC, CH4.
   // Modified from Tanaka et al 2007
@@ -131,7 +168,6 @@ void OzoneComponent::run(const double runToDate) {
   unitval current_nox = NOX_emissions.get(runToDate);
   unitval current_co = CO_emissions.get(runToDate);
   unitval current_nmvoc = NMVOC_emissions.get(runToDate);
-  unitval current_ch4 = core->sendMessage(M_GETDATA, D_CH4_CONC, runToDate);
 
   O3.set(runToDate,
          unitval((5 * log(current_ch4)) + (0.125 * current_nox) +
@@ -95,6 +95,21 @@ void OrganicCarbonComponent::setData(const string &varName,
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OrganicCarbonComponent::setSeries(const string &varName,
+                                       const tseries<unitval> &series) {
+  try {
+    if (varName == D_EMISSIONS_OC) {
+      set_series(OC_emissions, series, U_TG);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void OrganicCarbonComponent::prepareToRun() {
@@ -0,0 +1,165 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  ocean_circulation.cpp
+ *  hector
+ *
+ *  Box-to-box transport for the ocean component, stored as a sparse matrix.
+ *
+ */
+
+#include "ocean_circulation.hpp"
+#include "h_exception.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ */
+OceanCirculation::OceanCirculation() { clear(); }
+
+//------------------------------------------------------------------------------
+/*! \brief Remove all transport entries
+ */
+void OceanCirculation::clear() {
+  pending.clear();
+  row_start.clear();
+  dest.clear();
+  k.clear();
+  annual.clear();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief          Add (or replace) a box-to-box transport
+ *  \param[in] from index of the box carbon leaves
+ *  \param[in] to   index of the box carbon arrives in
+ *  \param[in] kval fraction of the source box's carbon moved per year
+ *  \exception      if from and to are the same box, or kval is negative
+ *
+ *  If a transport between the same two boxes (in the same direction) has
+ *  already been added, it is overwritten when the matrix is built.
+ */
+void OceanCirculation::add_transport(const size_t from, const size_t to,
+                                     const double kval) {
+  H_ASSERT(from != to, "can't make connection to same box");
+  H_ASSERT(kval >= 0, "transport rate must be non-negative");
+  transport t = {from, to, kval};
+  pending.push_back(t);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief              Assemble the compressed sparse row matrix
+ *  \param[in] nboxes   number of boxes (rows) in the operator
+ *  \exception          if a transport refers to a box index >= nboxes
+ *
+ *  Entries keep the order in which they were added within each row, so
+ *  carbon moves between boxes in a reproducible order.
+ */
+void OceanCirculation::build(const size_t nboxes) {
+  row_start.assign(nboxes + 1, 0);
+  dest.clear();
+  k.clear();
+
+  for (size_t row = 0; row < nboxes; row++) {
+    row_start[row] = dest.size();
+    for (size_t i = 0; i < pending.size(); i++) {
+      const transport &t = pending[i];
+      H_ASSERT(t.from < nboxes && t.to < nboxes, "box index out of range");
+      if (t.from != row)
+        continue;
+
+      // Overwrite an existing entry between these two boxes
+      size_t j = row_start[row];
+      while (j < dest.size() && dest[j] != t.to)
+        j++;
+      if (j < dest.size()) {
+        k[j] = t.k;
+      } else {
+        dest.push_back(t.to);
+        k.push_back(t.k);
+      }
+    }
+  }
+  row_start[nboxes] = dest.size();
+  annual.assign(dest.size(), 0.0);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief              Move carbon between boxes for part of a year
+ *  \param[in] boxes    the ocean boxes, in matrix order
+ *  \param[in] yf       year fraction (0-1)
+ *
+ *  Schedules each transport as an addition to the receiving box and a
+ *  subtraction from the sending one; the boxes apply them in update_state().
+ */
+void OceanCirculation::apply(const vector<oceanbox *> &boxes, const double yf) {
+  H_ASSERT(boxes.size() == size(), "box count doesn't match circulation");
+
+  for (size_t row = 0; row < size(); row++) {
+    if (row_start[row] == row_start[row + 1])
+      continue;
+    const fluxpool carbon = boxes[row]->get_carbon();
+    for (size_t j = row_start[row]; j < row_start[row + 1]; j++) {
+      const fluxpool closs = carbon * k[j] * yf;
+      boxes[dest[j]]->add_carbon(closs);
+      boxes[row]->remove_carbon(closs);
+      annual[j] += closs.value(U_PGC);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief A new year is starting; zero the annual fluxes
+ */
+void OceanCirculation::new_year() { annual.assign(dest.size(), 0.0); }
+
+//------------------------------------------------------------------------------
+/*! \brief          Carbon moved between two boxes so far this year
+ *  \param[in] from index of the sending box
+ *  \param[in] to   index of the receiving box
+ *  \returns        unitval, flux (Pg C/yr); zero if the boxes aren't connected
+ */
+unitval OceanCirculation::annual_flux(const size_t from,
+                                      const size_t to) const {
+  if (from < size()) {
+    for (size_t j = row_start[from]; j < row_start[from + 1]; j++) {
+      if (dest[j] == to)
+        return unitval(annual[j], U_PGC_YR);
+    }
+  }
+  return unitval(0.0, U_PGC_YR);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief          Restore the annual fluxes, e.g. after a reset
+ *  \param[in] af   annual fluxes, one per matrix entry
+ */
+void OceanCirculation::set_annual_fluxes(const vector<double> &af) {
+  H_ASSERT(af.size() == dest.size(), "annual flux count mismatch");
+  annual = af;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Log the transport matrix
+ */
+void OceanCirculation::log_state(Logger &logger,
+                                 const vector<oceanbox *> &boxes) const {
+  H_LOG(logger, Logger::DEBUG)
+      << "Ocean circulation: " << size() << " boxes, " << nonzeros()
+      << " connections" << endl;
+  for (size_t row = 0; row < size(); row++) {
+    for (size_t j = row_start[row]; j < row_start[row + 1]; j++) {
+      H_LOG(logger, Logger::DEBUG)
+          << "   " << boxes[row]->get_name() << " -> "
+          << boxes[dest[j]]->get_name() << ", k=" << k[j] << endl;
+    }
+  }
+}
+
+} // namespace Hector
@@ -33,6 +33,13 @@
  *  https://doi.org/10.5281/zenodo.7304553
  */
 
+// some boost headers generate warnings under clang; not our problem, ignore
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#include "boost/algorithm/string.hpp"
+#include "boost/lexical_cast.hpp"
+#pragma clang diagnostic pop
+
 #include <cmath>
 #include <limits>
 
@@ -81,6 +88,7 @@ void OceanComponent::init(Core *coreptr) {
   surfaceLL.logger = &logger;
   inter.logger = &logger;
   deep.logger = &logger;
+  collect_boxes();
 
   core = coreptr;
 
@@ -120,6 +128,7 @@ void OceanComponent::init(Core *coreptr) {
   core->registerCapability(D_CO3_HL, getComponentName());
   core->registerCapability(D_CO3_LL, getComponentName());
   core->registerCapability(D_CO3, getComponentName());
+  core->registerCapability(D_OCEAN_MAX_TIMESTEP, getComponentName());
 
   // Register the inputs we can receive from outside
   core->registerInput(D_TT, getComponentName());
@@ -149,9 +158,15 @@ unitval OceanComponent::sendMessage(const std::string &message,
     H_LOG(logger, Logger::DEBUG) << "Atmosphere dumping " << carbon
                                  << " Pg C to deep ocean" << std::endl;
 
-    // We don't want this to be tracked, so just overwrite the deep total
-    carbon = carbon + unitval(deep.get_carbon().value(U_PGC), U_PGC);
-    deep.set_carbon(carbon);
+    // We don't want this to be tracked, so just overwrite the deep totals,
+    // spreading the carbon over the deep boxes by volume
+    for (size_t i = 0; i < boxes.size(); i++) {
+      if (box_deep_share[i] > 0) {
+        boxes[i]->set_carbon(
+            carbon * box_deep_share[i] +
+            unitval(boxes[i]->get_carbon().value(U_PGC), U_PGC));
+      }
+    }
 
   } else { //! We don't handle any other messages
     H_THROW("Caller sent unknown message: " + message);
@@ -166,8 +181,15 @@ void OceanComponent::setData(const string &varName, const message_data &data) {
   H_LOG(logger, Logger::DEBUG) << "Setting " << varName << "[" << data.date
                                << "]=" << data.value_str << std::endl;
 
+  // Box-specific inputs for the N-box ocean are of the form <box>.<var> or
+  // <box>.<box>.<var>
+  std::vector<std::string> splitvec;
+  boost::split(splitvec, varName, boost::is_any_of(OCEAN_PARSECHAR));
+
   try {
-    if (varName == D_CARBON_PRE_SURF) {
+    if (splitvec.size() > 1) {
+      setNboxData(splitvec, data);
+    } else if (varName == D_CARBON_PRE_SURF) {
       H_ASSERT(data.date == Core::undefinedIndex(), "date not allowed");
       preind_C_surface = data.getUnitval(U_PGC);
     } else if (varName == D_CARBON_PRE_ID) {
@@ -197,6 +219,93 @@ void OceanComponent::setData(const string &varName, const message_data &data) {
   }
 }
 
+//------------------------------------------------------------------------------
+/*! \brief                Set an input for the generalized N-box ocean
+ *  \param[in] splitvec   variable name, split at OCEAN_PARSECHAR
+ *  \param[in] data       the value to set
+ *
+ *  Interior boxes are declared by giving their share of the intermediate and
+ *  deep ocean volume, `<box>.volume_frac`; boxes with `<box>.deep=1` count as
+ *  deep ocean in the outputs, and share carbon dumped to the deep ocean by
+ *  volume. Transports (m3/s) between any two boxes,
+ *  including the `HL` and `LL` surface boxes, are given as
+ *  `<from>.<to>.transport`. Once any interior box is declared, these replace
+ *  the default intermediate and deep boxes and the tt/tu/twi/tid circulation.
+ */
+void OceanComponent::setNboxData(const std::vector<std::string> &splitvec,
+                                 const message_data &data) {
+  H_ASSERT(data.date == Core::undefinedIndex(), "date not allowed");
+  H_ASSERT(splitvec.size() <= 3, "max of two separators allowed in ocean "
+                                 "variable names");
+
+  const std::string &var = splitvec.back();
+  if (splitvec.size() == 3) {
+    H_ASSERT(var == D_OCEAN_TRANSPORT, "unknown ocean transport variable");
+    nbox_transport t = {splitvec[0], splitvec[1],
+                        data.getUnitval(U_M3_S)};
+    nbox_transports.push_back(t);
+    return;
+  }
+
+  // The surface boxes aren't named until prepareToRun, so check the names
+  // they will be given
+  const std::string &box = splitvec[0];
+  H_ASSERT(box != "HL" && box != "LL", "surface boxes can't be redefined");
+  if (nbox_volume_frac.find(box) == nbox_volume_frac.end() &&
+      nbox_deep.find(box) == nbox_deep.end()) {
+    nbox_names.push_back(box);
+  }
+
+  if (var == D_OCEAN_BOX_VOLUME_FRAC) {
+    nbox_volume_frac[box] = data.getUnitval(U_UNITLESS);
+  } else if (var == D_OCEAN_BOX_DEEP) {
+    nbox_deep[box] = (data.getUnitval(U_UNDEFINED) > 0);
+  } else {
+    H_THROW("Unknown ocean box variable: " + var);
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Point the boxes vector at the boxes currently in use
+ *
+ *  Needs to be called whenever the interior vector is (re)assigned.
+ */
+void OceanComponent::collect_boxes() {
+  boxes.clear();
+  box_is_deep.clear();
+  box_deep_share.clear();
+  boxes.push_back(&surfaceHL);
+  boxes.push_back(&surfaceLL);
+  box_is_deep.push_back(false);
+  box_is_deep.push_back(false);
+
+  if (nbox_mode()) {
+    double deep_frac = 0.0;
+    for (size_t i = 0; i < interior.size(); i++) {
+      interior[i].logger = &logger;
+      boxes.push_back(&interior[i]);
+      box_is_deep.push_back(nbox_deep[interior[i].get_name()]);
+      if (box_is_deep.back()) {
+        deep_frac += nbox_volume_frac[interior[i].get_name()];
+      }
+    }
+    box_deep_share.assign(boxes.size(), 0.0);
+    for (size_t i = 0; i < interior.size(); i++) {
+      if (box_is_deep[i + 2]) {
+        box_deep_share[i + 2] =
+            nbox_volume_frac[interior[i].get_name()] / deep_frac;
+      }
+    }
+  } else {
+    boxes.push_back(&inter);
+    boxes.push_back(&deep);
+    box_is_deep.push_back(false);
+    box_is_deep.push_back(true);
+    box_deep_share.assign(boxes.size(), 0.0);
+    box_deep_share.back() = 1.0;
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void OceanComponent::prepareToRun() {
@@ -256,32 +365,40 @@ void OceanComponent::prepareToRun() {
                                    U_PGC_YR); // used if no spinup chemistry
   surfaceLL.active_chemistry = spinup_chem;
 
-  inter.initbox(I_preind_C, "intermediate");
-  deep.initbox(D_preind_C, "deep");
-
-  // transport * seconds / volume of box
-  // Advection --> transport of carbon from one box to the next (k values,
-  // fraction/yr )
-  double LL_HL = (tt.value(U_M3_S) * spy) / LL_volume;
-  double HL_DO = ((tt + tu).value(U_M3_S) * spy) / HL_volume;
-  double DO_IO = ((tt + tu).value(U_M3_S) * spy) / D_volume;
-  double IO_HL = (tu.value(U_M3_S) * spy) / I_volume;
-  double IO_LL = (tt.value(U_M3_S) * spy) / I_volume;
-
-  // Exchange parameters --> not explicitly modeling diffusion
-  double IO_LLex = (twi.value(U_M3_S) * spy) / I_volume;
-  double LL_IOex = (twi.value(U_M3_S) * spy) / LL_volume;
-  double DO_IOex = (tid.value(U_M3_S) * spy) / D_volume;
-  double IO_DOex = (tid.value(U_M3_S) * spy) / I_volume;
-
-  // Set up the flow connections between the boxes
-  surfaceLL.make_connection(&surfaceHL, LL_HL, 1);
-  surfaceLL.make_connection(&inter, LL_IOex, 1);
-  surfaceHL.make_connection(&deep, HL_DO, 1);
-  inter.make_connection(&surfaceLL, IO_LL + IO_LLex, 1);
-  inter.make_connection(&surfaceHL, IO_HL, 1);
-  inter.make_connection(&deep, IO_DOex, 1);
-  deep.make_connection(&inter, DO_IO + DO_IOex, 1);
+  circulation.clear();
+  if (nbox_mode()) {
+    setup_nbox(HL_volume, LL_volume, I_volume + D_volume, spy);
+  } else {
+    inter.initbox(I_preind_C, "intermediate");
+    deep.initbox(D_preind_C, "deep");
+    collect_boxes();
+
+    // transport * seconds / volume of box
+    // Advection --> transport of carbon from one box to the next (k values,
+    // fraction/yr )
+    double LL_HL = (tt.value(U_M3_S) * spy) / LL_volume;
+    double HL_DO = ((tt + tu).value(U_M3_S) * spy) / HL_volume;
+    double DO_IO = ((tt + tu).value(U_M3_S) * spy) / D_volume;
+    double IO_HL = (tu.value(U_M3_S) * spy) / I_volume;
+    double IO_LL = (tt.value(U_M3_S) * spy) / I_volume;
+
+    // Exchange parameters --> not explicitly modeling diffusion
+    double IO_LLex = (twi.value(U_M3_S) * spy) / I_volume;
+    double LL_IOex = (twi.value(U_M3_S) * spy) / LL_volume;
+    double DO_IOex = (tid.value(U_M3_S) * spy) / D_volume;
+    double IO_DOex = (tid.value(U_M3_S) * spy) / I_volume;
+
+    // Set up the flow connections between the boxes: 0=HL, 1=LL,
+    // 2=intermediate, 3=deep
+    circulation.add_transport(1, 0, LL_HL);
+    circulation.add_transport(1, 2, LL_IOex);
+    circulation.add_transport(0, 3, HL_DO);
+    circulation.add_transport(2, 1, IO_LL + IO_LLex);
+    circulation.add_transport(2, 0, IO_HL);
+    circulation.add_transport(2, 3, IO_DOex);
+    circulation.add_transport(3, 2, DO_IO + DO_IOex);
+  }
+  circulation.build(boxes.size());
 
   // Inputs for surface chemistry boxes
   surfaceHL.deltaT.set(-16.4,
@@ -312,10 +429,86 @@ void OceanComponent::prepareToRun() {
   lastflux_annualized.set(0.0, U_PGC);
 
   // Log the state of all our boxes, so we know things are as they should be
-  surfaceLL.log_state();
-  surfaceHL.log_state();
-  inter.log_state();
-  deep.log_state();
+  for (size_t i = 0; i < boxes.size(); i++) {
+    boxes[i]->log_state();
+  }
+  circulation.log_state(logger, boxes);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief                  Set up the boxes and circulation of the N-box ocean
+ *  \param[in] HL_volume    volume of the high latitude surface box (m3)
+ *  \param[in] LL_volume    volume of the low latitude surface box (m3)
+ *  \param[in] ID_volume    volume of the intermediate and deep ocean (m3)
+ *  \param[in] spy          seconds per year
+ *  \exception              if the configuration is incomplete or inconsistent
+ *
+ *  The preindustrial intermediate and deep carbon is partitioned among the
+ *  interior boxes by volume, as for the default four-box ocean. The
+ *  transports (m3/s) into each box must balance those out of it.
+ */
+void OceanComponent::setup_nbox(const double HL_volume, const double LL_volume,
+                                const double ID_volume, const double spy) {
+  H_LOG(logger, Logger::NOTICE)
+      << "Setting up " << nbox_names.size() + 2 << "-box ocean" << std::endl;
+
+  inter.initbox(0.0, "intermediate");
+  deep.initbox(0.0, "deep");
+
+  std::map<std::string, size_t> box_index;
+  std::vector<double> volume;
+  box_index[surfaceHL.get_name()] = 0;
+  box_index[surfaceLL.get_name()] = 1;
+  volume.push_back(HL_volume);
+  volume.push_back(LL_volume);
+
+  interior.assign(nbox_names.size(), oceanbox());
+  double frac_total = 0.0;
+  bool have_deep = false;
+  for (size_t i = 0; i < nbox_names.size(); i++) {
+    const std::string &name = nbox_names[i];
+    H_ASSERT(nbox_volume_frac.find(name) != nbox_volume_frac.end(),
+             "no " D_OCEAN_BOX_VOLUME_FRAC " given for ocean box " + name);
+    const double frac = nbox_volume_frac[name];
+    H_ASSERT(frac > 0, "volume fraction must be positive for box " + name);
+    frac_total += frac;
+    have_deep = have_deep || nbox_deep[name];
+
+    interior[i].logger = &logger;
+    interior[i].initbox(frac * preind_C_ID.value(U_PGC), name);
+    box_index[name] = i + 2;
+    volume.push_back(frac * ID_volume);
+  }
+  H_ASSERT(fabs(frac_total - 1.0) < 1e-6,
+           "ocean box volume fractions must sum to 1");
+  H_ASSERT(have_deep, "at least one ocean box must be deep");
+  collect_boxes();
+
+  std::vector<double> inflow(boxes.size(), 0.0), outflow(boxes.size(), 0.0);
+  for (size_t i = 0; i < nbox_transports.size(); i++) {
+    const nbox_transport &t = nbox_transports[i];
+    H_ASSERT(box_index.find(t.from) != box_index.end(),
+             "unknown ocean box " + t.from);
+    H_ASSERT(box_index.find(t.to) != box_index.end(),
+             "unknown ocean box " + t.to);
+    const size_t from = box_index[t.from], to = box_index[t.to];
+    const double flow = t.transport.value(U_M3_S);
+    circulation.add_transport(from, to, (flow * spy) / volume[from]);
+    outflow[from] += flow;
+    inflow[to] += flow;
+  }
+
+  // Water has to be conserved: each box must send out as much as it takes
+  // in, or its carbon concentration drifts away without limit
+  const double balance_tol = 1e-6; // relative to the larger of the two
+  for (size_t i = 0; i < boxes.size(); i++) {
+    H_ASSERT(fabs(inflow[i] - outflow[i]) <=
+                 balance_tol * std::max(inflow[i], outflow[i]),
+             "transports into and out of ocean box " + boxes[i]->get_name() +
+                 " don't balance: " +
+                 boost::lexical_cast<std::string>(inflow[i]) + " m3/s in, " +
+                 boost::lexical_cast<std::string>(outflow[i]) + " m3/s out");
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -323,8 +516,25 @@ void OceanComponent::prepareToRun() {
  *  \returns    unitval, total carbon in the ocean
  */
 fluxpool OceanComponent::totalcpool() const {
-  return deep.get_carbon() + inter.get_carbon() + surfaceLL.get_carbon() +
-         surfaceHL.get_carbon();
+  fluxpool total = boxes.back()->get_carbon();
+  for (size_t i = boxes.size() - 1; i > 0; i--) {
+    total = total + boxes[i - 1]->get_carbon();
+  }
+  return total;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief                  Internal function to add up interior C pools
+ *  \param[in] in_deep      sum the deep boxes (true) or intermediate (false)?
+ *  \returns                unitval, carbon in the selected interior boxes
+ */
+unitval OceanComponent::interior_carbon(const bool in_deep) const {
+  unitval total(0.0, U_PGC);
+  for (size_t i = 2; i < boxes.size(); i++) {
+    if (box_is_deep[i] == in_deep)
+      total = total + boxes[i]->get_carbon();
+  }
+  return total;
 }
 
 //------------------------------------------------------------------------------
@@ -359,10 +569,9 @@ void OceanComponent::run(const double runToDate) {
   const double tdate = core->getTrackingDate();
   if (!in_spinup && runToDate == tdate) {
     H_LOG(logger, Logger::NOTICE) << "Tracking start" << std::endl;
-    surfaceHL.start_tracking();
-    surfaceLL.start_tracking();
-    inter.start_tracking();
-    deep.start_tracking();
+    for (size_t i = 0; i < boxes.size(); i++) {
+      boxes[i]->start_tracking();
+    }
   }
 
   CO2_conc = core->sendMessage(M_GETDATA, D_CO2_CONC, message_data(runToDate));
@@ -378,10 +587,10 @@ void OceanComponent::run(const double runToDate) {
   // Initialize ocean box boundary conditions and inform them new year starting
   H_LOG(logger, Logger::DEBUG)
       << "Starting new year: SST= " << SST << std::endl;
-  surfaceHL.new_year(SST);
-  surfaceLL.new_year(SST);
-  inter.new_year(SST);
-  deep.new_year(SST);
+  for (size_t i = 0; i < boxes.size(); i++) {
+    boxes[i]->new_year(SST);
+  }
+  circulation.new_year();
   H_LOG(logger, Logger::DEBUG)
       << "----------------------------------------------------" << std::endl;
   H_LOG(logger, Logger::DEBUG)
@@ -399,9 +608,9 @@ void OceanComponent::run(const double runToDate) {
     surfaceLL.chem_equilibrate(CO2_conc);
   }
 
-  // Call compute_fluxes with do_boxfluxes=false to run just chemistry
-  surfaceHL.compute_fluxes(CO2_conc, atmosphere_cpool, 1.0, false);
-  surfaceLL.compute_fluxes(CO2_conc, atmosphere_cpool, 1.0, false);
+  // Call compute_fluxes to run chemistry; circulation waits for the solver
+  surfaceHL.compute_fluxes(CO2_conc, atmosphere_cpool, 1.0);
+  surfaceLL.compute_fluxes(CO2_conc, atmosphere_cpool, 1.0);
 
   // Now wait for the solver to call us
 }
@@ -453,7 +662,7 @@ unitval OceanComponent::getData(const std::string &varName, const double date) {
     } else if (varName == D_CARBON_PRE_ID) {
       returnval = preind_C_ID;
     } else if (varName == D_CARBON_DO) {
-      returnval = deep.get_carbon();
+      returnval = interior_carbon(true);
     } else if (varName == D_CARBON_HL) {
       returnval = surfaceHL.get_carbon();
     } else if (varName == D_CARBON_LL) {
@@ -461,7 +670,7 @@ unitval OceanComponent::getData(const std::string &varName, const double date) {
     } else if (varName == D_CARBON_ML) {
       returnval = surfaceLL.get_carbon() + surfaceHL.get_carbon();
     } else if (varName == D_CARBON_IO) {
-      returnval = inter.get_carbon();
+      returnval = interior_carbon(false);
     } else if (varName == D_DIC_HL) {
       returnval = surfaceHL.mychemistry.convertToDIC(surfaceHL.get_carbon());
     } else if (varName == D_DIC_LL) {
@@ -474,7 +683,11 @@ unitval OceanComponent::getData(const std::string &varName, const double date) {
               surfaceHL.mychemistry.convertToDIC(surfaceHL.get_carbon());
       returnval = unitval(value, U_UMOL_KG);
     } else if (varName == D_HL_DO) {
-      returnval = surfaceHL.annual_box_fluxes[&deep];
+      returnval = unitval(0.0, U_PGC_YR);
+      for (size_t i = 2; i < boxes.size(); i++) {
+        if (box_is_deep[i])
+          returnval = returnval + circulation.annual_flux(0, i);
+      }
     } else if (varName == D_PCO2_HL) {
       returnval = surfaceHL.mychemistry.PCO2o;
     } else if (varName == D_PCO2_LL) {
@@ -507,6 +720,8 @@ unitval OceanComponent::getData(const std::string &varName, const double date) {
       returnval = unitval(value, U_UMOL_KG);
     } else if (varName == D_TIMESTEPS) {
       returnval = unitval(timesteps, U_UNITLESS);
+    } else if (varName == D_OCEAN_MAX_TIMESTEP) {
+      returnval = unitval(max_timestep, U_YRS);
     } else {
       H_THROW("Problem with user request for constant data: " + varName);
     }
@@ -569,6 +784,8 @@ unitval OceanComponent::getData(const std::string &varName, const double date) {
       double value =
           part_high * co3_HL_ts.get(date) + part_low * co3_LL_ts.get(date);
       returnval = unitval(value, U_UMOL_KG);
+    } else if (varName == D_OCEAN_MAX_TIMESTEP) {
+      returnval = unitval(max_timestep_ts.get(date), U_YRS);
     } else {
       H_THROW("Problem with user request for time series: " + varName);
     }
@@ -670,11 +887,12 @@ void OceanComponent::stashCValues(double t, const double c[]) {
 
   unitval CO2_conc(c[SNBOX_ATMOS] * PGC_TO_PPMVCO2, U_PPMV_CO2);
 
-  // Compute fluxes between the boxes (advection of carbon)
-  surfaceHL.compute_fluxes(CO2_conc, atmosphere_cpool, yearfraction);
-  surfaceLL.compute_fluxes(CO2_conc, atmosphere_cpool, yearfraction);
-  inter.compute_fluxes(CO2_conc, atmosphere_cpool, yearfraction);
-  deep.compute_fluxes(CO2_conc, atmosphere_cpool, yearfraction);
+  // Compute atmosphere-ocean fluxes, then fluxes between the boxes
+  // (advection of carbon)
+  for (size_t i = 0; i < boxes.size(); i++) {
+    boxes[i]->compute_fluxes(CO2_conc, atmosphere_cpool, yearfraction);
+  }
+  circulation.apply(boxes, yearfraction);
 
   // At this point, compute_fluxes has (by calling the chemistry model) computed
   // atmosphere- ocean fluxes for the surface boxes. But these are
@@ -746,17 +964,11 @@ void OceanComponent::stashCValues(double t, const double c[]) {
   H_LOG(logger, Logger::DEBUG)
       << "annualflux_sum=" << annualflux_sum << std::endl;
 
-  // Log the state of all our boxes
-  surfaceLL.log_state();
-  surfaceHL.log_state();
-  inter.log_state();
-  deep.log_state();
-
-  // Update box states
-  surfaceHL.update_state();
-  surfaceLL.update_state();
-  inter.update_state();
-  deep.update_state();
+  // Log the state of all our boxes, and update them
+  for (size_t i = 0; i < boxes.size(); i++) {
+    boxes[i]->log_state();
+    boxes[i]->update_state();
+  }
 
   // All good! t will be the start of the next timestep, so
   ODEstartdate = t;
@@ -765,11 +977,22 @@ void OceanComponent::stashCValues(double t, const double c[]) {
 //------------------------------------------------------------------------------
 // documentation is inherited
 void OceanComponent::reset(double time) {
-  // Reset state variables to their values at the reset time
-  surfaceHL = surfaceHL_tv.get(time);
-  surfaceLL = surfaceLL_tv.get(time);
-  inter = inter_tv.get(time);
-  deep = deep_tv.get(time);
+  // Reset state variables to their values at the reset time. The boxes are
+  // restored in place, so their configuration carries over, as do their
+  // chemistry equilibrium caches: a rerun spinup that reaches the same
+  // preindustrial state reuses the alkalinity found last time.
+  const std::vector<oceanbox_state> &box_states = box_state_tv.get(time);
+  H_ASSERT(box_states.size() == boxes.size(), "ocean box count has changed");
+  for (size_t i = 0; i < boxes.size(); i++) {
+    boxes[i]->set_state(box_states[i]);
+  }
+  if (tracked_carbon_tv.exists(time)) {
+    const std::vector<fluxpool> &tracked_carbon = tracked_carbon_tv.get(time);
+    for (size_t i = 0; i < boxes.size(); i++) {
+      boxes[i]->restore_carbon(tracked_carbon[i]);
+    }
+  }
+  circulation.set_annual_fluxes(circulation_flux_tv.get(time));
 
   SST = SST_ts.get(time);
   CO2_conc = Ca_ts.get(time);
@@ -784,10 +1007,9 @@ void OceanComponent::reset(double time) {
   timesteps = 0;
 
   // truncate all the time series beyond the reset time
-  surfaceHL_tv.truncate(time);
-  surfaceLL_tv.truncate(time);
-  inter_tv.truncate(time);
-  deep_tv.truncate(time);
+  box_state_tv.truncate(time);
+  tracked_carbon_tv.truncate(time);
+  circulation_flux_tv.truncate(time);
 
   SST_ts.truncate(time);
   Ca_ts.truncate(time);
@@ -809,10 +1031,19 @@ void OceanComponent::reset(double time) {
 void OceanComponent::record_state(double time) {
   H_LOG(logger, Logger::DEBUG)
       << "Recording component state at t= " << time << endl;
-  surfaceHL_tv.set(time, surfaceHL);
-  surfaceLL_tv.set(time, surfaceLL);
-  inter_tv.set(time, inter);
-  deep_tv.set(time, deep);
+  std::vector<oceanbox_state> box_states(boxes.size());
+  for (size_t i = 0; i < boxes.size(); i++) {
+    box_states[i] = boxes[i]->get_state();
+  }
+  box_state_tv.set(time, box_states);
+  if (boxes[0]->get_carbon().tracking) {
+    std::vector<fluxpool> tracked_carbon;
+    for (size_t i = 0; i < boxes.size(); i++) {
+      tracked_carbon.push_back(boxes[i]->get_carbon());
+    }
+    tracked_carbon_tv.set(time, tracked_carbon);
+  }
+  circulation_flux_tv.set(time, circulation.get_annual_fluxes());
 
   // Record the state of the various ocean boxes and variables at each time step
   // in a unitval time series so that the output can be output by the
@@ -823,9 +1054,8 @@ void OceanComponent::record_state(double time) {
   annualflux_sumHL_ts.set(time, annualflux_sumHL);
   annualflux_sumLL_ts.set(time, annualflux_sumLL);
   lastflux_annualized_ts.set(time, lastflux_annualized);
-  C_IO_ts.set(time, inter.get_carbon());
+  C_IO_ts.set(time, interior_carbon(false));
   Ca_HL_ts.set(time, surfaceHL.get_carbon());
-  C_DO_ts.set(time, surfaceHL.annual_box_fluxes[&deep]);
   PH_HL_ts.set(time, surfaceHL.mychemistry.pH);
   PH_LL_ts.set(time, surfaceLL.mychemistry.pH);
   pco2_HL_ts.set(time, surfaceHL.mychemistry.PCO2o);
@@ -835,7 +1065,7 @@ void OceanComponent::record_state(double time) {
   dic_LL_ts.set(time,
                 surfaceLL.mychemistry.convertToDIC(surfaceLL.get_carbon()));
   Ca_LL_ts.set(time, surfaceLL.get_carbon());
-  C_DO_ts.set(time, deep.get_carbon());
+  C_DO_ts.set(time, interior_carbon(true));
   temp_HL_ts.set(time, surfaceHL.get_Tbox());
   temp_LL_ts.set(time, surfaceLL.get_Tbox());
   co3_HL_ts.set(time, surfaceHL.mychemistry.CO3);
@@ -12,7 +12,8 @@
  *
  */
 
-#include <boost/math/tools/minima.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/math/tools/roots.hpp>
 #include <iomanip>
 
 #include "oceanbox.hpp"
@@ -43,6 +44,7 @@ oceanbox::oceanbox() {
   preindustrial_flux.set(0.0, U_PGC_YR);
   ao_flux.set(0.0, U_PGC);
   oa_flux.set(0.0, U_PGC);
+  equil_cache = {0.0, 0.0, 0.0, 0.0, 0.0};
 }
 
 //------------------------------------------------------------------------------
@@ -58,11 +60,6 @@ void oceanbox::set_carbon(const unitval C) {
 /*! \brief initialize all needed information in an oceanbox
  */
 void oceanbox::initbox(double boxc, string name) {
-  connection_list.clear();
-  connection_k.clear();
-  connection_window.clear();
-  annual_box_fluxes.clear();
-
   // Each box is separate from each other, and we keep track of carbon in each
   // box
   Name = name;
@@ -89,6 +86,17 @@ void oceanbox::add_carbon(fluxpool carbon) {
       << CarbonSubtractions << ")" << endl;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief          Remove carbon from an oceanbox
+ *  \param[in] carbon    Amount of carbon to remove from this box
+ *
+ *  Carbon flows to other boxes leave via this method. As with add_carbon(),
+ *  the actual decrement happens in update_state().
+ */
+void oceanbox::remove_carbon(fluxpool carbon) {
+  CarbonSubtractions = CarbonSubtractions + carbon;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief          Compute absolute temperature of box in C
  *  \param[in] SST Mean ocean temperature change from preindustrial, C
@@ -98,48 +106,6 @@ unitval oceanbox::compute_tabsC(const unitval SST) const {
   return SST + unitval(MEAN_TOS_TEMP, U_DEGC) + deltaT;
 }
 
-//------------------------------------------------------------------------------
-/*! \brief          Add (or replace) a box-to-box connection
- *  \param[in] ob   pointer to another oceanbox
- *  \param[in] k    weight of the connection
- *  \param[in] ws   connection window size: 0=current state only, 1=mean of
- * current and 1 year back, etc. \exception      if ob is same as current box
- *
- *  Establishes a one-way connection from the current box to another, with a
- * weight of k. If a connection already exists, it will be overwritten (i.e.
- * only two connections between any two boxes are allowed, one in each
- * direction).  Window establishes how many previous time step connections to
- * use.
- */
-void oceanbox::make_connection(
-    oceanbox *ob, const double k,
-    const int ws) { //, window=1 or whatever we are averaging over.  use curent
-                    // state of 1 or will use what we tell it to use.
-
-  H_ASSERT(ob != this, "can't make connection to same box");
-  OB_LOG(logger, Logger::NOTICE) << "Adding connection " << Name << " to "
-                                 << ob->Name << ", k=" << k << endl;
-
-  // If a connection to this box already exists, replace it
-  for (unsigned i = 0; i < connection_list.size(); i++) {
-    if (connection_list[i] == ob) {
-      connection_k[i] = k;
-      connection_window[i] = ws;
-      OB_LOG(logger, Logger::WARNING)
-          << "** overwriting connection in " << Name << " ** " << endl;
-      OB_LOG(logger, Logger::WARNING)
-          << "** Are you sure about this? ** " << endl;
-      return;
-    }
-  }
-
-  // Otherwise, make a new connection
-  connection_list.push_back(ob); // add new element to vector
-  connection_k.push_back(k);
-  H_ASSERT(ws >= 0, "window negative number");
-  connection_window.push_back(ws);
-}
-
 //------------------------------------------------------------------------------
 double round(const double d) { return floor(d + 0.5); }
 
@@ -186,23 +152,18 @@ void oceanbox::log_state() {
     unitval dic = mychemistry.convertToDIC(carbon);
     OB_LOG(logger, Logger::DEBUG) << "   Surface DIC = " << dic << endl;
   }
-  for (unsigned i = 0; i < connection_list.size(); i++) {
-    OB_LOG(logger, Logger::DEBUG)
-        << "   Connection #" << i << " to " << connection_list[i]->Name
-        << ", k=" << connection_k[i] << ", window=" << connection_window[i]
-        << endl;
-  }
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Compute all fluxes between boxes
+/*! \brief Compute atmosphere-box fluxes
  * \param[in] current_Ca                atmospheric CO2
  * \param[in] yf                year fraction (0-1)
- * \param[in] do_circ           flag: do circulation, or not?
+ *
+ * Box-to-box transports are handled separately, by OceanCirculation.
  */
 void oceanbox::compute_fluxes(const unitval current_Ca,
-                              const fluxpool atmosphere_cpool, const double yf,
-                              const bool do_circ) {
+                              const fluxpool atmosphere_cpool,
+                              const double yf) {
 
   CO2_conc = current_Ca;
 
@@ -229,34 +190,6 @@ void oceanbox::compute_fluxes(const unitval current_Ca,
   atmosphere_flux = atmosphere_flux * yf;
 
   separate_surface_fluxes(atmosphere_cpool);
-
-  // Step 3: check if this box is oscillating
-  /*
-  const bool osc = oscillating( 10, // over the last 10 states,
-                                 1,   // has box C varied by >1%
-                                 3 ); // while changing direction 3+ times?
-  */
-
-  // Step 4 : calculate the carbon transports between the boxes
-  if (do_circ) {
-    fluxpool closs_total(0.0, U_PGC, carbon.tracking);
-
-    for (unsigned i = 0; i < connection_window.size(); i++) {
-
-      fluxpool closs = carbon * connection_k[i] * yf;
-
-      OB_LOG(logger, Logger::DEBUG)
-          << Name << " conn " << i << " flux= " << closs << endl;
-
-      connection_list[i]->add_carbon(closs);
-      CarbonSubtractions = CarbonSubtractions + closs; // PgC
-      closs_total = closs_total + closs;
-      annual_box_fluxes[connection_list[i]] =
-          annual_box_fluxes[connection_list[i]] +
-          unitval(closs.value(U_PGC), U_PGC_YR);
-    } // for i
-
-  } // if do_circulation
 }
 
 void oceanbox::separate_surface_fluxes(fluxpool atmosphere_pool) {
@@ -308,9 +241,6 @@ void oceanbox::update_state() {
  */
 void oceanbox::new_year(const unitval SST) {
 
-  for (unsigned i = 0; i < connection_window.size(); i++) {
-    annual_box_fluxes[connection_list[i]] = unitval(0.0, U_PGC_YR);
-  }
   Tbox = compute_tabsC(SST);
 
   // save for Revelle Calc
@@ -323,39 +253,35 @@ void oceanbox::new_year(const unitval SST) {
 }
 
 //------------------------------------------------------------------------------
-/*! \brief              Function that chem_equilibrate tries to minimize
+/*! \brief              Function whose root chem_equilibrate finds
  *  \param[in] alk      alkalinity value to try
- *  \param[in] params  pointer to other parameters (just f_target currently)
- *  \returns            double, difference between flux and target flux
+ *  \param[in] f_target target atmosphere-ocean flux, Pg C/yr
+ *  \returns            double, signed difference between flux and target flux
  *
- *  The gsl minimization algorithm calls this function, which slots alk
- *  into the csys chemistry input, runs csys, and reports back the difference
- *  between csys's computed ocean-atmosphere flux and the target flux.
+ *  The root-finding algorithm calls this function, which slots alk into the
+ *  csys chemistry input, runs csys, and reports back the difference between
+ *  csys's computed ocean-atmosphere flux and the target flux. The flux
+ *  increases monotonically with alkalinity, so the difference changes sign
+ *  exactly once over any sensible alkalinity range.
  */
-double oceanbox::fmin(double alk, void *params) {
+double oceanbox::fdiff(double alk, double f_target) {
 
   // Call the chemistry model with new value for alk
   mychemistry.set_alk(alk);
   mychemistry.ocean_csys_run(Tbox, carbon);
 
-  double f_target = *(double *)params;
-  double diff =
-      fabs(mychemistry.calc_annual_surface_flux(CO2_conc).value(U_PGC_YR) -
-           f_target);
-  //    OB_LOG( logger, Logger::DEBUG) << "fmin at " << alk << ", f_target=" <<
-  //    f_target << ", returning " << diff << endl;
-
-  return diff;
+  return mychemistry.calc_annual_surface_flux(CO2_conc).value(U_PGC_YR) -
+         f_target;
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Functor wrapper for minimization function
+/*! \brief Functor wrapper for root-finding function
  */
-struct FMinWrapper {
-  FMinWrapper(oceanbox *instance, const double f_targetIn)
+struct FDiffWrapper {
+  FDiffWrapper(oceanbox *instance, const double f_targetIn)
       : object_which_will_handle_signal(instance), f_target(f_targetIn) {}
   double operator()(const double alk) {
-    return object_which_will_handle_signal->fmin(alk, &f_target);
+    return object_which_will_handle_signal->fdiff(alk, f_target);
   }
 
 private:
@@ -366,6 +292,8 @@ private:
 //------------------------------------------------------------------------------
 /*! \brief                  Equilibrate the chemistry model to a given flux
  *  \param[in] current_Ca           Atmospheric CO2 (ppmv)
+ *  \exception                      if the alkalinity search does not
+ *                                  converge
  *
  *  \details The global carbon cycle can be spun up with ocean chemistry either
  *  on or off. In the former case, the ocean continually equilibrates with the
@@ -378,10 +306,14 @@ private:
  *  fluxes. That's what this method does. Note that we pass in current CO2
  * because in case the model was NOT spun up, need to set the box's internal
  * tracking var.
+ *
+ * The result is cached together with the inputs it depends on, so that a
+ * reset-and-rerun with unchanged preindustrial conditions skips the search.
  */
 void oceanbox::chem_equilibrate(const unitval current_Ca) {
 
   using namespace std;
+  using namespace boost::math::tools;
 
   CO2_conc = current_Ca;
 
@@ -395,53 +327,124 @@ void oceanbox::chem_equilibrate(const unitval current_Ca) {
   OB_LOG(logger, Logger::DEBUG)
       << "[CO2]=" << CO2_conc << ", DIC=" << dic << endl;
 
+  const double f_target = preindustrial_flux.value(U_PGC_YR);
+  const equilibrium_cache key = {0.0, f_target,
+                                 CO2_conc.value(U_PPMV_CO2),
+                                 carbon.value(U_PGC), Tbox.value(U_DEGC)};
+
+  if (equil_cache.alk > 0 && key.f_target == equil_cache.f_target &&
+      key.Ca == equil_cache.Ca && key.C == equil_cache.C &&
+      key.T == equil_cache.T) {
+    OB_LOG(logger, Logger::DEBUG)
+        << "Reusing cached alkalinity " << equil_cache.alk << endl;
+    fdiff(equil_cache.alk, f_target);
+    return;
+  }
+
   // Tune the chemistry model's alkalinity parameter to produce a particular
   // flux. This happens after the box model has been spun up with chemistry
   // turned off, before the chemistry model is turned on (because we don't want
   // it to suddenly produce a larger ocean-atmosphere flux).
 
-  // Here we use the Brent algorithm
-  //      http://www.gnu.org/software/gsl/manual/html_node/Minimization-Algorithms.html
-  // to minimize abs(f-f0), where f is computed by the csys chemistry code and
-  // f0 passed in
-
-  double alk_min = 2100e-6, alk_max = 2750e-6;
-  double f_target = preindustrial_flux.value(U_PGC_YR);
+  // The flux is monotonic in alkalinity, so we solve flux(alk) - f0 = 0 with
+  // the TOMS748 bracketing root finder over the full plausible range. The
+  // bracket doesn't depend on earlier calls, so the root is a function of the
+  // inputs alone, and a cached one is exactly what the search would find.
+  const double lo = 2100e-6, hi = 2750e-6;
+  FDiffWrapper fFunctor(this, f_target);
+  const double flo = fFunctor(lo), fhi = fFunctor(hi);
 
-  // Find a best-guess point; the GSL algorithm seems to need it
-  OB_LOG(logger, Logger::DEBUG) << "Looking for best-guess alkalinity" << endl;
+  double alk;
   const int w = 12;
-  OB_LOG(logger, Logger::DEBUG)
-      << setw(w) << "Alk" << setw(w) << "FPgC" << setw(w) << "f_target"
-      << setw(w) << "diff" << endl;
-  double min_diff = 1e6;
-  double min_point = (alk_min + alk_max) / 2.0;
-  for (double alk1 = alk_min; alk1 <= alk_max;
-       alk1 += (alk_max - alk_min) / 20) {
-    double diff = fmin(alk1, &f_target);
-    if (diff < min_diff) {
-      min_diff = diff;
-      min_point = alk1;
-    }
+  if (flo * fhi > 0) {
+    // No sign change anywhere in the range, so no alkalinity gives the target
+    // flux; as the Brent minimization this replaced did, take the best
+    // alkalinity in the range and carry on
+    alk = fabs(flo) < fabs(fhi) ? lo : hi;
+    OB_LOG(logger, Logger::WARNING)
+        << "Could not bracket alkalinity for box " << Name
+        << ": f_target=" << f_target << " Pg C/yr, flux difference " << flo
+        << " at alk=" << lo << " and " << fhi << " at alk=" << hi
+        << "; using alk=" << alk << endl;
+  } else {
+    // arbitrarily solve until 60% of the digits are correct.
+    const int digits = numeric_limits<double>::digits;
+    const int get_digits = static_cast<int>(digits * 0.6);
+    const boost::uintmax_t iter_limit = 50;
+    boost::uintmax_t max_iter = iter_limit;
+    std::pair<double, double> r =
+        toms748_solve(fFunctor, lo, hi, flo, fhi,
+                      eps_tolerance<double>(get_digits), max_iter);
+    H_ASSERT(max_iter < iter_limit,
+             "alkalinity search for ocean box " + Name +
+                 " did not converge in " +
+                 boost::lexical_cast<string>(iter_limit) + " evaluations");
+    alk = (r.first + r.second) / 2.0;
     OB_LOG(logger, Logger::DEBUG)
-        << setw(w) << alk1 << setw(w) << atmosphere_flux << setw(w) << f_target
-        << setw(w) << diff << endl;
+        << "Root found after " << max_iter << " evaluations" << endl;
   }
-  double alk = min_point; // this is our best guess
-  OB_LOG(logger, Logger::DEBUG) << "Best guess minimum is at " << alk << endl;
-
-  FMinWrapper fFunctor(this, f_target);
-  // arbitrarily solve unil 60% of the digits are correct.
-  const int digits = numeric_limits<double>::digits;
-  int get_digits = static_cast<int>(digits * 0.6);
-  std::pair<double, double> r = boost::math::tools::brent_find_minima(
-      fFunctor, alk_min, alk_max, get_digits);
+
+  const double diff = fFunctor(alk);
   OB_LOG(logger, Logger::DEBUG)
-      << setw(w) << "Alk" << setw(w) << "FPgC" << setw(w) << "f_target"
-      << setw(w) << "diff" << endl;
+      << setw(w) << "Alk" << setw(w) << "f_target" << setw(w) << "diff"
+      << endl;
   OB_LOG(logger, Logger::DEBUG)
-      << setw(w) << r.first << setw(w) << atmosphere_flux << setw(w) << f_target
-      << setw(w) << r.second << endl;
+      << setw(w) << alk << setw(w) << f_target << setw(w) << diff << endl;
+
+  equil_cache = key;
+  equil_cache.alk = alk;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief        Record the box's dynamic state
+ *  \returns      oceanbox_state, everything needed to restore the box later
+ */
+oceanbox_state oceanbox::get_state() const {
+  oceanbox_state st;
+  st.carbon = carbon.value(U_PGC);
+  st.tracking = carbon.tracking;
+  st.active_chemistry = active_chemistry;
+  st.Tbox = Tbox;
+  st.CO2_conc = CO2_conc;
+  st.dic_lastyear = dic_lastyear;
+  st.atmosphere_flux = atmosphere_flux;
+  st.alk = mychemistry.get_alk();
+  st.TCO2o = mychemistry.TCO2o;
+  st.HCO3 = mychemistry.HCO3;
+  st.CO3 = mychemistry.CO3;
+  st.PCO2o = mychemistry.PCO2o;
+  st.pH = mychemistry.pH;
+  st.OmegaCa = mychemistry.OmegaCa;
+  st.OmegaAr = mychemistry.OmegaAr;
+  return st;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief          Restore the box's dynamic state
+ *  \param[in] st   state previously returned by get_state()
+ *
+ *  Box carbon is restored untracked, with this box as its only source; if
+ *  tracking was on, the caller should follow up with restore_carbon().
+ *  States are always recorded between timesteps, so there are no pending
+ *  additions or subtractions.
+ */
+void oceanbox::set_state(const oceanbox_state &st) {
+  carbon.set(st.carbon, U_PGC, st.tracking, Name);
+  CarbonAdditions.set(0.0, U_PGC, st.tracking, Name);
+  CarbonSubtractions.set(0.0, U_PGC, st.tracking, Name);
+  active_chemistry = st.active_chemistry;
+  Tbox = st.Tbox;
+  CO2_conc = st.CO2_conc;
+  dic_lastyear = st.dic_lastyear;
+  atmosphere_flux = st.atmosphere_flux;
+  mychemistry.set_alk(st.alk);
+  mychemistry.TCO2o = st.TCO2o;
+  mychemistry.HCO3 = st.HCO3;
+  mychemistry.CO3 = st.CO3;
+  mychemistry.PCO2o = st.PCO2o;
+  mychemistry.pH = st.pH;
+  mychemistry.OmegaCa = st.OmegaCa;
+  mychemistry.OmegaAr = st.OmegaAr;
 }
 
 //------------------------------------------------------------------------------
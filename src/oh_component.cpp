@@ -13,6 +13,7 @@
  */
 
 #include "oh_component.hpp"
+#include "atmos_chemistry.hpp"
 #include "avisitor.hpp"
 #include "core.hpp"
 #include "h_util.hpp"
@@ -121,6 +122,25 @@ void OHComponent::setData(const string &varName, const message_data &data) {
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OHComponent::setSeries(const string &varName,
+                            const tseries<unitval> &series) {
+  try {
+    if (varName == D_EMISSIONS_NOX) {
+      set_series(NOX_emissions, series, U_TG_N);
+    } else if (varName == D_EMISSIONS_CO) {
+      set_series(CO_emissions, series, U_TG_CO);
+    } else if (varName == D_EMISSIONS_NMVOC) {
+      set_series(NMVOC_emissions, series, U_TG_NMVOC);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void OHComponent::prepareToRun() {
@@ -135,6 +155,26 @@ void OHComponent::prepareToRun() {
 //------------------------------------------------------------------------------
 // documentation is inherited
 void OHComponent::run(const double runToDate) {
+  if (core->fusedChemistry()) {
+    // The fused chemistry step advances OH along with the other species
+    if (oldDate < runToDate)
+      AtmosChemistry::run(core, runToDate);
+    return;
+  }
+
+  // get this from CH4 component, this is last year's value
+  const double previous_ch4 =
+      core->sendMessage(M_GETDATA, D_CH4_CONC, oldDate).value(U_PPBV_CH4);
+
+  advance(runToDate, previous_ch4);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief                  Compute the OH lifetime for one year
+ *  \param[in] runToDate    year to compute
+ *  \param[in] previous_ch4 CH4 concentration the year before (ppbv CH4)
+ */
+void OHComponent::advance(const double runToDate, const double previous_ch4) {
   H_LOG(logger, Logger::DEBUG)
       << "olddate:  " << oldDate << " runToDate: " << runToDate << std::endl;
   H_ASSERT(!core->inSpinup() && runToDate - oldDate == 1,
@@ -145,10 +185,6 @@ void OHComponent::run(const double runToDate) {
   unitval current_co = CO_emissions.get(runToDate);
   unitval current_nmvoc = NMVOC_emissions.get(runToDate);
 
-  // get this from CH4 component, this is last year's value
-  const double previous_ch4 =
-      core->sendMessage(M_GETDATA, D_CH4_CONC, oldDate).value(U_PPBV_CH4);
-
   double toh = 0.0;
   if (previous_ch4 != M0) // if we are not at the first time
   {
@@ -0,0 +1,44 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  profiler.cpp
+ *  hector
+ *
+ *  Wall time and call counts of the parts of a model run.
+ *
+ */
+
+#include "profiler.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Zero all entries
+ *
+ *  The entries themselves are kept, so references to them stay valid.
+ */
+void Profiler::clear() {
+  for (auto &e : entries) {
+    e.second = profile_entry();
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Write the entries as CSV, one line per entry
+ *  \param out The stream to write to.
+ */
+void Profiler::write(ostream &out) const {
+  out << "name,kind,calls,seconds\n";
+  for (const auto &e : entries) {
+    out << e.first.first << "," << e.first.second << "," << e.second.calls
+        << "," << e.second.seconds << "\n";
+  }
+}
+
+} // namespace Hector
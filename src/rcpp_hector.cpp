@@ -1,10 +1,12 @@
 #include <Rcpp.h>
 #include <fstream>
+#include <map>
 #include <sstream>
 
 #include "hector.hpp"
 #include "logger.hpp"
 #include "message_data.hpp"
+#include "temperature_component.hpp"
 
 using namespace Rcpp;
 
@@ -51,8 +53,12 @@ Environment newcore_impl(String inifile, int loglevel, bool suppresslogging,
     hcore->init();
 
     try {
-      Hector::INIToCoreReader coreParser(hcore);
-      coreParser.parse(inifile);
+      if (Hector::ScenarioBundle::isBundle(fn)) {
+        Hector::ScenarioBundle::load(hcore, fn);
+      } else {
+        Hector::INIToCoreReader coreParser(hcore);
+        coreParser.parse(inifile);
+      }
     } catch (h_exception e) {
       std::stringstream msg;
       msg << "While parsing hector input file " << fn << ": " << e;
@@ -200,6 +206,125 @@ std::string get_tracking_data_impl(Environment core) {
   return hcore->getTrackingData();
 }
 
+//' Retrieve the tracking data for a Hector instance, as a data frame
+//'
+//' The data are copied straight from the model's tracking records, with no
+//' text in between; pool and source names are made into R strings once each.
+//'
+//' @param core Handle to the Hector instance.
+//' @noRd
+// [[Rcpp::export]]
+DataFrame get_tracking_columns_impl(Environment core) {
+  Hector::Core *hcore = gethcore(core);
+  Hector::tracking_columns columns;
+  hcore->getTrackingColumns(columns);
+  if (columns.year.empty()) {
+    return DataFrame::create();
+  }
+
+  CharacterVector pool_components(columns.pools.size());
+  CharacterVector pool_names(columns.pools.size());
+  CharacterVector pool_units(columns.pools.size());
+  for (size_t i = 0; i < columns.pools.size(); ++i) {
+    pool_components[i] = columns.pools[i].component;
+    pool_names[i] = columns.pools[i].name;
+    pool_units[i] = columns.pools[i].units;
+  }
+  CharacterVector source_names(columns.sources.begin(), columns.sources.end());
+
+  const size_t N = columns.year.size();
+  IntegerVector year(N);
+  CharacterVector component(N), pool_name(N), units(N), source_name(N);
+  for (size_t i = 0; i < N; ++i) {
+    const unsigned pool = columns.pool[i];
+    year[i] = int(columns.year[i]);
+    component[i] = pool_components[pool];
+    pool_name[i] = pool_names[pool];
+    units[i] = pool_units[pool];
+    source_name[i] = source_names[columns.source[i]];
+  }
+
+  return DataFrame::create(
+      Named("year") = year, Named("component") = component,
+      Named("pool_name") = pool_name,
+      Named("pool_value") = wrap(columns.pool_value),
+      Named("pool_units") = units, Named("source_name") = source_name,
+      Named("source_fraction") = wrap(columns.source_fraction),
+      Named("stringsAsFactors") = false);
+}
+
+//' Turn profiling of a Hector instance on or off
+//'
+//' While profiling is on, the instance records the wall time spent in, and
+//' the number of calls to, each component's steps, the output visitors, the
+//' carbon cycle model, and the messages it routes.  See
+//' \code{\link{get_profile}}.
+//'
+//' @param core Handle to the Hector instance.
+//' @param enable Whether to profile.
+//' @return The Hector instance handle
+//' @export
+// [[Rcpp::export]]
+Environment set_profiling(Environment core, bool enable = true) {
+  Hector::Core *hcore = gethcore(core);
+  hcore->getProfiler().enable(enable);
+  return core;
+}
+
+//' Retrieve the profile of a Hector instance
+//'
+//' @param core Handle to the Hector instance.
+//' @return A \code{\link{data.frame}} with one row per profiled part of the
+//'   model: \code{name} (the component, visitor, or for messages the
+//'   variable asked for), \code{kind} (what was timed, e.g. \code{"run"}),
+//'   \code{calls}, and \code{seconds} (total wall time).  Empty unless
+//'   profiling was turned on with \code{\link{set_profiling}}.
+//' @export
+// [[Rcpp::export]]
+DataFrame get_profile(Environment core) {
+  Hector::Core *hcore = gethcore(core);
+  const Hector::Profiler::entry_map &entries =
+      hcore->getProfiler().getEntries();
+
+  CharacterVector name(entries.size()), kind(entries.size());
+  NumericVector calls(entries.size()), seconds(entries.size());
+  size_t i = 0;
+  for (const auto &e : entries) {
+    name[i] = e.first.first;
+    kind[i] = e.first.second;
+    calls[i] = e.second.calls;
+    seconds[i] = e.second.seconds;
+    ++i;
+  }
+
+  return DataFrame::create(Named("name") = name, Named("kind") = kind,
+                           Named("calls") = calls, Named("seconds") = seconds,
+                           Named("stringsAsFactors") = false);
+}
+
+//' Write the profile of a Hector instance to a CSV file
+//'
+//' The file has the columns of \code{\link{get_profile}}, as written by the
+//' command line model's \code{--profile} option.
+//'
+//' @param core Handle to the Hector instance.
+//' @param file Name of the file to write.
+//' @return The Hector instance handle
+//' @export
+// [[Rcpp::export]]
+Environment write_profile(Environment core, String file) {
+  Hector::Core *hcore = gethcore(core);
+  std::ofstream out(file.get_cstring());
+  if (!out) {
+    Rcpp::stop(std::string("Couldn't open profile file ") + file.get_cstring());
+  }
+  hcore->getProfiler().write(out);
+  if (!out) {
+    Rcpp::stop(std::string("Couldn't write profile file ") + file.get_cstring());
+  }
+  return core;
+}
+
 //' Retrieve the current list of biomes for a Hector instance
 //'
 //' @param core Handle to the Hector instance from which to retrieve
@@ -312,49 +437,304 @@ DataFrame sendmessage(Environment core, String msgtype, String capability,
   NumericVector valueout(N);
   StringVector unitsout(N);
 
-  try {
+  // A SETDATA with a date for every value is a whole time series, which is
+  // handed to the components in one piece.
+  bool series = msgstr == M_SETDATA && N > 1;
+  for (size_t i = 0; series && i < N; ++i) {
+    series = !NumericVector::is_na(date[i]);
+  }
+
+  if (series) {
+    std::vector<double> dates(N), values(N);
     for (size_t i = 0; i < N; ++i) {
-      // Construct the inputs to sendmessage
-      int ival; // location of the value we're looking for
-      if (value.size() == 1)
-        ival = 0;
-      else
-        ival = i;
-
-      double tempval;
-      if (NumericVector::is_na(value[ival]))
-        tempval = 0;
-      else
-        tempval = value[ival];
-
-      double tempdate;
-      if (NumericVector::is_na(date[i]))
-        tempdate = Hector::Core::undefinedIndex();
-      else
-        tempdate = date[i];
-
-      Hector::message_data info(tempdate, Hector::unitval(tempval, utype));
-
-      Hector::unitval rtn = hcore->sendMessage(msgstr, capstr, info);
-
-      unitsout[i] = rtn.unitsName();
-      valueout[i] = rtn.value(rtn.units());
+      const double v = value[value.size() == 1 ? 0 : i];
+      dates[i] = date[i];
+      values[i] = NumericVector::is_na(v) ? 0 : v;
+      valueout[i] = values[i];
+      unitsout[i] = Hector::unitval::unitsName(utype);
+    }
+    try {
+      hcore->sendSeries(capstr, dates, values, utype);
+    } catch (h_exception e) {
+      std::stringstream emsg;
+      emsg << "sendmessage: " << e;
+      Rcpp::stop(emsg.str());
+    }
+  } else {
+    try {
+      for (size_t i = 0; i < N; ++i) {
+        // Construct the inputs to sendmessage
+        int ival; // location of the value we're looking for
+        if (value.size() == 1)
+          ival = 0;
+        else
+          ival = i;
+
+        double tempval;
+        if (NumericVector::is_na(value[ival]))
+          tempval = 0;
+        else
+          tempval = value[ival];
+
+        double tempdate;
+        if (NumericVector::is_na(date[i]))
+          tempdate = Hector::Core::undefinedIndex();
+        else
+          tempdate = date[i];
+
+        Hector::message_data info(tempdate, Hector::unitval(tempval, utype));
+
+        Hector::unitval rtn = hcore->sendMessage(msgstr, capstr, info);
+
+        unitsout[i] = rtn.unitsName();
+        valueout[i] = rtn.value(rtn.units());
+      }
+    } catch (h_exception e) {
+      std::stringstream emsg;
+      emsg << "sendmessage: " << e;
+      Rcpp::stop(emsg.str());
     }
+  }
+
+  // Assemble a data frame with the results: date, var, value, units
+  DataFrame result =
+      DataFrame::create(Named("year") = date, Named("variable") = capability,
+                        Named("value") = valueout, Named("units") = unitsout,
+                        Named("stringsAsFactors") = false);
+
+  return result;
+}
+
+//' Get several variables at several dates from a Hector instance
+//'
+//' The C++ side of \code{fetchvars}: each variable's component is looked up
+//' once, and the results are returned as a single data frame, with all the
+//' dates of the first variable, then all the dates of the second, and so on.
+//'
+//' @param core a Hector instance
+//' @param vars (CharacterVector) capabilities to fetch
+//' @param date (NumericVector or NA) Dates to fetch them at
+//' @noRd
+// [[Rcpp::export]]
+DataFrame fetchvars_impl(Environment core, CharacterVector vars,
+                         NumericVector date) {
+  Hector::Core *hcore = gethcore(core);
+
+  const size_t NV = vars.size();
+  const size_t ND = date.size();
+  std::vector<std::string> varstrs(NV);
+  for (size_t i = 0; i < NV; ++i) {
+    varstrs[i] = as<std::string>(vars[i]);
+  }
+  std::vector<double> dates(ND);
+  for (size_t i = 0; i < ND; ++i) {
+    dates[i] = NumericVector::is_na(date[i]) ? Hector::Core::undefinedIndex()
+                                             : date[i];
+  }
+
+  std::vector<Hector::unitval> results;
+  try {
+    hcore->fetchVars(varstrs, dates, results);
   } catch (h_exception e) {
     std::stringstream emsg;
-    emsg << "sendmessage: " << e;
+    emsg << "fetchvars: " << e;
     Rcpp::stop(emsg.str());
   }
 
-  // Assemble a data frame with the results: date, var, value, units
+  // Fill the columns, making each units name an R string only once
+  NumericVector yearout(NV * ND);
+  CharacterVector varout(NV * ND);
+  NumericVector valueout(NV * ND);
+  CharacterVector unitsout(NV * ND);
+  std::map<Hector::unit_types, String> unitnames;
+  for (size_t v = 0, i = 0; v < NV; ++v) {
+    for (size_t d = 0; d < ND; ++d, ++i) {
+      const Hector::unit_types u = results[i].units();
+      std::map<Hector::unit_types, String>::iterator name = unitnames.find(u);
+      if (name == unitnames.end()) {
+        name = unitnames.insert(std::make_pair(u, String(results[i].unitsName())))
+                   .first;
+      }
+      yearout[i] = date[d];
+      varout[i] = vars[v];
+      valueout[i] = results[i].value(u);
+      unitsout[i] = name->second;
+    }
+  }
+
   DataFrame result =
-      DataFrame::create(Named("year") = date, Named("variable") = capability,
+      DataFrame::create(Named("year") = yearout, Named("variable") = varout,
                         Named("value") = valueout, Named("units") = unitsout,
                         Named("stringsAsFactors") = false);
 
   return result;
 }
 
+//' Temperature response to many forcing trajectories
+//'
+//' Computes the temperature component's response to each forcing trajectory
+//' in one call, by convolving it with the model's impulse response, instead
+//' of running the whole model for each.  Parameters (e.g. \code{S},
+//' \code{diff}) are taken from the core.  A core with a temperature
+//' constraint (\code{TAS_CONSTRAIN}) has to be run with \code{run}; this
+//' function stops with an error instead.
+//'
+//' @param core Handle to the Hector instance.
+//' @param forcing (NumericMatrix) effective forcings, W/m2 (i.e. already
+//' scaled by \code{alpha} and \code{volscl}), one column per trajectory and
+//' one row per year starting at the core's start date.
+//' @return A list of matrices the same shape as \code{forcing}:
+//' \code{global_tas}, \code{land_tas}, \code{sst} (degC), and
+//' \code{heatflux} (W/m2).
+//' @export
+// [[Rcpp::export]]
+List temperature_response(Environment core, NumericMatrix forcing) {
+  Hector::Core *hcore = gethcore(core);
+  Hector::TemperatureComponent *temperature =
+      dynamic_cast<Hector::TemperatureComponent *>(
+          hcore->getComponentByName(TEMPERATURE_COMPONENT_NAME));
+  if (!temperature) {
+    Rcpp::stop("Hector instance has no temperature component");
+  }
+
+  const int years = forcing.nrow();
+  std::vector<std::vector<double>> forcings(forcing.ncol());
+  for (int k = 0; k < forcing.ncol(); ++k) {
+    forcings[k].assign(forcing.column(k).begin(), forcing.column(k).end());
+  }
+
+  std::vector<Hector::TemperatureComponent::batch_result> results;
+  try {
+    results = temperature->run_batch(forcings);
+  } catch (h_exception e) {
+    std::stringstream msg;
+    msg << "Error computing temperature response: " << e;
+    Rcpp::stop(msg.str());
+  }
+
+  NumericMatrix tas(years, forcing.ncol()), tas_land(years, forcing.ncol()),
+      sst(years, forcing.ncol()), heatflux(years, forcing.ncol());
+  for (size_t k = 0; k < results.size(); ++k) {
+    std::copy(results[k].tas.begin(), results[k].tas.end(),
+              tas.column(k).begin());
+    std::copy(results[k].tas_land.begin(), results[k].tas_land.end(),
+              tas_land.column(k).begin());
+    std::copy(results[k].sst.begin(), results[k].sst.end(),
+              sst.column(k).begin());
+    std::copy(results[k].heatflux.begin(), results[k].heatflux.end(),
+              heatflux.column(k).begin());
+  }
+
+  return List::create(Named(D_GLOBAL_TAS) = tas, Named(D_LAND_TAS) = tas_land,
+                      Named(D_SST) = sst, Named(D_HEAT_FLUX) = heatflux);
+}
+
+//' Run a parameter ensemble on native threads
+//'
+//' The C++ side of \code{run_ensemble}.  The input file is parsed once, here
+//' on the R thread; each member is then a core of its own, set up from that
+//' one parsed input set.
+//'
+//' @param inifile (String) name of the hector input file (or scenario bundle)
+//' @param params (CharacterVector) capabilities set for each member
+//' @param units (CharacterVector) units of each parameter
+//' @param values (NumericMatrix) parameter values, one row per member and one
+//' column per parameter
+//' @param vars (CharacterVector) capabilities to fetch
+//' @param date (NumericVector or NA) Dates to fetch them at
+//' @param threads (int) number of threads; 0 uses one per hardware thread
+//' @return A (dates x variables x members) array, with the variables' units
+//' in its \code{units} attribute and each member's error message (NA if it
+//' succeeded) in its \code{errors} attribute.
+//' @noRd
+// [[Rcpp::export]]
+NumericVector run_ensemble_impl(String inifile, CharacterVector params,
+                                CharacterVector units, NumericMatrix values,
+                                CharacterVector vars, NumericVector date,
+                                int threads) {
+  const std::string fn = inifile;
+  const size_t NP = params.size();
+  const size_t NV = vars.size();
+  const size_t ND = date.size();
+  const size_t NM = values.nrow();
+
+  if (size_t(values.ncol()) != NP || size_t(units.size()) != NP) {
+    Rcpp::stop("need one column of values and one unit for each parameter");
+  }
+
+  std::vector<std::string> paramstrs(NP);
+  std::vector<Hector::unit_types> paramunits(NP);
+  for (size_t i = 0; i < NP; ++i) {
+    paramstrs[i] = as<std::string>(params[i]);
+    std::string unitstr = as<std::string>(units[i]);
+    try {
+      paramunits[i] = Hector::unitval::parseUnitsName(unitstr);
+    } catch (h_exception e) {
+      std::stringstream emsg;
+      emsg << "invalid unit type '" << unitstr << "' in input "
+           << paramstrs[i];
+      Rcpp::stop(emsg.str());
+    }
+  }
+  std::vector<std::string> varstrs(NV);
+  for (size_t i = 0; i < NV; ++i) {
+    varstrs[i] = as<std::string>(vars[i]);
+  }
+  std::vector<double> dates(ND);
+  for (size_t i = 0; i < ND; ++i) {
+    dates[i] = NumericVector::is_na(date[i]) ? Hector::Core::undefinedIndex()
+                                             : date[i];
+  }
+  // NumericMatrix is column-major, as the ensemble expects
+  std::vector<double> valuevec(values.begin(), values.end());
+
+  // Parse the inputs once, recording them as they are set
+  Hector::ScenarioBundle inputs;
+  try {
+    Hector::Core parser(Hector::Logger::SEVERE, false, false);
+    parser.init();
+    if (Hector::ScenarioBundle::isBundle(fn)) {
+      parser.setInputRecorder(&inputs);
+      Hector::ScenarioBundle::load(&parser, fn);
+      parser.setInputRecorder(NULL);
+    } else {
+      inputs.record(&parser, fn);
+    }
+  } catch (h_exception e) {
+    std::stringstream msg;
+    msg << "While parsing hector input file " << fn << ": " << e;
+    Rcpp::stop(msg.str());
+  }
+
+  Hector::Ensemble ensemble(inputs, paramstrs, paramunits, varstrs, dates);
+  try {
+    ensemble.run(valuevec, NM, threads < 0 ? 0 : unsigned(threads));
+  } catch (h_exception e) {
+    std::stringstream emsg;
+    emsg << "run_ensemble: " << e;
+    Rcpp::stop(emsg.str());
+  }
+
+  const std::vector<double> &results = ensemble.getResults();
+  NumericVector result(results.begin(), results.end());
+  result.attr("dim") = IntegerVector::create(ND, NV, NM);
+
+  CharacterVector unitsout(NV);
+  for (size_t i = 0; i < NV; ++i) {
+    unitsout[i] = Hector::unitval::unitsName(ensemble.getUnits()[i]);
+  }
+  result.attr("units") = unitsout;
+
+  CharacterVector errorsout(NM);
+  for (size_t i = 0; i < NM; ++i) {
+    const std::string &err = ensemble.getErrors()[i];
+    errorsout[i] = err.empty() ? NA_STRING : String(err);
+  }
+  result.attr("errors") = errorsout;
+
+  return result;
+}
+
 // helper for isactive()
 // [[Rcpp::export]]
 bool chk_core_valid(Environment core) {
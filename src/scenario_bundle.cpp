@@ -0,0 +1,379 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  scenario_bundle.cpp
+ *  hector
+ *
+ *  Compiled (binary) scenario inputs.
+ *
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <stdint.h>
+
+// some boost headers generate warnings under clang; not our problem, ignore
+// 2023 and Boost 1.81.0_1: lexical_cast.hpp still generates many warnings
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#include <boost/lexical_cast.hpp>
+#pragma clang diagnostic pop
+
+#include <boost/algorithm/string/trim.hpp>
+
+#include "component_data.hpp"
+#include "component_names.hpp"
+#include "core.hpp"
+#include "h_util.hpp"
+#include "imodel_component.hpp"
+#include "ini_to_core_reader.hpp"
+#include "scenario_bundle.hpp"
+
+//! First bytes of every bundle
+#define BUNDLE_MAGIC "HSB"
+
+//! Bundle format version. Units are stored as unit_types values, so this
+//! must change whenever that enumeration does.
+#define BUNDLE_VERSION 1
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Bounds-checked reads from a mapped bundle
+ */
+class bundle_cursor {
+public:
+  bundle_cursor(const mapped_file &file, const string &fileName)
+      : pos(file.begin()), end(file.end()), fileName(fileName) {}
+
+  void read(void *out, const size_t n) {
+    H_ASSERT(size_t(end - pos) >= n, fileName + " is truncated");
+    memcpy(out, pos, n);
+    pos += n;
+  }
+
+  template <class T> T get() {
+    T value;
+    read(&value, sizeof(value));
+    return value;
+  }
+
+  string get_string() {
+    const uint32_t n = get<uint32_t>();
+    H_ASSERT(size_t(end - pos) >= n, fileName + " is truncated");
+    const string s(pos, n);
+    pos += n;
+    return s;
+  }
+
+  void get_doubles(vector<double> &v, const uint64_t n) {
+    H_ASSERT(uint64_t(end - pos) / sizeof(double) >= n,
+             fileName + " is truncated");
+    v.resize(n);
+    read(v.data(), n * sizeof(double));
+  }
+
+private:
+  const char *pos;
+  const char *const end;
+  const string fileName;
+};
+
+//------------------------------------------------------------------------------
+/*! \brief Record a setData call
+ *
+ *  Text values are converted the way unitval::parse_unitval would (an
+ *  optional units label, in units_str or after a comma); the expected units
+ *  are left to be checked by the component when the bundle is loaded.  Text
+ *  that isn't a number, and the core's own settings, are kept as text.
+ */
+void ScenarioBundle::recordData(const string &componentName,
+                                const string &varName,
+                                const message_data &data) {
+  entry e;
+  e.component = componentName;
+  e.var = varName;
+  e.date = data.date;
+  e.units = U_UNDEFINED;
+  e.value = 0.0;
+
+  if (data.isVal) {
+    e.kind = E_VALUE;
+    e.units = data.value_unitval.units();
+    e.value = data.value_unitval.value(e.units);
+  } else {
+    e.kind = E_TEXT;
+    e.text = data.value_str;
+    e.units_text = data.units_str;
+
+    if (componentName != CORE_COMPONENT_NAME) {
+      string valueStr = data.value_str;
+      string unitsStr = data.units_str;
+      const size_t comma = valueStr.find(',');
+      if (unitsStr.empty() && comma != string::npos) {
+        unitsStr = valueStr.substr(comma + 1);
+        valueStr.erase(comma);
+      }
+      boost::trim(valueStr);
+      boost::trim(unitsStr);
+      try {
+        e.value = boost::lexical_cast<double>(valueStr);
+        if (!unitsStr.empty()) {
+          e.units = unitval::parseUnitsName(unitsStr);
+        }
+        e.kind = E_VALUE;
+      } catch (boost::bad_lexical_cast &) {
+        // not a number; keep the text
+      } catch (h_exception &) {
+        // unknown units; keep the text, to fail as the INI file would
+      }
+    }
+  }
+  entries.push_back(e);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Record a setSeries call
+ *
+ *  The series' data are shared, not copied.  All its values are expected to
+ *  have the same units (as Core::setSeries gives them).
+ */
+void ScenarioBundle::recordSeries(const string &componentName,
+                                  const string &varName,
+                                  const tseries<unitval> &series) {
+  entry e;
+  e.kind = E_SERIES;
+  e.component = componentName;
+  e.var = varName;
+  e.date = Core::undefinedIndex();
+  e.units = series.size() ? series.begin()->second.units() : U_UNDEFINED;
+  e.value = 0.0;
+  e.series.share(series);
+  entries.push_back(e);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Write the recorded inputs as a bundle
+ *  \param fileName The bundle file to write.
+ *  \exception h_exception If the file can't be written.
+ */
+void ScenarioBundle::write(const string &fileName) const {
+  ofstream out(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+  if (!out) {
+    H_THROW("Could not open " + fileName + " error: " + strerror(errno));
+  }
+
+  out.write(BUNDLE_MAGIC, 4);
+  put_binary(out, uint32_t(BUNDLE_VERSION));
+  put_binary(out, uint32_t(entries.size()));
+
+  for (const entry &e : entries) {
+    put_binary(out, e.kind);
+    put_binary_string(out, e.component);
+    put_binary_string(out, e.var);
+    switch (e.kind) {
+    case E_VALUE:
+      put_binary(out, e.date);
+      put_binary(out, int32_t(e.units));
+      put_binary(out, e.value);
+      break;
+    case E_TEXT:
+      put_binary(out, e.date);
+      put_binary_string(out, e.text);
+      put_binary_string(out, e.units_text);
+      break;
+    case E_SERIES:
+      put_binary(out, int32_t(e.units));
+      put_binary(out, uint64_t(e.series.size()));
+      for (tseries<unitval>::const_iterator it = e.series.begin();
+           it != e.series.end(); ++it) {
+        put_binary(out, it->first);
+      }
+      for (tseries<unitval>::const_iterator it = e.series.begin();
+           it != e.series.end(); ++it) {
+        put_binary(out, it->second.value(e.units));
+      }
+      break;
+    }
+  }
+
+  out.close();
+  if (!out) {
+    H_THROW("Error writing " + fileName);
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compile an INI file (and its CSV tables) to a bundle
+ *  \param core An initialized core; it ends up set up as if the INI file had
+ *              been parsed into it.
+ *  \param iniFile The INI file to compile.
+ *  \param bundleFile The bundle file to write.
+ *  \exception h_exception If the INI file can't be parsed or the bundle
+ *                         can't be written.
+ */
+void ScenarioBundle::compile(Core *core, const string &iniFile,
+                             const string &bundleFile) {
+  ScenarioBundle bundle;
+  bundle.record(core, iniFile);
+  bundle.write(bundleFile);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Parse an INI file into a core, recording its inputs here
+ *  \param core An initialized core; it ends up set up as if the INI file had
+ *              been parsed into it.
+ *  \param iniFile The INI file to record.
+ *  \exception h_exception If the INI file can't be parsed.
+ */
+void ScenarioBundle::record(Core *core, const string &iniFile) {
+  core->setInputRecorder(this);
+  try {
+    INIToCoreReader coreParser(core);
+    coreParser.parse(iniFile);
+  } catch (...) {
+    core->setInputRecorder(NULL);
+    throw;
+  }
+  core->setInputRecorder(NULL);
+
+  for (entry &e : entries) {
+    if (e.kind == E_SERIES && e.units == U_UNDEFINED && e.series.size()) {
+      resolve_units(core, e);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Give a series recorded without units the units its component
+ *         stored it in
+ *
+ *  Input tables usually don't give units, so components convert each such
+ *  series to the units they expect.  Doing that once here, where the
+ *  component can be asked, lets every core the bundle is applied to share
+ *  the series rather than convert a copy.  If the component can't say (or
+ *  reports a value other than the one recorded) the series is left as it is.
+ */
+void ScenarioBundle::resolve_units(Core *core, entry &e) {
+  try {
+    const double date = e.series.firstdate();
+    const unitval stored =
+        core->getComponentByName(e.component)
+            ->sendMessage(M_GETDATA, e.var, message_data(date));
+    if (stored.units() == U_UNDEFINED ||
+        stored.value(stored.units()) != e.series.get(date).value(U_UNDEFINED)) {
+      return;
+    }
+
+    vector<double> dates;
+    vector<double> values;
+    for (tseries<unitval>::const_iterator it = e.series.begin();
+         it != e.series.end(); ++it) {
+      dates.push_back(it->first);
+      values.push_back(it->second.value(U_UNDEFINED));
+    }
+    e.units = stored.units();
+    e.series = make_series(dates, values, e.units);
+  } catch (h_exception &) {
+    // the component doesn't report this variable; leave it be
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Set a core's inputs from the recording held in memory
+ *  \param core An initialized core, as it would be before parsing the INI
+ *              file.
+ *  \exception h_exception Any errors from setData or setSeries are passed
+ *                         along.
+ */
+void ScenarioBundle::apply(Core *core) const {
+  for (const entry &e : entries) {
+    if (e.kind == E_VALUE) {
+      core->setData(e.component, e.var,
+                    message_data(e.date, unitval(e.value, e.units)));
+    } else if (e.kind == E_TEXT) {
+      message_data data;
+      data.date = e.date;
+      data.value_str = e.text;
+      data.units_str = e.units_text;
+      core->setData(e.component, e.var, data);
+    } else {
+      core->setSeries(e.component, e.var, e.series);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Is a file a scenario bundle (rather than an INI file)?
+ */
+bool ScenarioBundle::isBundle(const string &fileName) {
+  ifstream in(fileName.c_str(), ios::in | ios::binary);
+  char magic[4] = {0};
+  in.read(magic, 4);
+  return in && memcmp(magic, BUNDLE_MAGIC, 4) == 0;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Set a core's inputs from a bundle
+ *  \param core An initialized core, as it would be before parsing the INI
+ *              file.
+ *  \param fileName The bundle file.
+ *  \exception h_exception If the file isn't a bundle of this version, or is
+ *                         damaged.  Any errors from setData or setSeries are
+ *                         passed along.
+ */
+void ScenarioBundle::load(Core *core, const string &fileName) {
+  const mapped_file file(fileName);
+  bundle_cursor in(file, fileName);
+
+  char magic[4];
+  in.read(magic, 4);
+  H_ASSERT(memcmp(magic, BUNDLE_MAGIC, 4) == 0,
+           fileName + " is not a scenario bundle");
+  const uint32_t version = in.get<uint32_t>();
+  H_ASSERT(version == BUNDLE_VERSION,
+           fileName + " is bundle version " +
+               boost::lexical_cast<string>(version) + ", expected " +
+               boost::lexical_cast<string>(BUNDLE_VERSION) +
+               "; recompile it from its INI file");
+
+  const uint32_t count = in.get<uint32_t>();
+  vector<double> dates;
+  vector<double> values;
+  for (uint32_t i = 0; i < count; ++i) {
+    const char kind = in.get<char>();
+    const string component = in.get_string();
+    const string var = in.get_string();
+
+    if (kind == E_VALUE) {
+      const double date = in.get<double>();
+      const unit_types units = unit_types(in.get<int32_t>());
+      const double value = in.get<double>();
+      core->setData(component, var, message_data(date, unitval(value, units)));
+    } else if (kind == E_TEXT) {
+      message_data data;
+      data.date = in.get<double>();
+      data.value_str = in.get_string();
+      data.units_str = in.get_string();
+      core->setData(component, var, data);
+    } else if (kind == E_SERIES) {
+      const unit_types units = unit_types(in.get<int32_t>());
+      const uint64_t n = in.get<uint64_t>();
+      in.get_doubles(dates, n);
+      in.get_doubles(values, n);
+      core->setSeries(component, var, dates, values, units);
+    } else {
+      H_THROW(fileName + " is damaged (unknown entry kind)");
+    }
+  }
+}
+
+} // namespace Hector
@@ -31,6 +31,15 @@ namespace Hector {
 
 using namespace boost;
 
+//------------------------------------------------------------------------------
+/*! \brief      A carbon flux input, as a fluxpool
+ *  \param      series the input series
+ *  \param      t date
+ */
+static fluxpool flux_at(const tseries<unitval> &series, const double t) {
+  return fluxpool(series.get(t).value(U_PGC_YR), U_PGC_YR);
+}
+
 //------------------------------------------------------------------------------
 /*! \brief      Log pool states
  *  \param      t date
@@ -941,10 +950,10 @@ void SimpleNbox::slowparameval(double t, const double c[]) {
   // We do this here, and not allow interpolation of their time series,
   // so that pulse tests work correctly (see #643)
   fluxpool zero_flux(0.0, U_PGC_YR);
-  current_luc_e = in_spinup ? zero_flux : lucEmissions.get(t);
-  current_luc_u = in_spinup ? zero_flux : lucUptake.get(t);
-  current_ffi_e = in_spinup ? zero_flux : ffiEmissions.get(t);
-  current_daccs_u = in_spinup ? zero_flux : daccsUptake.get(t);
+  current_luc_e = in_spinup ? zero_flux : flux_at(lucEmissions, t);
+  current_luc_u = in_spinup ? zero_flux : flux_at(lucUptake, t);
+  current_ffi_e = in_spinup ? zero_flux : flux_at(ffiEmissions, t);
+  current_daccs_u = in_spinup ? zero_flux : flux_at(daccsUptake, t);
 
   // Compute loss (or gain) of vegetation to LUC
   npp_luc_adjust = (end_of_spinup_vegc - cum_luc_va) / end_of_spinup_vegc;
@@ -1027,18 +1036,12 @@ void SimpleNbox::slowparameval(double t, const double c[]) {
         f_frozen[biome] = f_frozen_current;
       }
 
-// Soil warm very slowly relative to the atmosphere
-// We use a mean temperature of a window (size Q10_TEMPN) of temperatures to
-// scale Q10
-#define Q10_TEMPLAG 0 // 125         // TODO: put lag in input files 150, 25
-#define Q10_TEMPN 200 // 25
+      // Soil warm very slowly relative to the atmosphere, so Q10 is scaled
+      // by the mean land temperature over a window (q10_twindow years,
+      // ending q10_tlag years ago)
       double Tland_rm = 0.0; /* window mean of Tland */
-      if (t > core->getStartDate() + Q10_TEMPLAG) {
-        for (int i = t - Q10_TEMPLAG - Q10_TEMPN; i < t - Q10_TEMPLAG; i++) {
-          Tland_rm += Tland_record.get(i) * wf;
-        }
-
-        Tland_rm /= Q10_TEMPN;
+      if (t > core->getStartDate() + Tland_record.get_lag()) {
+        Tland_rm = Tland_record.mean(t) * wf;
       }
 
       tempferts[biome] = pow(q10_rh.at(biome), (Tland_rm / 10.0));
@@ -112,7 +112,9 @@ void SimpleNbox::init(Core *coreptr) {
   // Initialize the `biome_list` with just "global"
   biome_list.push_back(SNBOX_DEFAULT_BIOME);
 
-  Tland_record.allowInterp(true);
+  // Soil temperature lags the air: by default Q10 sees the mean land
+  // temperature of the previous 200 years
+  Tland_record.set_window(200, 0);
 
   // Register the data we can provide
   core->registerCapability(D_CO2_CONC, getComponentName());
@@ -155,6 +157,8 @@ void SimpleNbox::init(Core *coreptr) {
   core->registerInput(D_WARMINGFACTOR, getComponentName());
   core->registerInput(D_BETA, getComponentName());
   core->registerInput(D_Q10_RH, getComponentName());
+  core->registerInput(D_Q10_TWINDOW, getComponentName());
+  core->registerInput(D_Q10_TLAG, getComponentName());
   core->registerInput(D_F_NPPV, getComponentName());
   core->registerInput(D_F_NPPD, getComponentName());
   core->registerInput(D_F_LITTERD, getComponentName());
@@ -374,6 +378,20 @@ void SimpleNbox::setData(const std::string &varName, const message_data &data) {
     } else if (varNameParsed == D_Q10_RH) {
       H_ASSERT(data.date == Core::undefinedIndex(), "date not allowed");
       q10_rh[biome] = data.getUnitval(U_UNITLESS);
+    } else if (varNameParsed == D_Q10_TWINDOW) {
+      H_ASSERT(data.date == Core::undefinedIndex(), "date not allowed");
+      H_ASSERT(biome == SNBOX_DEFAULT_BIOME,
+               "Q10 temperature window must be global");
+      Tland_record.set_window(
+          int(data.getUnitval(U_UNITLESS).value(U_UNITLESS)),
+          Tland_record.get_lag());
+    } else if (varNameParsed == D_Q10_TLAG) {
+      H_ASSERT(data.date == Core::undefinedIndex(), "date not allowed");
+      H_ASSERT(biome == SNBOX_DEFAULT_BIOME,
+               "Q10 temperature lag must be global");
+      Tland_record.set_window(
+          Tland_record.get_length(),
+          int(data.getUnitval(U_UNITLESS).value(U_UNITLESS)));
     }
     // Permafrost thaw parameters
     else if (varNameParsed == D_PF_SIGMA) {
@@ -405,6 +423,48 @@ void SimpleNbox::setData(const std::string &varName, const message_data &data) {
   }
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Check a carbon flux input series
+ *
+ *  The values must be valid fluxes (see fluxpool), as they are when set one
+ *  at a time.
+ */
+static void check_flux_series(const tseries<unitval> &series) {
+  for (tseries<unitval>::const_iterator it = series.begin();
+       it != series.end(); ++it) {
+    fluxpool(it->second.value(it->second.units()), U_PGC_YR);
+  }
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void SimpleNbox::setSeries(const std::string &varName,
+                           const tseries<unitval> &series) {
+  try {
+    if (varName == D_FFI_EMISSIONS) {
+      check_flux_series(series);
+      set_series(ffiEmissions, series, U_PGC_YR);
+    } else if (varName == D_DACCS_UPTAKE) {
+      check_flux_series(series);
+      set_series(daccsUptake, series, U_PGC_YR);
+    } else if (varName == D_LUC_EMISSIONS) {
+      check_flux_series(series);
+      set_series(lucEmissions, series, U_PGC_YR);
+    } else if (varName == D_LUC_UPTAKE) {
+      check_flux_series(series);
+      set_series(lucUptake, series, U_PGC_YR);
+    } else if (varName == D_RF_T_ALBEDO) {
+      set_series(Falbedo, series, U_W_M2);
+    } else if (varName == D_NBP_CONSTRAIN) {
+      set_series(NBP_constrain, series, U_PGC_YR);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 /*! \brief      Convert current atmospheric C to [CO2]
  *  \returns    Atmospheric CO2 concentration in ppmv
@@ -423,11 +483,11 @@ fluxpool SimpleNbox::CO2_conc(double time) const {
  *  \returns    Sum of the unitvals in the map
  *  \exception  If the map is empty
  */
-fluxpool SimpleNbox::sum_map(fluxpool_stringmap pool) const {
+fluxpool SimpleNbox::sum_map(const fluxpool_stringmap &pool) const {
   H_ASSERT(pool.size(), "can't sum an empty map");
   fluxpool sum(0.0, pool.begin()->second.units(),
                pool.begin()->second.tracking);
-  for (auto p : pool) {
+  for (const auto &p : pool) {
     H_ASSERT(sum.tracking == (p.second).tracking,
              "tracking mismatch in sum_map function");
     sum = sum + p.second;
@@ -441,10 +501,10 @@ fluxpool SimpleNbox::sum_map(fluxpool_stringmap pool) const {
  *  \returns    Sum of the unitvals in the map
  *  \exception  If the map is empty
  */
-double SimpleNbox::sum_map(double_stringmap pool) const {
+double SimpleNbox::sum_map(const double_stringmap &pool) const {
   H_ASSERT(pool.size(), "can't sum an empty map");
   double sum = 0.0;
-  for (auto p : pool) {
+  for (const auto &p : pool) {
     sum = sum + p.second;
   }
   return sum;
@@ -459,13 +519,11 @@ double SimpleNbox::sum_map(double_stringmap pool) const {
  * If the biome doesn't exist
  */
 fluxpool
-SimpleNbox::sum_fluxpool_biome_ts(const string varName, const double date,
-                                  const string biome, fluxpool_stringmap pool,
-                                  tvector<fluxpool_stringmap> pool_tv) {
+SimpleNbox::sum_fluxpool_biome_ts(const string &varName, const double date,
+                                  const string &biome,
+                                  const fluxpool_stringmap &pool,
+                                  const tvector<fluxpool_stringmap> &pool_tv) {
   fluxpool returnval;
-  std::string biome_error =
-      "Biome '" + biome + "' missing from biome list. " +
-      "Hit this error while trying to retrieve variable: '" + varName + "'.";
 
   if (biome == SNBOX_DEFAULT_BIOME) {
     if (date == Core::undefinedIndex())
@@ -473,7 +531,10 @@ SimpleNbox::sum_fluxpool_biome_ts(const string varName, const double date,
     else
       returnval = sum_map(pool_tv.get(date));
   } else {
-    H_ASSERT(has_biome(biome), biome_error);
+    H_ASSERT(has_biome(biome),
+             "Biome '" + biome + "' missing from biome list. " +
+                 "Hit this error while trying to retrieve variable: '" +
+                 varName + "'.");
     if (date == Core::undefinedIndex())
       returnval = pool.at(biome);
     else
@@ -568,6 +629,14 @@ unitval SimpleNbox::getData(const std::string &varName, const double date) {
   } else if (varNameParsed == D_Q10_RH) {
     H_ASSERT(date == Core::undefinedIndex(), "Date not allowed for Q10");
     returnval = unitval(q10_rh.at(biome), U_UNITLESS);
+  } else if (varNameParsed == D_Q10_TWINDOW) {
+    H_ASSERT(date == Core::undefinedIndex(),
+             "Date not allowed for Q10 temperature window");
+    returnval = unitval(Tland_record.get_length(), U_UNITLESS);
+  } else if (varNameParsed == D_Q10_TLAG) {
+    H_ASSERT(date == Core::undefinedIndex(),
+             "Date not allowed for Q10 temperature lag");
+    returnval = unitval(Tland_record.get_lag(), U_UNITLESS);
   } else if (varNameParsed == D_PF_SIGMA) {
     H_ASSERT(date == Core::undefinedIndex(),
              "Date not allowed for permafrost parameter sigma");
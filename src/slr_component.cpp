@@ -104,8 +104,31 @@ void slrComponent::prepareToRun() {
 }
 
 //------------------------------------------------------------------------------
+/*! \brief         Rate of change of global temperature at a date
+ *  \param[in] date date at which to take the derivative
+ *  \returns        dT/dt, degC/yr
+ *
+ *  This is the derivative of the linearly interpolated temperature series:
+ *  the mean of the slopes on either side of an interior point, and the
+ *  one-sided slope at either end. Only the neighbouring years are read, so
+ *  the cost doesn't grow with the length of the run.
+ */
+double slrComponent::tgav_deriv(const double date) const {
+  if (tgav.size() <= 2) {
+    return 0.0;
+  }
 
-tseries<double> tgav_vals;
+  const double T = tgav.get(date).value(U_DEGC);
+  if (date >= tgav.lastdate()) {
+    return T - tgav.get(date - 1).value(U_DEGC);
+  }
+  const double slopeNext = tgav.get(date + 1).value(U_DEGC) - T;
+  if (date <= tgav.firstdate()) {
+    return slopeNext;
+  }
+  const double slopePrev = T - tgav.get(date - 1).value(U_DEGC);
+  return (slopePrev + slopeNext) / 2.0;
+}
 
 //------------------------------------------------------------------------------
 /*! \brief compute sea-level rise
@@ -119,14 +142,7 @@ void slrComponent::compute_slr(const double date) {
       tgav.get(date) - refperiod_tgav; // temperature relative to 1951-1980 mean
 
   // First need to compute dTdt, the first derivative of the temperature curve
-  double dTdt_double = 0.0;
-  if (tgav.size() > 2) {
-    for (int i = tgav.firstdate(); i <= tgav.lastdate(); i++) {
-      tgav_vals.set(i, tgav.get(i).value(U_DEGC));
-    }
-    tgav_vals.allowInterp(true); // deriv needs a continuous function
-    dTdt_double = tgav_vals.get_deriv(date);
-  }
+  const double dTdt_double = tgav_deriv(date);
 
   // These values and formula below are from:
   // Vermeer, M. and S. Rahmstorf (2009). "Global sea level linked to global
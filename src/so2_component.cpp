@@ -107,6 +107,23 @@ void SulfurComponent::setData(const string &varName, const message_data &data) {
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void SulfurComponent::setSeries(const string &varName,
+                                const tseries<unitval> &series) {
+  try {
+    if (varName == D_EMISSIONS_SO2) {
+      set_series(SO2_emissions, series, U_GG_S);
+    } else if (varName == D_VOLCANIC_SO2) {
+      set_series(SV, series, U_W_M2);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void SulfurComponent::prepareToRun() {
@@ -158,7 +158,7 @@ double seval_forsythe(int n, double u, double *x, double *y, double *b,
 
   H_ASSERT(n && x && y && b && c && d, "seval_forsythe needs nonzero params");
 
-  static int i = 0;
+  thread_local int i = 0;
   int j, k;
   double dx;
 
@@ -215,7 +215,7 @@ double seval_deriv_forsythe(int n, double u, double *x, double *y, double *b,
 
   H_ASSERT(n && x && y && b && c && d, "seval_forsythe needs nonzero params");
 
-  static int i = 0;
+  thread_local int i = 0;
   int j, k;
   double dx;
 
@@ -35,6 +35,7 @@
 #include <boost/lexical_cast.hpp>
 #pragma clang diagnostic pop
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -46,6 +47,7 @@
 
 #include "avisitor.hpp"
 #include "core.hpp"
+#include "h_fft.hpp"
 #include "h_util.hpp"
 #include "simpleNbox.hpp"
 #include "temperature_component.hpp"
@@ -93,6 +95,285 @@ void TemperatureComponent::invert_1d_2x2_matrix(double *x, double *y) {
   return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Fit a sum of exponentials to the ocean diffusion kernel
+ *
+ *  Approximates Ker at lags L = 1..ns-1 by sum_j a_j r_j^L, with decay time
+ *  scales spaced geometrically from a fraction of a year to several times the
+ *  run length. The amplitudes are a least-squares fit (modified Gram-Schmidt
+ *  QR, dropping nearly dependent terms), and terms are added until the summed
+ *  absolute error relative to the summed absolute kernel is within kernel_tol.
+ *  That ratio bounds the error of the SST convolution relative to the largest
+ *  past SST anomaly times the summed kernel. If even max_terms exponentials
+ *  can't meet kernel_tol, the exact convolution with Ker is used instead.
+ */
+void TemperatureComponent::fit_kernel_exponentials() {
+  const int nlag = ns - 1;
+  ker_rate.clear();
+  ker_amp.clear();
+  use_ker_sums = false;
+  if (nlag < 1) {
+    return;
+  }
+
+  std::vector<double> y(nlag);
+  double ysum = 0.0;
+  for (int L = 1; L <= nlag; L++) {
+    y[L - 1] = Ker[L];
+    ysum += fabs(y[L - 1]);
+  }
+
+  const int max_terms = 64;
+  const double tau_min = 0.25;       // yr
+  const double tau_max = 4.0 * nlag; // yr
+  double best_err = numeric_limits<double>::max();
+
+  for (int m = 4; m <= max_terms && best_err > kernel_tol; m += 4) {
+    std::vector<std::vector<double>> Q; // orthonormal basis, one per term
+    std::vector<std::vector<double>> R; // columns of the triangular factor
+    std::vector<double> rate;
+
+    for (int j = 0; j < m; j++) {
+      const double tau = tau_min * pow(tau_max / tau_min, double(j) / (m - 1));
+      const double r = exp(-dt / tau);
+      std::vector<double> v(nlag);
+      double p = 1.0, n0 = 0.0;
+      for (int L = 0; L < nlag; L++) {
+        p *= r;
+        v[L] = p;
+        n0 += p * p;
+      }
+
+      // Orthogonalize against the terms kept so far (twice, for stability)
+      std::vector<double> rcol(Q.size() + 1, 0.0);
+      for (int pass = 0; pass < 2; pass++) {
+        for (size_t k = 0; k < Q.size(); k++) {
+          double d = 0.0;
+          for (int L = 0; L < nlag; L++)
+            d += Q[k][L] * v[L];
+          for (int L = 0; L < nlag; L++)
+            v[L] -= d * Q[k][L];
+          rcol[k] += d;
+        }
+      }
+      double nv = 0.0;
+      for (int L = 0; L < nlag; L++)
+        nv += v[L] * v[L];
+      if (nv <= 1e-18 * n0) {
+        continue; // numerically dependent on the other terms
+      }
+      nv = sqrt(nv);
+      for (int L = 0; L < nlag; L++)
+        v[L] /= nv;
+      rcol.back() = nv;
+      Q.push_back(v);
+      R.push_back(rcol);
+      rate.push_back(r);
+    }
+
+    // Project the kernel onto the basis, then solve R * amp = coefficients
+    const size_t n = Q.size();
+    std::vector<double> amp(n), resid = y;
+    for (size_t k = 0; k < n; k++) {
+      double d = 0.0;
+      for (int L = 0; L < nlag; L++)
+        d += Q[k][L] * resid[L];
+      for (int L = 0; L < nlag; L++)
+        resid[L] -= d * Q[k][L];
+      amp[k] = d;
+    }
+    for (size_t col = n; col-- > 0;) {
+      amp[col] /= R[col][col];
+      for (size_t row = 0; row < col; row++)
+        amp[row] -= R[col][row] * amp[col];
+    }
+
+    // Error of the approximation as it will actually be evaluated
+    std::vector<double> pw(rate);
+    double err = 0.0;
+    for (int L = 0; L < nlag; L++) {
+      double approx = 0.0;
+      for (size_t j = 0; j < n; j++) {
+        approx += amp[j] * pw[j];
+        pw[j] *= rate[j];
+      }
+      err += fabs(approx - y[L]);
+    }
+    err /= ysum;
+
+    if (err < best_err) {
+      best_err = err;
+      ker_rate = rate;
+      ker_amp = amp;
+    }
+  }
+
+  H_LOG(logger, Logger::DEBUG)
+      << "Diffusion kernel approximated by " << ker_amp.size()
+      << " exponentials, relative error " << best_err << std::endl;
+  if (best_err > kernel_tol) {
+    H_LOG(logger, Logger::WARNING)
+        << "Diffusion kernel relative error " << best_err
+        << " exceeds kernel_tol " << kernel_tol
+        << "; using the exact kernel" << std::endl;
+    ker_rate.clear();
+    ker_amp.clear();
+    return;
+  }
+  use_ker_sums = true;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief              Bring the exponential sums up to a timestep
+ *  \param[in] tstep    timestep whose sums are needed (uses
+ *                      temp_sst[0..tstep-1])
+ *
+ *  Normally this is a single step forward; after a reset (or on the first
+ *  call) the sums are rebuilt from the start of the SST history.
+ */
+void TemperatureComponent::update_kernel_sums(int tstep) {
+  if (ker_step < 0 || ker_step > tstep) {
+    ker_sum.assign(ker_amp.size(), 0.0);
+    ker_step = 0;
+  }
+  for (; ker_step < tstep; ker_step++) {
+    for (size_t j = 0; j < ker_amp.size(); j++) {
+      ker_sum[j] = ker_rate[j] * (ker_sum[j] + temp_sst[ker_step]);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief              Diffusion kernel weight at a given lag
+ *  \param[in] lag      years between the SST and the step using it (>= 0)
+ *  \returns            the kernel weight; depends only on the lag, not on
+ *                      the length of the run
+ */
+double TemperatureComponent::kernel_weight(const int lag) const {
+  double KT0, KTA1, KTB1, KTA2, KTB2, KTA3, KTB3;
+
+  // Components of the analytical solution to the integral found in the
+  // temperature difference equation Third order bottom correction terms will be
+  // "more than sufficient" for simulations out to 2500 (Equation A.25, EK05,
+  // or 2.3.23, TK07)
+  if (lag == 0) {
+    // First order
+    KT0 = 4.0 - 2.0 * pow(2.0, 0.5);
+    KTA1 = -8.0 * exp(-taubot / dt) +
+           4.0 * pow(2.0, 0.5) * exp(-0.5 * taubot / dt);
+    KTB1 = 4.0 * pow((M_PI * taubot / dt), 0.5) *
+           (1.0 + erf(pow(0.5 * taubot / dt, 0.5)) -
+            2.0 * erf(pow(taubot / dt, 0.5)));
+
+    // Second order
+    KTA2 = 8.0 * exp(-4.0 * taubot / dt) -
+           4.0 * pow(2.0, 0.5) * exp(-2.0 * taubot / dt);
+    KTB2 = -8.0 * pow((M_PI * taubot / dt), 0.5) *
+           (1.0 + erf(pow((2.0 * taubot / dt), 0.5)) -
+            2.0 * erf(2.0 * pow((taubot / dt), 0.5)));
+
+    // Third order
+    KTA3 = -8.0 * exp(-9.0 * taubot / dt) +
+           4.0 * pow(2.0, 0.5) * exp(-4.5 * taubot / dt);
+    KTB3 = 12.0 * pow((M_PI * taubot / dt), 0.5) *
+           (1.0 + erf(pow((4.5 * taubot / dt), 0.5)) -
+            2.0 * erf(3.0 * pow((taubot / dt), 0.5)));
+  } else {
+    const double n = lag + 1;
+
+    // First order
+    KT0 = 4.0 * pow(n, 0.5) - 2.0 * pow(n + 1.0, 0.5) -
+          2.0 * pow(n - 1.0, 0.5);
+    KTA1 = -8.0 * pow(n, 0.5) * exp(-taubot / dt / n) +
+           4.0 * pow(n + 1.0, 0.5) * exp(-taubot / dt / (n + 1.0)) +
+           4.0 * pow(n - 1.0, 0.5) * exp(-taubot / dt / (n - 1.0));
+    KTB1 = 4.0 * pow((M_PI * taubot / dt), 0.5) *
+           (erf(pow((taubot / dt / (n - 1.0)), 0.5)) +
+            erf(pow((taubot / dt / (n + 1.0)), 0.5)) -
+            2.0 * erf(pow((taubot / dt / n), 0.5)));
+
+    // Second order
+    KTA2 = 8.0 * pow(n, 0.5) * exp(-4.0 * taubot / dt / n) -
+           4.0 * pow(n + 1.0, 0.5) * exp(-4.0 * taubot / dt / (n + 1.0)) -
+           4.0 * pow(n - 1.0, 0.5) * exp(-4.0 * taubot / dt / (n - 1.0));
+    KTB2 = -8.0 * pow((M_PI * taubot / dt), 0.5) *
+           (erf(2.0 * pow((taubot / dt / (n - 1.0)), 0.5)) +
+            erf(2.0 * pow((taubot / dt / (n + 1.0)), 0.5)) -
+            2.0 * erf(2.0 * pow((taubot / dt / n), 0.5)));
+
+    // Third order
+    KTA3 = -8.0 * pow(n, 0.5) * exp(-9.0 * taubot / dt / n) +
+           4.0 * pow(n + 1.0, 0.5) * exp(-9.0 * taubot / dt / (n + 1.0)) +
+           4.0 * pow(n - 1.0, 0.5) * exp(-9.0 * taubot / dt / (n - 1.0));
+    KTB3 = 12.0 * pow((M_PI * taubot / dt), 0.5) *
+           (erf(3.0 * pow((taubot / dt / (n - 1.0)), 0.5)) +
+            erf(3.0 * pow((taubot / dt / (n + 1.0)), 0.5)) -
+            2.0 * erf(3.0 * pow((taubot / dt / n), 0.5)));
+  }
+
+  // Sum up the kernel components
+  return KT0 + KTA1 + KTB1 + KTA2 + KTB2 + KTA3 + KTB3;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief              Make sure the kernel covers lags 0..nlag-1
+ *  \param[in] nlag     number of lags needed
+ *
+ *  Only the missing lags are computed, so extending the kernel a step (or a
+ *  doubling) at a time costs the same in total as computing it once.
+ */
+void TemperatureComponent::extend_kernel(const int nlag) {
+  for (int lag = Ker.size(); lag < nlag; lag++) {
+    Ker.push_back(kernel_weight(lag));
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief              Size the time series arrays
+ *  \param[in] n        number of timesteps to hold
+ */
+void TemperatureComponent::resize_buffers(const int n) {
+  temp.resize(n);
+  temp_landair.resize(n);
+  temp_sst.resize(n);
+  heatflux_mixed.resize(n);
+  heatflux_interior.resize(n);
+  heat_mixed.resize(n);
+  heat_interior.resize(n);
+  forcing.resize(n);
+  lo_temp_landair.resize(
+      n); //!< place to store land temp when lo is provided by users, deg C
+  lo_temp_oceanair.resize(
+      n); //!< place to store land temp when lo is provided by users, deg C
+  lo_sst.resize(
+      n); //!< place to store land temp when lo is provided by users, deg C
+}
+
+//------------------------------------------------------------------------------
+/*! \brief              Grow the time horizon to include a timestep
+ *  \param[in] tstep    timestep about to be run
+ *
+ *  Core::run allows running past endDate; when that happens the arrays and
+ *  kernel are (at least) doubled, so the cost of growing is amortized over
+ *  the steps that use the new space. An exponential kernel approximation is
+ *  refitted to the new horizon.
+ */
+void TemperatureComponent::grow_horizon(const int tstep) {
+  if (tstep < ns) {
+    return;
+  }
+
+  ns = max(tstep + 1, 2 * ns);
+  H_LOG(logger, Logger::DEBUG)
+      << "Growing temperature time horizon to " << ns << " steps" << std::endl;
+  resize_buffers(ns);
+  extend_kernel(ns);
+  if (kernel_tol > 0) {
+    fit_kernel_exponentials();
+    ker_step = -1;
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void TemperatureComponent::init(Core *coreptr) {
@@ -106,6 +387,9 @@ void TemperatureComponent::init(Core *coreptr) {
   flux_interior.set(0.0, U_W_M2, 0.0);
   heatflux.set(0.0, U_W_M2, 0.0);
   lo_warming_ratio.set(0.0, U_UNITLESS, 0.0);
+  kernel_tol = 0.0;
+  use_ker_sums = false;
+  ker_step = -1;
 
   core = coreptr;
 
@@ -140,6 +424,7 @@ void TemperatureComponent::init(Core *coreptr) {
   core->registerInput(D_VOLCANIC_SCALE, getComponentName());
   core->registerInput(D_LO_WARMING_RATIO, getComponentName());
   core->registerInput(D_TAS_CONSTRAIN, getComponentName());
+  core->registerInput(D_KERNEL_TOL, getComponentName());
 }
 
 //------------------------------------------------------------------------------
@@ -191,6 +476,11 @@ void TemperatureComponent::setData(const string &varName,
     } else if (varName == D_LO_WARMING_RATIO) {
       H_ASSERT(data.date == Core::undefinedIndex(), "date not allowed");
       lo_warming_ratio = data.getUnitval(U_UNITLESS);
+    } else if (varName == D_KERNEL_TOL) {
+      H_ASSERT(data.date == Core::undefinedIndex(), "date not allowed");
+      kernel_tol = data.getUnitval(U_UNITLESS).value(U_UNITLESS);
+      H_ASSERT(kernel_tol >= 0.0 && kernel_tol < 1.0,
+               "kernel_tol must be in [0, 1)");
     } else {
       H_THROW("Unknown variable name while parsing " + getComponentName() +
               ": " + varName);
@@ -203,6 +493,21 @@ void TemperatureComponent::setData(const string &varName,
   }
 }
 
+//------------------------------------------------------------------------------
+// documentation is inherited
+void TemperatureComponent::setSeries(const string &varName,
+                                     const tseries<unitval> &series) {
+  try {
+    if (varName == D_TAS_CONSTRAIN) {
+      set_series(tas_constrain, series, U_DEGC);
+    } else {
+      IModelComponent::setSeries(varName, series);
+    }
+  } catch (h_exception &parseException) {
+    H_RETHROW(parseException, "Could not parse var: " + varName);
+  }
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 // TO DO: should we put these in the ini file instead?
@@ -227,33 +532,9 @@ void TemperatureComponent::prepareToRun() {
   }
 
   // Initializing all model components that depend on the number of timesteps
-  // (ns)
+  // (ns); these are grown by grow_horizon() if the model runs past endDate
   ns = core->getEndDate() - core->getStartDate() + 1;
-
-  KT0 = std::vector<double>(ns, 0.0);
-  KTA1 = std::vector<double>(ns, 0.0);
-  KTB1 = std::vector<double>(ns, 0.0);
-  KTA2 = std::vector<double>(ns, 0.0);
-  KTB2 = std::vector<double>(ns, 0.0);
-  KTA3 = std::vector<double>(ns, 0.0);
-  KTB3 = std::vector<double>(ns, 0.0);
-
-  Ker.resize(ns);
-
-  temp.resize(ns);
-  temp_landair.resize(ns);
-  temp_sst.resize(ns);
-  heatflux_mixed.resize(ns);
-  heatflux_interior.resize(ns);
-  heat_mixed.resize(ns);
-  heat_interior.resize(ns);
-  forcing.resize(ns);
-  lo_temp_landair.resize(
-      ns); //!< place to store land temp when lo is provided by users, deg C
-  lo_temp_oceanair.resize(
-      ns); //!< place to store land temp when lo is provided by users, deg C
-  lo_sst.resize(
-      ns); //!< place to store land temp when lo is provided by users, deg C
+  resize_buffers(ns);
 
   for (int i = 0; i < 3; i++) {
     B[i] = 0.0;
@@ -306,83 +587,15 @@ void TemperatureComponent::prepareToRun() {
   taukls = flnd * cal / kls;         // land-sea heat exchange time scale (yr)
 
   // Set up and solve the correction terms for the analytical solution for the
-  // DOECLIM integrands.
-
-  // Set Up
-  // Components of the analytical solution to the integral found in the
-  // temperature difference equation Third order bottom correction terms will be
-  // "more than sufficient" for simulations out to 2500 (Equation A.25, EK05,
-  // or 2.3.23, TK07)
-
-  // First order
-  KT0[ns - 1] = 4.0 - 2.0 * pow(2.0, 0.5);
-  KTA1[ns - 1] =
-      -8.0 * exp(-taubot / dt) + 4.0 * pow(2.0, 0.5) * exp(-0.5 * taubot / dt);
-  KTB1[ns - 1] = 4.0 * pow((M_PI * taubot / dt), 0.5) *
-                 (1.0 + erf(pow(0.5 * taubot / dt, 0.5)) -
-                  2.0 * erf(pow(taubot / dt, 0.5)));
-
-  // Second order
-  KTA2[ns - 1] = 8.0 * exp(-4.0 * taubot / dt) -
-                 4.0 * pow(2.0, 0.5) * exp(-2.0 * taubot / dt);
-  KTB2[ns - 1] = -8.0 * pow((M_PI * taubot / dt), 0.5) *
-                 (1.0 + erf(pow((2.0 * taubot / dt), 0.5)) -
-                  2.0 * erf(2.0 * pow((taubot / dt), 0.5)));
-
-  // Third order
-  KTA3[ns - 1] = -8.0 * exp(-9.0 * taubot / dt) +
-                 4.0 * pow(2.0, 0.5) * exp(-4.5 * taubot / dt);
-  KTB3[ns - 1] = 12.0 * pow((M_PI * taubot / dt), 0.5) *
-                 (1.0 + erf(pow((4.5 * taubot / dt), 0.5)) -
-                  2.0 * erf(3.0 * pow((taubot / dt), 0.5)));
-
-  // Calculate the kernel component vectors
-  for (int i = 0; i < (ns - 1); i++) {
-
-    // First order
-    KT0[i] = 4.0 * pow(double(ns - i), 0.5) -
-             2.0 * pow(double(ns + 1 - i), 0.5) -
-             2.0 * pow(double(ns - 1 - i), 0.5);
-    KTA1[i] =
-        -8.0 * pow(double(ns - i), 0.5) * exp(-taubot / dt / double(ns - i)) +
-        4.0 * pow(double(ns + 1 - i), 0.5) *
-            exp(-taubot / dt / double(ns + 1 - i)) +
-        4.0 * pow(double(ns - 1 - i), 0.5) *
-            exp(-taubot / dt / double(ns - 1 - i));
-    KTB1[i] = 4.0 * pow((M_PI * taubot / dt), 0.5) *
-              (erf(pow((taubot / dt / double(ns - 1 - i)), 0.5)) +
-               erf(pow((taubot / dt / double(ns + 1 - i)), 0.5)) -
-               2.0 * erf(pow((taubot / dt / double(ns - i)), 0.5)));
-
-    // Second order
-    KTA2[i] = 8.0 * pow(double(ns - i), 0.5) *
-                  exp(-4.0 * taubot / dt / double(ns - i)) -
-              4.0 * pow(double(ns + 1 - i), 0.5) *
-                  exp(-4.0 * taubot / dt / double(ns + 1 - i)) -
-              4.0 * pow(double(ns - 1 - i), 0.5) *
-                  exp(-4.0 * taubot / dt / double(ns - 1 - i));
-    KTB2[i] = -8.0 * pow((M_PI * taubot / dt), 0.5) *
-              (erf(2.0 * pow((taubot / dt / double(ns - 1 - i)), 0.5)) +
-               erf(2.0 * pow((taubot / dt / double(ns + 1 - i)), 0.5)) -
-               2.0 * erf(2.0 * pow((taubot / dt / double(ns - i)), 0.5)));
-
-    // Third order
-    KTA3[i] = -8.0 * pow(double(ns - i), 0.5) *
-                  exp(-9.0 * taubot / dt / double(ns - i)) +
-              4.0 * pow(double(ns + 1 - i), 0.5) *
-                  exp(-9.0 * taubot / dt / double(ns + 1 - i)) +
-              4.0 * pow(double(ns - 1 - i), 0.5) *
-                  exp(-9.0 * taubot / dt / double(ns - 1 - i));
-    KTB3[i] = 12.0 * pow((M_PI * taubot / dt), 0.5) *
-              (erf(3.0 * pow((taubot / dt / double(ns - 1 - i)), 0.5)) +
-               erf(3.0 * pow((taubot / dt / double(ns + 1 - i)), 0.5)) -
-               2.0 * erf(3.0 * pow((taubot / dt / double(ns - i)), 0.5)));
-  }
-
-  // Sum up the kernel components
-  for (int i = 0; i < ns; i++) {
-
-    Ker[i] = KT0[i] + KTA1[i] + KTB1[i] + KTA2[i] + KTB2[i] + KTA3[i] + KTB3[i];
+  // DOECLIM integrands, lag by lag (see kernel_weight)
+  Ker.clear();
+  extend_kernel(ns);
+
+  // Optionally replace the convolution with Ker by a recursive approximation
+  ker_step = -1;
+  use_ker_sums = false;
+  if (kernel_tol > 0) {
+    fit_kernel_exponentials();
   }
 
   // Correction terms, remove oscillation artefacts due to short-term forcings
@@ -416,7 +629,7 @@ void TemperatureComponent::prepareToRun() {
   A[1] = dt / (2.0 * taukls) * bsi;
   A[2] = dt / (2.0 * tauksl);
   A[3] = 1.0 - dt / (2.0 * taucfs) - dt / (2.0 * tauksl) * bsi +
-         Ker[ns - 1] * fso * pow((dt / taudif), 0.5);
+         Ker[0] * fso * pow((dt / taudif), 0.5);
 
   // The algorithm to integrate Model
   for (int i = 0; i < 4; i++) {
@@ -448,6 +661,7 @@ void TemperatureComponent::run(const double runToDate) {
 
   // Some needed inputs
   int tstep = runToDate - core->getStartDate();
+  grow_horizon(tstep);
 
   // Calculate the total aresol forcing from aerosol-radiation interactions and
   // the aerosol-cloud interactions so that that total aerosol forcing can be
@@ -474,18 +688,6 @@ void TemperatureComponent::run(const double runToDate) {
                  .value(U_W_M2)) -
       (1.0 - alpha) * aero_forcing - (1.0 - volscl) * volcanic_forcing;
 
-  // Initialize variables for time-stepping through the model
-  double DQ1 = 0.0;
-  double DQ2 = 0.0;
-  double QC1 = 0.0;
-  double QC2 = 0.0;
-  double DelQL = 0.0;
-  double DelQO = 0.0;
-  double DPAST1 = 0.0;
-  double DPAST2 = 0.0;
-  double DTEAUX1 = 0.0;
-  double DTEAUX2 = 0.0;
-
   // Reset the endogenous varibales for this time step
   temp[tstep] = 0.0;
   temp_landair[tstep] = 0.0;
@@ -495,45 +697,21 @@ void TemperatureComponent::run(const double runToDate) {
   heatflux_mixed[tstep] = 0.0;
   heatflux_interior[tstep] = 0.0;
 
-  // Assume land and ocean forcings are equal to global forcing
-  std::vector<double> QL = forcing;
-  std::vector<double> QO = forcing;
-
   if (tstep > 0) {
-
-    DelQL = QL[tstep] - QL[tstep - 1];
-    DelQO = QO[tstep] - QO[tstep - 1];
-
-    // Assume linear forcing change between tstep and tstep+1
-    QC1 = (DelQL / cal * (1.0 / taucfl + 1.0 / taukls) -
-           bsi * DelQO / cas / taukls);
-    QC2 = (DelQO / cas * (1.0 / taucfs + bsi / tauksl) - DelQL / cal / tauksl);
-    QC1 = QC1 * pow(dt, 2.0) / 12.0;
-    QC2 = QC2 * pow(dt, 2.0) / 12.0;
-
-    // ----------------- Initial Conditions --------------------
-    // Initialization of temperature and forcing vector:
-    // Factor 1/2 in front of Q in Equation A.27, EK05, and Equation 2.3.27,
-    // TK07 is a typo! Assumption: linear forcing change between n and n+1
-    DQ1 = 0.5 * dt / cal * (QL[tstep] + QL[tstep - 1]);
-    DQ2 = 0.5 * dt / cas * (QO[tstep] + QO[tstep - 1]);
-    DQ1 = DQ1 + QC1;
-    DQ2 = DQ2 + QC2;
-
-    // ---------- SOLVE MODEL ------------------
-    // Calculate temperatures
-    for (int i = 0; i <= tstep; i++) {
-      DPAST2 = DPAST2 + temp_sst[i] * Ker[ns - tstep + i - 1];
+    // Convolution of the SST history with the diffusion kernel
+    double DPAST2 = 0.0;
+    if (use_ker_sums) {
+      // temp_sst[tstep] is zero here, so only lags >= 1 contribute
+      update_kernel_sums(tstep);
+      for (size_t j = 0; j < ker_amp.size(); j++) {
+        DPAST2 = DPAST2 + ker_amp[j] * ker_sum[j];
+      }
+    } else {
+      for (int i = 0; i <= tstep; i++) {
+        DPAST2 = DPAST2 + temp_sst[i] * Ker[tstep - i];
+      }
     }
-    DPAST2 = DPAST2 * fso * pow((dt / taudif), 0.5);
-
-    DTEAUX1 = A[0] * temp_landair[tstep - 1] + A[1] * temp_sst[tstep - 1];
-    DTEAUX2 = A[2] * temp_landair[tstep - 1] + A[3] * temp_sst[tstep - 1];
-
-    temp_landair[tstep] =
-        IB[0] * (DQ1 + DPAST1 + DTEAUX1) + IB[1] * (DQ2 + DPAST2 + DTEAUX2);
-    temp_sst[tstep] =
-        IB[2] * (DQ1 + DPAST1 + DTEAUX1) + IB[3] * (DQ2 + DPAST2 + DTEAUX2);
+    doeclim_step(tstep, forcing, DPAST2, temp_landair, temp_sst);
   } else { // Handle the initial conditions
     temp_landair[0] = 0.0;
     temp_sst[0] = 0.0;
@@ -563,9 +741,19 @@ void TemperatureComponent::run(const double runToDate) {
   // ------------------------------------------------------------------------
   if (tstep > 0) {
     heatflux_mixed[tstep] = cas * (temp_sst[tstep] - temp_sst[tstep - 1]);
-    for (int i = 0; i < tstep; i++) {
-      heatflux_interior[tstep] =
-          heatflux_interior[tstep] + temp_sst[i] * Ker[ns - tstep + i];
+    if (use_ker_sums) {
+      // Lag zero (temp_sst[tstep-1]) uses Ker[0] exactly; lags 1..tstep-1
+      // are the exponential sums one step back, S_j(tstep)/r_j - T[tstep-1]
+      heatflux_interior[tstep] = temp_sst[tstep - 1] * Ker[0];
+      for (size_t j = 0; j < ker_amp.size(); j++) {
+        heatflux_interior[tstep] +=
+            ker_amp[j] * (ker_sum[j] / ker_rate[j] - temp_sst[tstep - 1]);
+      }
+    } else {
+      for (int i = 0; i < tstep; i++) {
+        heatflux_interior[tstep] =
+            heatflux_interior[tstep] + temp_sst[i] * Ker[tstep - 1 - i];
+      }
     }
     heatflux_interior[tstep] =
         cas * fso / pow((taudif * dt), 0.5) *
@@ -588,6 +776,220 @@ void TemperatureComponent::run(const double runToDate) {
       << " tas=" << tas << " in " << runToDate << std::endl;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief                Solve for land air and sea surface temperatures
+ *  \param[in] tstep      timestep to solve for (> 0)
+ *  \param[in] Q          forcing history, W/m2; land and ocean forcings are
+ *                        assumed equal to it
+ *  \param[in] past       convolution of the SST history with the diffusion
+ *                        kernel, before scaling
+ *  \param[in,out] tl     land air temperatures; tl[tstep] is set
+ *  \param[in,out] ts     sea surface temperatures; ts[tstep] is set
+ */
+void TemperatureComponent::doeclim_step(const int tstep,
+                                        const std::vector<double> &Q,
+                                        const double past,
+                                        std::vector<double> &tl,
+                                        std::vector<double> &ts) const {
+  // Initialize variables for time-stepping through the model
+  double DQ1 = 0.0;
+  double DQ2 = 0.0;
+  double QC1 = 0.0;
+  double QC2 = 0.0;
+  double DelQL = 0.0;
+  double DelQO = 0.0;
+  double DPAST1 = 0.0;
+  double DPAST2 = 0.0;
+  double DTEAUX1 = 0.0;
+  double DTEAUX2 = 0.0;
+
+  // Assume land and ocean forcings are equal to global forcing
+  const std::vector<double> &QL = Q;
+  const std::vector<double> &QO = Q;
+
+  DelQL = QL[tstep] - QL[tstep - 1];
+  DelQO = QO[tstep] - QO[tstep - 1];
+
+  // Assume linear forcing change between tstep and tstep+1
+  QC1 = (DelQL / cal * (1.0 / taucfl + 1.0 / taukls) -
+         bsi * DelQO / cas / taukls);
+  QC2 = (DelQO / cas * (1.0 / taucfs + bsi / tauksl) - DelQL / cal / tauksl);
+  QC1 = QC1 * pow(dt, 2.0) / 12.0;
+  QC2 = QC2 * pow(dt, 2.0) / 12.0;
+
+  // ----------------- Initial Conditions --------------------
+  // Initialization of temperature and forcing vector:
+  // Factor 1/2 in front of Q in Equation A.27, EK05, and Equation 2.3.27,
+  // TK07 is a typo! Assumption: linear forcing change between n and n+1
+  DQ1 = 0.5 * dt / cal * (QL[tstep] + QL[tstep - 1]);
+  DQ2 = 0.5 * dt / cas * (QO[tstep] + QO[tstep - 1]);
+  DQ1 = DQ1 + QC1;
+  DQ2 = DQ2 + QC2;
+
+  // ---------- SOLVE MODEL ------------------
+  // Calculate temperatures
+  DPAST2 = past * fso * pow((dt / taudif), 0.5);
+
+  DTEAUX1 = A[0] * tl[tstep - 1] + A[1] * ts[tstep - 1];
+  DTEAUX2 = A[2] * tl[tstep - 1] + A[3] * ts[tstep - 1];
+
+  tl[tstep] =
+      IB[0] * (DQ1 + DPAST1 + DTEAUX1) + IB[1] * (DQ2 + DPAST2 + DTEAUX2);
+  ts[tstep] =
+      IB[2] * (DQ1 + DPAST1 + DTEAUX1) + IB[3] * (DQ2 + DPAST2 + DTEAUX2);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief                Step-by-step DOECLIM response to a forcing series
+ *  \param[in] Q          forcing, W/m2, one value per year from the start date
+ *  \param[out] tl        land air temperatures, deg C
+ *  \param[out] ts        sea surface temperatures, deg C
+ *  \param[out] hflux     total heat flux into the ocean, W/m2
+ *
+ *  Uses the exact kernel and ignores any temperature constraint; the state
+ *  of the component is not touched.
+ */
+void TemperatureComponent::doeclim_response(const std::vector<double> &Q,
+                                            std::vector<double> &tl,
+                                            std::vector<double> &ts,
+                                            std::vector<double> &hflux) const {
+  const int n = Q.size();
+  tl.assign(n, 0.0);
+  ts.assign(n, 0.0);
+  hflux.assign(n, 0.0);
+
+  for (int t = 1; t < n; t++) {
+    double past = 0.0;
+    for (int i = 0; i < t; i++) {
+      past = past + ts[i] * Ker[t - i];
+    }
+    doeclim_step(t, Q, past, tl, ts);
+
+    double interior = 0.0;
+    for (int i = 0; i < t; i++) {
+      interior = interior + ts[i] * Ker[t - 1 - i];
+    }
+    interior = cas * fso / pow((taudif * dt), 0.5) * (2.0 * ts[t] - interior);
+    hflux[t] = cas * (ts[t] - ts[t - 1]) + fso * interior;
+  }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief                Temperature response to many forcing trajectories
+ *  \param[in] forcings   forcing trajectories, W/m2, each starting at the
+ *                        model start date with one value per year; these are
+ *                        effective forcings, i.e. already adjusted by alpha
+ *                        and volscl
+ *  \returns              one batch_result per trajectory, of the same length
+ *  \exception            if prepareToRun hasn't been called, or if a
+ *                        temperature constraint is set
+ *
+ *  DOECLIM is linear in forcing, so with no temperature constraint the
+ *  response is a convolution. A constrained core has to be run step by step,
+ *  so rather than return a response that disagrees with run(), this refuses. The impulse responses are computed once with
+ *  the step-by-step solver; each trajectory then costs a few FFTs of twice
+ *  its length rather than a full model run. The first year's forcing has
+ *  its own response, because the model starts from zero anomaly whatever it
+ *  is. Results match the step-by-step path to round-off.
+ */
+std::vector<TemperatureComponent::batch_result> TemperatureComponent::run_batch(
+    const std::vector<std::vector<double>> &forcings) {
+  H_ASSERT(!Ker.empty(), "run_batch requires prepareToRun");
+  H_ASSERT(tas_constrain.size() == 0,
+           "run_batch can't apply a temperature constraint; use run()");
+
+  size_t n = 0;
+  for (size_t k = 0; k < forcings.size(); k++) {
+    n = max(n, forcings[k].size());
+  }
+  extend_kernel(n);
+
+  std::vector<batch_result> results(forcings.size());
+  if (n < 2) {
+    for (size_t k = 0; k < forcings.size(); k++) {
+      const size_t len = forcings[k].size();
+      results[k].tas.assign(len, 0.0);
+      results[k].tas_land.assign(len, 0.0);
+      results[k].sst.assign(len, 0.0);
+      results[k].heatflux.assign(len, 0.0);
+    }
+    return results;
+  }
+
+  // Responses to unit forcing in the first year (r0) and in the second (r1);
+  // by time invariance r1 gives the response to any later year, shifted.
+  std::vector<double> impulse(n, 0.0), tl0, ts0, hf0, tl1, ts1, hf1;
+  impulse[0] = 1.0;
+  doeclim_response(impulse, tl0, ts0, hf0);
+  impulse[0] = 0.0;
+  impulse[1] = 1.0;
+  doeclim_response(impulse, tl1, ts1, hf1);
+
+  // Transform the year-1 responses; land and sea temperatures share one
+  // complex series (real and imaginary parts) since both are real
+  const size_t m = n - 1;
+  const h_fft fft(h_fft::length_for(2 * m - 1));
+  const size_t len = fft.size();
+  std::vector<complex<double>> H_temp(len), H_flux(len);
+  for (size_t j = 0; j < m; j++) {
+    H_temp[j] = complex<double>(tl1[j + 1], ts1[j + 1]);
+    H_flux[j] = hf1[j + 1];
+  }
+  fft.forward(H_temp);
+  fft.forward(H_flux);
+
+  std::vector<complex<double>> G(len), X_temp(len), X_flux(len);
+  for (size_t k = 0; k < forcings.size(); k++) {
+    const std::vector<double> &F = forcings[k];
+    const size_t nk = F.size();
+    batch_result &res = results[k];
+    res.tas.assign(nk, 0.0);
+    res.tas_land.assign(nk, 0.0);
+    res.sst.assign(nk, 0.0);
+    res.heatflux.assign(nk, 0.0);
+    if (nk == 0) {
+      continue;
+    }
+
+    std::fill(G.begin(), G.end(), complex<double>(0.0, 0.0));
+    for (size_t j = 1; j < nk; j++) {
+      G[j - 1] = F[j];
+    }
+    fft.forward(G);
+    for (size_t i = 0; i < len; i++) {
+      X_temp[i] = H_temp[i] * G[i];
+      X_flux[i] = H_flux[i] * G[i];
+    }
+    fft.inverse(X_temp);
+    fft.inverse(X_flux);
+
+    for (size_t t = 0; t < nk; t++) {
+      double tl = F[0] * tl0[t];
+      double ts = F[0] * ts0[t];
+      double hf = F[0] * hf0[t];
+      if (t > 0) {
+        tl += X_temp[t - 1].real();
+        ts += X_temp[t - 1].imag();
+        hf += X_flux[t - 1].real();
+      }
+      res.tas[t] = flnd * tl + (1.0 - flnd) * bsi * ts;
+      res.tas_land[t] = tl;
+      res.sst[t] = ts;
+      res.heatflux[t] = hf;
+
+      // Same override as setoutputs()
+      if (lo_warming_ratio != 0) {
+        const double oceanair =
+            res.tas[t] / ((lo_warming_ratio * flnd) + (1 - flnd));
+        res.tas_land[t] = oceanair * lo_warming_ratio;
+        res.sst[t] = oceanair / bsi;
+      }
+    }
+  }
+
+  return results;
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 unitval TemperatureComponent::getData(const std::string &varName,
@@ -703,6 +1105,10 @@ unitval TemperatureComponent::getData(const std::string &varName,
              "Date not allowed for land ocean warming ratio");
     returnval = lo_warming_ratio;
     return returnval;
+  } else if (varName == D_KERNEL_TOL) {
+    H_ASSERT(date == Core::undefinedIndex(),
+             "Date not allowed for kernel tolerance");
+    returnval = unitval(kernel_tol, U_UNITLESS);
   } else {
     H_THROW("Caller is requesting unknown variable: " + varName);
   }
@@ -722,6 +1128,9 @@ void TemperatureComponent::reset(double time) {
 
   int tstep = time - core->getStartDate();
   setoutputs(tstep);
+
+  // The exponential sums are rebuilt from the stored SST history on demand
+  ker_step = -1;
   H_LOG(logger, Logger::NOTICE)
       << getComponentName() << " reset to time= " << time << "\n";
 }
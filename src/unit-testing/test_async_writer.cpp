@@ -0,0 +1,56 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_async_writer.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "async_writer.hpp"
+#include "h_exception.hpp"
+
+using namespace Hector;
+
+TEST(AsyncWriterTest, WritesBlocksInOrder) {
+    std::ostringstream out;
+    std::string expected;
+    {
+        // a small queue, so writes regularly wait for the writer
+        AsyncWriter writer(out, 2);
+        std::string block;
+        for(int i = 0; i < 1000; i++) {
+            block = std::to_string(i) + ",";
+            expected += block;
+            writer.write(block);
+            EXPECT_TRUE(block.empty());
+        }
+        writer.flush();
+        EXPECT_EQ(out.str(), expected);
+
+        block = "last";
+        expected += block;
+        writer.write(block);
+    }
+    // the destructor writes anything still queued
+    EXPECT_EQ(out.str(), expected);
+}
+
+TEST(AsyncWriterTest, ReportsWriteErrors) {
+    std::ostringstream out;
+    out.setstate(std::ios::badbit);
+    AsyncWriter writer(out);
+    std::string block = "lost";
+    writer.write(block);
+    EXPECT_THROW(writer.flush(), h_exception);
+    // still reported, and the destructor doesn't throw
+    EXPECT_THROW(writer.flush(), h_exception);
+}
@@ -0,0 +1,55 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_atmos_chemistry.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "component_data.hpp"
+#include "component_names.hpp"
+#include "core.hpp"
+#include "message_data.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+namespace {
+
+void run_ssp245(Core &core, const bool fused) {
+    setup_ssp245_core(core, false);
+    core.setData(CORE_COMPONENT_NAME, D_FUSED_CHEMISTRY,
+                 message_data(unitval(fused ? 1 : 0, U_UNDEFINED)));
+    core.prepareToRun();
+    core.run();
+}
+
+} // namespace
+
+// The fused chemistry step advances the species in the order the separate
+// components run, so every year must come out exactly the same
+TEST(AtmosChemistryTest, FusedMatchesUnfused) {
+    Core unfused(Logger::SEVERE, false, false);
+    run_ssp245(unfused, false);
+
+    Core fused(Logger::SEVERE, false, false);
+    run_ssp245(fused, true);
+
+    const char *vars[] = {D_CH4_CONC, D_LIFETIME_OH, D_ATMOSPHERIC_O3, D_N2O_CONC};
+    for (double date = unfused.getStartDate() + 1; date <= unfused.getEndDate(); date += 1.0) {
+        const message_data when(date);
+        for (const char *var : vars) {
+            const unitval expected = unfused.sendMessage(M_GETDATA, var, when);
+            const unitval actual = fused.sendMessage(M_GETDATA, var, when);
+            ASSERT_EQ(actual.units(), expected.units()) << var;
+            EXPECT_EQ(actual.value(actual.units()), expected.value(expected.units()))
+                << var << " " << date;
+        }
+    }
+}
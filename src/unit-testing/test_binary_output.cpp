@@ -0,0 +1,198 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_binary_output.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "binary_output_visitor.hpp"
+#include "component_data.hpp"
+#include "core.hpp"
+#include "csv_outputstream_visitor.hpp"
+#include "h_exception.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+namespace {
+
+// A column read back from a binary output file
+struct column {
+    std::string name;
+    std::string units;
+    std::vector<double> values;
+};
+
+template <class T> T get(std::istream &in) {
+    T value;
+    in.read(reinterpret_cast<char *>(&value), sizeof(value));
+    return value;
+}
+
+std::string get_string(std::istream &in) {
+    std::string s(get<uint32_t>(in), '\0');
+    in.read(&s[0], s.size());
+    return s;
+}
+
+// Read a file in the layout documented in BinaryOutputVisitor
+std::vector<column> read_columns(const std::string &fileName) {
+    std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+    char magic[4];
+    in.read(magic, 4);
+    EXPECT_EQ(std::string(magic, 4), "HCOL");
+    EXPECT_EQ(get<uint32_t>(in), 1);
+    std::vector<column> columns(get<uint32_t>(in));
+    const uint64_t rows = get<uint64_t>(in);
+    for (column &c : columns) {
+        c.name = get_string(in);
+        c.units = get_string(in);
+        EXPECT_EQ(get<char>(in), 'd');
+    }
+    for (column &c : columns) {
+        c.values.resize(rows);
+        in.read(reinterpret_cast<char *>(c.values.data()), rows * sizeof(double));
+    }
+    EXPECT_TRUE(in.good());
+    EXPECT_EQ(in.peek(), EOF);
+    return columns;
+}
+
+class BinaryOutputTest : public testing::Test {
+protected:
+    BinaryOutputTest() : core(Logger::SEVERE, false, false), fileName("test_binary_output.bin") {}
+
+    virtual void SetUp() {
+        setup_ssp245_core(core, false);
+    }
+
+    virtual void TearDown() {
+        std::remove(fileName.c_str());
+    }
+
+    Core core;
+    const std::string fileName;
+};
+
+} // namespace
+
+// Every value written must be the one the CSV output shows for that year,
+// to the CSV's precision
+TEST_F(BinaryOutputTest, MatchesCSVOutput) {
+    std::vector<std::string> variables;
+    variables.push_back(D_GLOBAL_TAS);
+    variables.push_back(D_CO2_CONC);
+    variables.push_back(D_HEAT_FLUX);
+    BinaryOutputVisitor binary(fileName, variables);
+    std::ostringstream csv;
+    CSVOutputStreamVisitor csvVisitor(csv);
+    core.addVisitor(&binary);
+    core.addVisitor(&csvVisitor);
+    core.prepareToRun();
+    core.run();
+    csvVisitor.flush();
+    binary.write();
+
+    // (variable, year) -> (value, units) of the non-spinup CSV rows
+    std::map<std::pair<std::string, double>, std::pair<std::string, std::string>> expected;
+    std::istringstream lines(csv.str());
+    std::string line;
+    std::getline(lines, line); // version comment
+    std::getline(lines, line); // column names
+    while (std::getline(lines, line)) {
+        std::vector<std::string> cells;
+        std::istringstream cellStream(line);
+        std::string cell;
+        while (std::getline(cellStream, cell, ',')) {
+            cells.push_back(cell);
+        }
+        ASSERT_EQ(cells.size(), 7) << line;
+        if (cells[2] == "0") {
+            expected[std::make_pair(cells[4], std::atof(cells[0].c_str()))] =
+                std::make_pair(cells[5], cells[6]);
+        }
+    }
+
+    const std::vector<column> columns = read_columns(fileName);
+    ASSERT_EQ(columns.size(), variables.size() + 1);
+    EXPECT_EQ(columns[0].name, "year");
+    const std::vector<double> &years = columns[0].values;
+    ASSERT_EQ(years.size(), core.getEndDate() - core.getStartDate());
+    EXPECT_EQ(years.front(), core.getStartDate() + 1);
+    EXPECT_EQ(years.back(), core.getEndDate());
+    for (size_t i = 0; i < variables.size(); ++i) {
+        const column &c = columns[i + 1];
+        EXPECT_EQ(c.name, variables[i]);
+        for (size_t t = 0; t < years.size(); ++t) {
+            const auto row = expected.find(std::make_pair(c.name, years[t]));
+            ASSERT_TRUE(row != expected.end()) << c.name << " " << years[t];
+            EXPECT_EQ(c.units, row->second.second);
+            // the CSV has six significant digits (four once the forcing
+            // component has been written, see CSVOutputStreamVisitor)
+            std::ostringstream six, four;
+            six << std::setprecision(6) << c.values[t];
+            four << std::setprecision(4) << c.values[t];
+            EXPECT_TRUE(row->second.first == six.str() || row->second.first == four.str())
+                << c.name << " " << years[t] << ": " << c.values[t] << " written as "
+                << row->second.first;
+        }
+    }
+}
+
+// A variable that can't be recorded fails the run, without leaving the
+// columns misaligned
+TEST_F(BinaryOutputTest, FailedVisitKeepsColumnsAligned) {
+    std::vector<std::string> variables;
+    variables.push_back(D_GLOBAL_TAS);
+    variables.push_back(D_ECS); // a parameter, not a time series
+    BinaryOutputVisitor binary(fileName, variables);
+    core.addVisitor(&binary);
+    core.prepareToRun();
+    EXPECT_THROW(core.run(), h_exception);
+    binary.write();
+
+    const std::vector<column> columns = read_columns(fileName);
+    ASSERT_EQ(columns.size(), 3);
+    for (const column &c : columns) {
+        EXPECT_TRUE(c.values.empty()) << c.name;
+    }
+}
+
+// Unknown variables are an error before the run starts
+TEST_F(BinaryOutputTest, RejectsUnknownVariables) {
+    std::vector<std::string> variables(1, "no_such_variable");
+    BinaryOutputVisitor binary(fileName, variables);
+    core.addVisitor(&binary);
+    EXPECT_THROW(core.prepareToRun(), h_exception);
+}
+
+// A file that can't be written is an error from write(); the destructor only
+// logs it, as it mustn't throw
+TEST_F(BinaryOutputTest, WriteErrors) {
+    std::vector<std::string> variables(1, D_GLOBAL_TAS);
+    {
+        BinaryOutputVisitor binary("no_such_directory/" + fileName, variables);
+        core.addVisitor(&binary);
+        core.prepareToRun();
+        core.run(1760);
+        EXPECT_THROW(binary.write(), h_exception);
+    }
+}
@@ -0,0 +1,108 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_carbon_cycle_solver.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "component_data.hpp"
+#include "core.hpp"
+#include "h_exception.hpp"
+#include "message_data.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+namespace {
+
+const char *SOLVER_STATS[] = {D_SOLVER_RHS_EVALS, D_SOLVER_ACCEPTED_STEPS,
+                              D_SOLVER_REJECTED_STEPS, D_SOLVER_RETRIES,
+                              D_SOLVER_FINAL_DT, D_OCEAN_MAX_TIMESTEP};
+
+class CarbonCycleSolverTest : public testing::Test {
+protected:
+    CarbonCycleSolverTest() : core(Logger::SEVERE, false, false) {}
+
+    virtual void SetUp() {
+        setup_ssp245_core(core);
+    }
+
+    // The statistics of each year from first through last
+    std::map<double, std::vector<double>> fetch_stats(double first, double last) {
+        std::map<double, std::vector<double>> stats;
+        for (double date = first; date <= last; date += 1.0) {
+            for (const char *var : SOLVER_STATS) {
+                const unitval stat = core.sendMessage(M_GETDATA, var, message_data(date));
+                stats[date].push_back(stat.value(stat.units()));
+            }
+        }
+        return stats;
+    }
+
+    Core core;
+};
+
+} // namespace
+
+// Each year's statistics are recorded, and are plausible counts and steps
+TEST_F(CarbonCycleSolverTest, RecordsStatistics) {
+    core.run(2100);
+
+    for (const char *var : SOLVER_STATS) {
+        // undated, they're the last step's
+        const unitval current = core.sendMessage(M_GETDATA, var);
+        const unitval last = core.sendMessage(M_GETDATA, var, message_data(2100));
+        EXPECT_EQ(current.units(), last.units()) << var;
+        EXPECT_EQ(current.value(current.units()), last.value(last.units())) << var;
+    }
+
+    const std::map<double, std::vector<double>> stats =
+        fetch_stats(core.getStartDate() + 1, 2100);
+    for (const auto &year : stats) {
+        const std::vector<double> &s = year.second;
+        const double evals = s[0], accepted = s[1], rejected = s[2], retries = s[3];
+        const double final_dt = s[4], max_timestep = s[5];
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(s[i], std::floor(s[i])) << SOLVER_STATS[i] << " " << year.first;
+        }
+        EXPECT_GE(accepted, 1) << year.first;
+        EXPECT_GE(rejected, 0) << year.first;
+        EXPECT_GE(retries, 0) << year.first;
+        // every step tried takes at least one evaluation
+        EXPECT_GE(evals, accepted + rejected) << year.first;
+        // the proposed next step, which may be longer than a year
+        EXPECT_GT(final_dt, 0) << year.first;
+        EXPECT_GT(max_timestep, 0) << year.first;
+        EXPECT_LE(max_timestep, 1) << year.first;
+    }
+}
+
+// A reset drops the statistics after the reset date, and a rerun (starting
+// from the stepsize the solver had then) records them again as they were
+TEST_F(CarbonCycleSolverTest, ResetTruncatesStatistics) {
+    core.run(2100);
+    const std::map<double, std::vector<double>> original =
+        fetch_stats(core.getStartDate() + 1, 2100);
+
+    core.reset(2000);
+    for (const char *var : SOLVER_STATS) {
+        EXPECT_NO_THROW(core.sendMessage(M_GETDATA, var, message_data(2000))) << var;
+        EXPECT_THROW(core.sendMessage(M_GETDATA, var, message_data(2001)), h_exception) << var;
+    }
+    const std::map<double, std::vector<double>> kept(original.begin(), original.find(2001));
+    EXPECT_EQ(fetch_stats(core.getStartDate() + 1, 2000), kept);
+
+    core.run(2100);
+    EXPECT_EQ(fetch_stats(core.getStartDate() + 1, 2100), original);
+}
@@ -19,6 +19,7 @@
 #include "core.hpp"
 #include "dummy_model_component.hpp"
 #include "avisitor.hpp"
+#include "component_data.hpp"
 
 using namespace Hector;
 
@@ -77,6 +78,26 @@ protected:
         
         bool didVisit;
     };
+    
+    class CheckCurrentDateVisitor: public AVisitor {
+    public:
+        CheckCurrentDateVisitor():visitDate( -1 ) {
+        }
+        
+        virtual bool shouldVisit( const bool in_spinup, const double date ) {
+            visitDate = date;
+            return true;
+        }
+        
+        virtual void visit( Core* core ) {
+            visitDates.push_back( visitDate );
+            coreDates.push_back( core->getCurrentDate() );
+        }
+        
+        double visitDate;
+        std::vector<double> visitDates;
+        std::vector<double> coreDates;
+    };
 };
 
 TEST_F(TestCore, InitCreatesComponents) {
@@ -152,8 +173,85 @@ TEST_F(TestCore, DoesCheckShouldVisit) {
     ASSERT_FALSE( checkVisitor.didVisit );
 }
 
+TEST_F(TestCore, CurrentDateIsVisitedDate) {
+    // Visitors run once the components have finished a date, so the core's
+    // current date is already the date being visited
+    CheckCurrentDateVisitor checkVisitor;
+    Core core(Logger::SEVERE, false, false);
+    core.setData("core", "startDate", unitval(1, U_UNDEFINED));
+    core.setData("core", "endDate", unitval(5, U_UNDEFINED));
+    core.addVisitor( &checkVisitor );
+    core.run();
+    
+    // the initial state plus dates 2 through 5
+    ASSERT_EQ( checkVisitor.visitDates.size(), 5 );
+    for( size_t i = 0; i < checkVisitor.visitDates.size(); ++i ) {
+        EXPECT_EQ( checkVisitor.visitDates[i], i + 1 );
+        EXPECT_EQ( checkVisitor.coreDates[i], checkVisitor.visitDates[i] );
+    }
+}
+
 TEST_F(TestCore, CanNotAddCompAfterInit) {
     Core core(Logger::SEVERE, false, false);
     core.init();
     ASSERT_THROW( core.addModelComponent( new DummyModelComponent ), h_exception );
 }
+
+TEST_F(TestCore, FetchVars) {
+    Core core(Logger::SEVERE, false, false);
+    std::vector<std::string> vars(1, D_TRACKING_DATE);
+    std::vector<double> dates(1, Core::undefinedIndex());
+    std::vector<unitval> results;
+    EXPECT_THROW(core.fetchVars(vars, dates, results), h_exception);
+
+    core.init();
+    core.setData("core", "trackingDate", unitval(1900, U_UNDEFINED));
+    core.fetchVars(vars, dates, results);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].value(U_UNITLESS), 1900);
+    EXPECT_EQ(results[0].value(U_UNITLESS),
+              core.sendMessage(M_GETDATA, D_TRACKING_DATE).value(U_UNITLESS));
+
+    vars.push_back("not-a-variable");
+    EXPECT_THROW(core.fetchVars(vars, dates, results), h_exception);
+}
+
+TEST_F(TestCore, ProfilesOnlyWhenEnabled) {
+    Core core(Logger::SEVERE, false, false);
+    core.init();
+    core.setData("core", "trackingDate", unitval(1900, U_UNDEFINED));
+    const std::pair<std::string, std::string> key(D_TRACKING_DATE, PROFILE_MESSAGE);
+
+    core.sendMessage(M_GETDATA, D_TRACKING_DATE);
+    EXPECT_TRUE(core.getProfiler().getEntries().empty());
+
+    core.getProfiler().enable(true);
+    core.sendMessage(M_GETDATA, D_TRACKING_DATE);
+    core.sendMessage(M_GETDATA, D_TRACKING_DATE);
+    ASSERT_EQ(core.getProfiler().getEntries().count(key), 1);
+    EXPECT_EQ(core.getProfiler().getEntries().at(key).calls, 2);
+    EXPECT_GE(core.getProfiler().getEntries().at(key).seconds, 0);
+
+    core.getProfiler().clear();
+    EXPECT_EQ(core.getProfiler().getEntries().at(key).calls, 0);
+}
+
+TEST_F(TestCore, ProfilesFetchVars) {
+    // Each value fetched counts as the message that would have fetched it
+    Core core(Logger::SEVERE, false, false);
+    core.init();
+    core.setData("core", "trackingDate", unitval(1900, U_UNDEFINED));
+    const std::pair<std::string, std::string> key(D_TRACKING_DATE, PROFILE_MESSAGE);
+    std::vector<std::string> vars(1, D_TRACKING_DATE);
+    std::vector<double> dates(2, Core::undefinedIndex());
+    std::vector<unitval> results;
+
+    core.fetchVars(vars, dates, results);
+    EXPECT_TRUE(core.getProfiler().getEntries().empty());
+
+    core.getProfiler().enable(true);
+    core.fetchVars(vars, dates, results);
+    ASSERT_EQ(core.getProfiler().getEntries().count(key), 1);
+    EXPECT_EQ(core.getProfiler().getEntries().at(key).calls, 2);
+    EXPECT_GE(core.getProfiler().getEntries().at(key).seconds, 0);
+}
@@ -0,0 +1,157 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_csv_tracking_visitor.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "component_data.hpp"
+#include "core.hpp"
+#include "csv_tracking_visitor.hpp"
+#include "h_exception.hpp"
+#include "message_data.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+namespace {
+
+const double TRACKING_DATE = 1990;
+
+class CSVFluxPoolVisitorTest : public testing::Test {
+protected:
+    CSVFluxPoolVisitorTest() : core(Logger::SEVERE, false, false) {}
+
+    virtual void SetUp() {
+        setup_ssp245_core(core, false);
+        core.setData(core.getComponentName(), D_TRACKING_DATE,
+                     message_data(unitval(TRACKING_DATE, U_UNITLESS)));
+    }
+
+    Core core;
+};
+
+// Number of rows for each year in CSV tracking output
+std::map<double, size_t> count_rows(const std::string &csv) {
+    std::map<double, size_t> rows;
+    std::istringstream lines(csv);
+    std::string line;
+    std::getline(lines, line); // header
+    while (std::getline(lines, line)) {
+        ++rows[std::atof(line.c_str())];
+    }
+    return rows;
+}
+
+} // namespace
+
+// Streaming writes each year once the next starts; all told, it writes
+// what holding everything until the end would
+TEST_F(CSVFluxPoolVisitorTest, StreamsCompleteYears) {
+    std::ostringstream held, streamed;
+    std::unique_ptr<CSVFluxPoolVisitor> heldVisitor(new CSVFluxPoolVisitor(held));
+    std::unique_ptr<CSVFluxPoolVisitor> streamVisitor(new CSVFluxPoolVisitor(streamed, true, true));
+    core.addVisitor(heldVisitor.get());
+    core.addVisitor(streamVisitor.get());
+    core.prepareToRun();
+
+    core.run(TRACKING_DATE);
+    EXPECT_TRUE(streamed.str().empty());
+    ASSERT_FALSE(streamVisitor->getRecords().empty());
+
+    // resuming the run doesn't record TRACKING_DATE again
+    core.run(TRACKING_DATE + 10);
+    const std::vector<tracking_record> &records = streamVisitor->getRecords();
+    ASSERT_FALSE(records.empty());
+    // the last year is still held, the rest (and the header) written
+    EXPECT_EQ(records.front().year, TRACKING_DATE + 10);
+    EXPECT_EQ(records.back().year, TRACKING_DATE + 10);
+    EXPECT_TRUE(held.str().empty());
+    const std::map<double, size_t> streamedRows = count_rows(streamed.str());
+    ASSERT_EQ(streamedRows.size(), 10);
+    EXPECT_EQ(streamedRows.begin()->first, TRACKING_DATE);
+    EXPECT_EQ(streamedRows.rbegin()->first, TRACKING_DATE + 9);
+
+    // what's streamed is what's held, as the R wrapper would get it
+    std::ostringstream tracking;
+    heldVisitor->outputTrackingData(tracking);
+    EXPECT_EQ(tracking.str().compare(0, streamed.str().size(), streamed.str()), 0);
+
+    streamVisitor.reset();
+    heldVisitor.reset();
+    EXPECT_EQ(streamed.str(), held.str());
+    EXPECT_EQ(held.str(), tracking.str());
+}
+
+// Streaming on a background thread writes the same, once flushed
+TEST_F(CSVFluxPoolVisitorTest, BackgroundStreamingWritesTheSame) {
+    std::ostringstream held, streamed;
+    CSVFluxPoolVisitor heldVisitor(held);
+    CSVFluxPoolVisitor streamVisitor(streamed, true, true, true);
+    core.addVisitor(&heldVisitor);
+    core.addVisitor(&streamVisitor);
+    core.prepareToRun();
+    core.run(TRACKING_DATE + 10);
+
+    streamVisitor.flush();
+    EXPECT_TRUE(streamVisitor.getRecords().empty());
+    std::ostringstream tracking;
+    heldVisitor.outputTrackingData(tracking);
+    EXPECT_EQ(streamed.str(), tracking.str());
+    EXPECT_EQ(count_rows(streamed.str()).size(), 11);
+}
+
+// A reset drops the rows after the reset date; rerunning then gives what a
+// run without the reset would have
+TEST_F(CSVFluxPoolVisitorTest, ResetTruncatesRows) {
+    std::ostringstream out;
+    CSVFluxPoolVisitor visitor(out);
+    core.addVisitor(&visitor);
+    core.prepareToRun();
+    core.run(TRACKING_DATE + 10);
+    std::ostringstream full;
+    visitor.outputTrackingData(full);
+
+    core.reset(TRACKING_DATE + 4);
+    const std::vector<tracking_record> &records = visitor.getRecords();
+    ASSERT_FALSE(records.empty());
+    EXPECT_EQ(records.front().year, TRACKING_DATE);
+    EXPECT_EQ(records.back().year, TRACKING_DATE + 4);
+
+    core.run(TRACKING_DATE + 10);
+    std::ostringstream rerun;
+    visitor.outputTrackingData(rerun);
+    EXPECT_EQ(rerun.str(), full.str());
+
+    // a reset to before tracking started drops everything
+    core.reset(TRACKING_DATE - 1);
+    EXPECT_TRUE(visitor.getRecords().empty());
+}
+
+// A streaming visitor can't take back rows it has written
+TEST_F(CSVFluxPoolVisitorTest, StreamingResetLimits) {
+    std::ostringstream out;
+    CSVFluxPoolVisitor visitor(out, true, true);
+    core.addVisitor(&visitor);
+    core.prepareToRun();
+    core.run(TRACKING_DATE + 5);
+
+    // the last year is only held, so can still be dropped
+    EXPECT_NO_THROW(visitor.reset(TRACKING_DATE + 4));
+    EXPECT_TRUE(visitor.getRecords().empty());
+    EXPECT_THROW(visitor.reset(TRACKING_DATE + 3), h_exception);
+}
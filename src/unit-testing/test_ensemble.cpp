@@ -0,0 +1,87 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_ensemble.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "component_data.hpp"
+#include "core.hpp"
+#include "ensemble.hpp"
+#include "message_data.hpp"
+#include "scenario_bundle.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+// Members are (S, beta); the second has a negative beta, which the land
+// carbon model rejects
+TEST(EnsembleTest, MatchesPlainCores) {
+    const std::string ini = test_input("hector_ssp245.ini");
+    ScenarioBundle inputs;
+    {
+        Core parser(Logger::SEVERE, false, false);
+        parser.init();
+        inputs.record(&parser, ini);
+    }
+
+    const std::vector<std::string> params = {D_ECS, D_BETA};
+    const std::vector<unit_types> units = {U_DEGC, U_UNITLESS};
+    const std::vector<std::string> vars = {D_GLOBAL_TAS, D_CO2_CONC};
+    const std::vector<double> dates = {1900, 2000, 2100};
+    const size_t members = 3;
+    const std::vector<double> values = {3.0, 2.5, 4.0,   // S
+                                        0.54, -1.0, 0.3}; // beta
+
+    Ensemble ensemble(inputs, params, units, vars, dates);
+    ensemble.run(values, members, 1);
+    const std::vector<double> serial = ensemble.getResults();
+    const std::vector<std::string> serialErrors = ensemble.getErrors();
+    ensemble.run(values, members, members);
+    const std::vector<double> &threaded = ensemble.getResults();
+    const std::vector<std::string> &errors = ensemble.getErrors();
+    ASSERT_EQ(threaded.size(), members * vars.size() * dates.size());
+    ASSERT_EQ(serial.size(), threaded.size());
+
+    // the failing member is reported, with NaN results
+    EXPECT_TRUE(errors[0].empty());
+    EXPECT_FALSE(errors[1].empty());
+    EXPECT_TRUE(errors[2].empty());
+    EXPECT_EQ(serialErrors, errors);
+    for (size_t i = 0; i < vars.size() * dates.size(); ++i) {
+        EXPECT_TRUE(std::isnan(threaded[vars.size() * dates.size() + i]));
+    }
+    EXPECT_EQ(ensemble.getUnits()[0], U_DEGC);
+    EXPECT_EQ(ensemble.getUnits()[1], U_PPMV_CO2);
+
+    // the others match a core run on its own, value for value
+    for (size_t m = 0; m < members; m += 2) {
+        Core core(Logger::SEVERE, false, false);
+        setup_ssp245_core(core, false);
+        for (size_t p = 0; p < params.size(); ++p) {
+            core.sendMessage(M_SETDATA, params[p],
+                             message_data(unitval(values[m + p * members], units[p])));
+        }
+        core.prepareToRun();
+        core.run();
+        std::vector<unitval> expected;
+        core.fetchVars(vars, dates, expected);
+
+        for (size_t i = 0; i < expected.size(); ++i) {
+            const size_t slot = m * vars.size() * dates.size() + i;
+            EXPECT_EQ(serial[slot], expected[i].value(expected[i].units()));
+            EXPECT_EQ(threaded[slot], expected[i].value(expected[i].units()));
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_fft.cpp
+ *  hector
+ *
+ */
+
+#include <cmath>
+#include <complex>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "h_exception.hpp"
+#include "h_fft.hpp"
+
+using namespace std;
+using namespace Hector;
+
+TEST(FFTTest, LengthFor) {
+    EXPECT_EQ(h_fft::length_for(1), 1);
+    EXPECT_EQ(h_fft::length_for(2), 2);
+    EXPECT_EQ(h_fft::length_for(3), 4);
+    EXPECT_EQ(h_fft::length_for(1000), 1024);
+    EXPECT_EQ(h_fft::length_for(1024), 1024);
+}
+
+TEST(FFTTest, RejectsBadLengths) {
+    EXPECT_THROW(h_fft(0), h_exception);
+    EXPECT_THROW(h_fft(12), h_exception);
+
+    h_fft fft(8);
+    vector<complex<double> > a(4);
+    EXPECT_THROW(fft.forward(a), h_exception);
+}
+
+TEST(FFTTest, RoundTrip) {
+    h_fft fft(64);
+    vector<complex<double> > a(64), orig;
+    for(size_t i = 0; i < a.size(); i++) {
+        a[i] = complex<double>(sin(0.3 * i) + 0.01 * i, cos(1.7 * i));
+    }
+    orig = a;
+    fft.forward(a);
+    fft.inverse(a);
+    for(size_t i = 0; i < a.size(); i++) {
+        EXPECT_NEAR(a[i].real(), orig[i].real(), 1e-12);
+        EXPECT_NEAR(a[i].imag(), orig[i].imag(), 1e-12);
+    }
+}
+
+TEST(FFTTest, KnownTransform) {
+    // Transform of a unit impulse is flat; of a constant is an impulse
+    h_fft fft(16);
+    vector<complex<double> > a(16, 0.0), b(16, 1.0);
+    a[0] = 1.0;
+    fft.forward(a);
+    fft.forward(b);
+    for(size_t i = 0; i < 16; i++) {
+        EXPECT_NEAR(abs(a[i] - 1.0), 0.0, 1e-14);
+        EXPECT_NEAR(abs(b[i]), i == 0 ? 16.0 : 0.0, 1e-12);
+    }
+}
+
+TEST(FFTTest, MatchesDirectConvolution) {
+    const size_t n = 37;
+    vector<double> x(n), y(n);
+    for(size_t i = 0; i < n; i++) {
+        x[i] = 1.0 / (1.0 + i);
+        y[i] = sin(0.2 * i) * exp(-0.05 * i);
+    }
+
+    h_fft fft(h_fft::length_for(2 * n - 1));
+    vector<complex<double> > X(fft.size(), 0.0), Y(fft.size(), 0.0);
+    for(size_t i = 0; i < n; i++) {
+        X[i] = x[i];
+        Y[i] = y[i];
+    }
+    fft.forward(X);
+    fft.forward(Y);
+    for(size_t i = 0; i < fft.size(); i++) {
+        X[i] *= Y[i];
+    }
+    fft.inverse(X);
+
+    for(size_t k = 0; k < 2 * n - 1; k++) {
+        double direct = 0.0;
+        for(size_t j = 0; j < n; j++) {
+            if(k >= j && k - j < n) {
+                direct += x[j] * y[k - j];
+            }
+        }
+        EXPECT_NEAR(X[k].real(), direct, 1e-12) << "k=" << k;
+        EXPECT_NEAR(X[k].imag(), 0.0, 1e-12) << "k=" << k;
+    }
+}
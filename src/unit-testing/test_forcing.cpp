@@ -0,0 +1,121 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_forcing.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "component_data.hpp"
+#include "component_names.hpp"
+#include "core.hpp"
+#include "forcing_component.hpp"
+#include "message_data.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+namespace {
+
+// Each adjusted halocarbon forcing and the unadjusted forcing it refers to
+const char *halo_names[][2] = {
+    {D_RFADJ_CF4, D_RF_CF4},             {D_RFADJ_C2F6, D_RF_C2F6},
+    {D_RFADJ_HFC23, D_RF_HFC23},         {D_RFADJ_HFC32, D_RF_HFC32},
+    {D_RFADJ_HFC4310, D_RF_HFC4310},     {D_RFADJ_HFC125, D_RF_HFC125},
+    {D_RFADJ_HFC134a, D_RF_HFC134a},     {D_RFADJ_HFC143a, D_RF_HFC143a},
+    {D_RFADJ_HFC227ea, D_RF_HFC227ea},   {D_RFADJ_HFC245fa, D_RF_HFC245fa},
+    {D_RFADJ_SF6, D_RF_SF6},             {D_RFADJ_CFC11, D_RF_CFC11},
+    {D_RFADJ_CFC12, D_RF_CFC12},         {D_RFADJ_CFC113, D_RF_CFC113},
+    {D_RFADJ_CFC114, D_RF_CFC114},       {D_RFADJ_CFC115, D_RF_CFC115},
+    {D_RFADJ_CCl4, D_RF_CCl4},           {D_RFADJ_CH3CCl3, D_RF_CH3CCl3},
+    {D_RFADJ_HCFC22, D_RF_HCFC22},       {D_RFADJ_HCFC141b, D_RF_HCFC141b},
+    {D_RFADJ_HCFC142b, D_RF_HCFC142b},   {D_RFADJ_halon1211, D_RF_halon1211},
+    {D_RFADJ_halon1301, D_RF_halon1301}, {D_RFADJ_halon2402, D_RF_halon2402},
+    {D_RFADJ_CH3Cl, D_RF_CH3Cl},         {D_RFADJ_CH3Br, D_RF_CH3Br}};
+
+double forcing(Core &core, const char *name, const double date) {
+    return core.sendMessage(M_GETDATA, name, message_data(date)).value(U_W_M2);
+}
+
+} // namespace
+
+// Every forcing name maps to its own slot, and every adjusted halocarbon name
+// to the slot of the forcing it adjusts
+TEST(ForcingTest, SlotNamesRoundTrip) {
+    for (int i = 0; i < ForcingComponent::N_FORCINGS; ++i) {
+        EXPECT_EQ(ForcingComponent::find_slot(ForcingComponent::forcing_names[i]), i)
+            << ForcingComponent::forcing_names[i];
+    }
+    EXPECT_EQ(ForcingComponent::find_slot(D_RF_CO2), ForcingComponent::F_CO2);
+    EXPECT_EQ(ForcingComponent::find_slot(D_RF_TOTAL), ForcingComponent::F_TOTAL);
+
+    for (const auto &names : halo_names) {
+        const int slot = ForcingComponent::find_slot(names[0]);
+        ASSERT_GE(slot, 0) << names[0];
+        EXPECT_STREQ(ForcingComponent::forcing_names[slot], names[1]);
+    }
+
+    EXPECT_EQ(ForcingComponent::find_slot(D_RF_BASEYEAR), -1);
+    EXPECT_EQ(ForcingComponent::find_slot("not_a_forcing"), -1);
+}
+
+// Forcings by name after an ssp245 run. The pinned values are from the
+// name-keyed forcing maps the slot table replaced.
+TEST(ForcingTest, MatchesNameKeyedForcings) {
+    Core core(Logger::SEVERE, false, false);
+    setup_ssp245_core(core);
+    core.run();
+
+    struct {
+        const char *name;
+        double date, value;
+    } expected[] = {
+        {D_RF_TOTAL, 1850, 0.12255624823268785},
+        {D_RF_TOTAL, 2000, 1.6798675001919683},
+        {D_RF_TOTAL, 2100, 4.4363195446432613},
+        {D_RF_CO2, 2000, 1.5877505712749889},
+        {D_RF_CH4, 2000, 0.46502738441655855},
+        {D_RF_SO2, 2000, -0.39413889563002408},
+        {D_RF_ACI, 2000, -0.84511449064081168},
+        {D_RF_VOL, 2100, -0.18574567415812035},
+        {D_RFADJ_CF4, 1850, -6.350930767473964e-07},
+        {D_RFADJ_CF4, 2100, 0.0084576565151024321}};
+    for (const auto &e : expected) {
+        EXPECT_NEAR(forcing(core, e.name, e.date), e.value, 1e-12) << e.name << " " << e.date;
+    }
+
+    const double baseyear = core.sendMessage(M_GETDATA, D_RF_BASEYEAR).value(U_UNITLESS);
+    IModelComponent *fc = core.getComponentByName(FORCING_COMPONENT_NAME);
+    for (double date = baseyear; date <= core.getEndDate(); date += 1.0) {
+        // The total is the sum of the others, relative to the base year
+        double sum = 0.0;
+        for (int i = 0; i < ForcingComponent::N_FORCINGS; ++i) {
+            if (i == ForcingComponent::F_TOTAL)
+                continue;
+            const char *name = ForcingComponent::forcing_names[i];
+            const double f = fc->sendMessage(M_GETDATA, name, message_data(date)).value(U_W_M2);
+            if (date == baseyear) {
+                EXPECT_EQ(f, 0.0) << name;
+            }
+            sum += f;
+        }
+        EXPECT_NEAR(forcing(core, D_RF_TOTAL, date), sum, 1e-12) << date;
+
+        // Adjusted halocarbon forcings are the halocarbon components' own
+        // forcings less their base year values
+        for (const auto &names : halo_names) {
+            EXPECT_EQ(forcing(core, names[0], date),
+                      forcing(core, names[1], date) - forcing(core, names[1], baseyear))
+                << names[0] << " " << date;
+        }
+    }
+    EXPECT_EQ(forcing(core, D_RF_TOTAL, baseyear - 1), 0.0);
+}
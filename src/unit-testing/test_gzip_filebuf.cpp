@@ -0,0 +1,62 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_gzip_filebuf.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+#include <zlib.h>
+
+#include "gzip_filebuf.hpp"
+
+using namespace Hector;
+
+// Read back a whole gzip file
+static std::string gunzip(const std::string &fileName) {
+    std::string text;
+    gzFile in = gzopen(fileName.c_str(), "rb");
+    if(!in) return text;
+    char buf[4096];
+    int n;
+    while((n = gzread(in, buf, sizeof(buf))) > 0) {
+        text.append(buf, n);
+    }
+    gzclose(in);
+    return text;
+}
+
+TEST(GzipFilebufTest, RoundTrip) {
+    const std::string fileName = "test_gzip_filebuf.csv.gz";
+    std::string expected;
+    for(int i = 0; i < 100000; i++) {
+        expected += std::to_string(i) + ",component,variable,1.5,units\n";
+    }
+
+    gzip_filebuf buf;
+    ASSERT_TRUE(buf.open(fileName));
+    EXPECT_FALSE(buf.open(fileName)); // already open
+    std::ostream out(&buf);
+    out << expected.substr(0, 1000);
+    out.flush();
+    // everything flushed so far can already be read
+    EXPECT_EQ(gunzip(fileName), expected.substr(0, 1000));
+
+    // more than one block
+    out << expected.substr(1000);
+    ASSERT_TRUE(buf.close());
+    EXPECT_FALSE(buf.is_open());
+    EXPECT_EQ(gunzip(fileName), expected);
+
+    std::remove(fileName.c_str());
+}
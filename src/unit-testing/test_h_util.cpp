@@ -0,0 +1,59 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_h_util.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "h_util.hpp"
+
+using namespace Hector;
+
+// append_number must write exactly what the CSV writers used to get from
+// ostream << (default notation, the stream's precision)
+TEST(AppendNumberTest, MatchesOstream) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    const double values[] = {
+        0.0, -0.0, 1.0, -1.0, 0.1, 1.0 / 3.0, -2.0 / 3.0, 2.5, 1745.0, 2300.5,
+        123456.0, 1234567.0, -999999.5, 0.0001, 0.00001, -2.5e-7, 6.02214076e23,
+        1e21, 1e-300, std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<double>::max(), -std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::min(), nan, -nan, inf, -inf};
+    const int precisions[] = {1, 4, 6, 10, 17};
+
+    for (int precision : precisions) {
+        for (double x : values) {
+            std::ostringstream expected;
+            expected.precision(precision);
+            expected << x;
+
+            std::string s = "prefix,";
+            append_number(s, x, precision);
+            EXPECT_EQ(s, "prefix," + expected.str()) << "precision " << precision;
+        }
+    }
+}
+
+// Appending doesn't disturb what's already there, and values follow each
+// other as written
+TEST(AppendNumberTest, Appends) {
+    std::string s;
+    append_number(s, 1.5, 6);
+    s += ',';
+    append_number(s, -0.25, 6);
+    s += ',';
+    append_number(s, 2023, 17);
+    EXPECT_EQ(s, "1.5,-0.25,2023");
+}
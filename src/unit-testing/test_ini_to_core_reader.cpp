@@ -20,6 +20,7 @@
 #include "core.hpp"
 #include "dummy_model_component.hpp"
 #include "ini_to_core_reader.hpp"
+#include "scenario_bundle.hpp"
 
 using namespace Hector;
 
@@ -154,3 +155,33 @@ TEST_F(TestINIToCore, TableFilenameWithCSVPrefix) {
         ASSERT_EQ( e.get_filename(), "csv_table_reader.cpp" );
     }
 }
+
+TEST_F(TestINIToCore, CompileScenarioBundle) {
+    testFile << "[dummy-component]" << std:: endl;
+    testFile << "slope=6" << std::endl;
+    testFile << "c[2.7]=6" << std::endl;
+    const std::string bundleName = "ini_test_file.hsb";
+    ASSERT_NO_THROW(ScenarioBundle::compile(&core, testFileName, bundleName));
+    EXPECT_TRUE(ScenarioBundle::isBundle(bundleName));
+    EXPECT_FALSE(ScenarioBundle::isBundle(testFileName));
+
+    // the bundle sets up a fresh core as the INI file would
+    Core core2(Logger::DEBUG, false, false);
+    core2.addModelComponent( new DummyModelComponent );
+    core2.init();
+    EXPECT_NO_THROW(ScenarioBundle::load(&core2, bundleName));
+    DummyModelComponent* dummy = dynamic_cast<DummyModelComponent*>( core2.getComponentByName( "dummy-component" ) );
+    ASSERT_TRUE( dummy != NULL );
+    EXPECT_EQ( dummy->getC().get( 2.7 ), 6 );
+
+    // a damaged bundle is rejected
+    std::ifstream in( bundleName.c_str(), std::ios::binary );
+    std::string contents( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+    in.close();
+    std::ofstream out( bundleName.c_str(), std::ios::binary | std::ios::trunc );
+    out << contents.substr( 0, contents.size() - 4 );
+    out.close();
+    EXPECT_THROW(ScenarioBundle::load(&core2, bundleName), h_exception);
+
+    remove( bundleName.c_str() );
+}
@@ -0,0 +1,44 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_inputs.hpp
+ *  hector
+ *
+ *  Finds the package's input files, and sets up cores, for tests that run
+ *  the full model.
+ *
+ */
+
+#ifndef TEST_INPUTS_H
+#define TEST_INPUTS_H
+
+#include <fstream>
+#include <string>
+
+#include "core.hpp"
+#include "ini_to_core_reader.hpp"
+
+// Path of a file in inst/input, whether the tests are run from the top level
+// directory (as in CI) or from unit-testing
+inline std::string test_input(const std::string &name) {
+    const std::string path = "inst/input/" + name;
+    return std::ifstream(path.c_str()) ? path : "../../" + path;
+}
+
+// Set up a core (made, but not yet initialized) with the ssp245 scenario.
+// Tests that add visitors or change inputs before the run pass prepare=false
+// and call prepareToRun themselves.
+inline void setup_ssp245_core(Hector::Core &core, const bool prepare = true) {
+    core.init();
+    Hector::INIToCoreReader reader(&core);
+    reader.parse(test_input("hector_ssp245.ini"));
+    if (prepare) {
+        core.prepareToRun();
+    }
+}
+
+#endif // TEST_INPUTS_H
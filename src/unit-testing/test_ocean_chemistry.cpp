@@ -0,0 +1,39 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_ocean_chemistry.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "component_data.hpp"
+#include "core.hpp"
+#include "message_data.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+// With far too much carbon in the surface ocean, no alkalinity in the
+// plausible range gives the preindustrial flux. As before the root finder,
+// the best alkalinity in the range is used and the run carries on, so that
+// parameter sweeps through such values don't stop part way.
+TEST(OceanChemistryTest, UnbracketedAlkalinityRuns) {
+    Core core(Logger::SEVERE, false, false);
+    setup_ssp245_core(core, false);
+    core.setData(OCEAN_COMPONENT_NAME, D_CARBON_PRE_SURF,
+                 message_data(unitval(3000, U_PGC)));
+    core.prepareToRun();
+    EXPECT_NO_THROW(core.run(2100));
+
+    const unitval co2 = core.sendMessage(M_GETDATA, D_CO2_CONC, message_data(2100));
+    EXPECT_TRUE(std::isfinite(co2.value(U_PPMV_CO2)));
+    EXPECT_GT(co2.value(U_PPMV_CO2), 0);
+}
@@ -0,0 +1,194 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_ocean_nbox.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "component_data.hpp"
+#include "core.hpp"
+#include "csv_tracking_visitor.hpp"
+#include "h_exception.hpp"
+#include "imodel_component.hpp"
+#include "ini_to_core_reader.hpp"
+#include "message_data.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+namespace {
+
+void setup_core(Core &core, bool four_box) {
+    setup_ssp245_core(core, false);
+    if (four_box) {
+        INIToCoreReader reader(&core);
+        reader.parse(test_input("examples/ocean_4box.ini"));
+    }
+}
+
+// Carbon in each ocean box now, read as tracking output would record it
+std::map<std::string, double> box_carbon(Core &core) {
+    std::ostringstream out;
+    CSVFluxPoolVisitor visitor(out, false);
+    visitor.visit(&core);
+    visitor.shouldVisit(false, core.getCurrentDate());
+    core.getComponentByName(OCEAN_COMPONENT_NAME)->accept(&visitor);
+    std::map<std::string, double> carbon;
+    for (const tracking_record &r : visitor.getRecords()) {
+        carbon[visitor.getPool(r.pool).name] = r.value;
+    }
+    return carbon;
+}
+
+} // namespace
+
+// The four-box ocean, set up box by box through the N-box inputs, must
+// reproduce the default ocean exactly
+TEST(OceanNboxTest, FourBoxReproducesDefault) {
+    Core base(Logger::SEVERE, false, false);
+    setup_core(base, false);
+    base.prepareToRun();
+    base.run();
+
+    Core nbox(Logger::SEVERE, false, false);
+    setup_core(nbox, true);
+    nbox.prepareToRun();
+    nbox.run();
+
+    const char *vars[] = {D_OCEAN_C, D_CARBON_HL, D_CARBON_IO, D_CARBON_DO,
+                          D_PH_HL, D_ATM_OCEAN_FLUX_HL,
+                          D_ATM_OCEAN_FLUX_LL, D_CO2_CONC,
+                          D_GLOBAL_TAS};
+    for (double date = base.getStartDate() + 1; date <= base.getEndDate(); date += 1.0) {
+        const message_data when(date);
+        for (const char *var : vars) {
+            const unitval expected = base.sendMessage(M_GETDATA, var, when);
+            const unitval actual = nbox.sendMessage(M_GETDATA, var, when);
+            EXPECT_EQ(actual.units(), expected.units()) << var;
+            EXPECT_EQ(actual.value(actual.units()), expected.value(expected.units()))
+                << var << " " << date;
+        }
+    }
+}
+
+// Ten boxes: the default intermediate and deep boxes each split into four
+// identical columns, every transport shared equally among them. Each column
+// then behaves as its whole box did, so the ocean as a whole must behave as
+// the default one does, to rounding
+TEST(OceanNboxTest, SplitColumnsMatchDefault) {
+    Core base(Logger::SEVERE, false, false);
+    setup_core(base, false);
+    base.prepareToRun();
+    base.run();
+
+    Core nbox(Logger::SEVERE, false, false);
+    setup_core(nbox, false);
+    const int columns = 4;
+    const double I_frac = 0.24476475387544194, D_frac = 0.7552352461245581;
+    const double tt = 7.2e7, tu = 4.9e7, twi = 1.25e7, tid = 2.0e8;
+    const auto set = [&nbox](const std::string &var, double value, unit_types units) {
+        nbox.setData(OCEAN_COMPONENT_NAME, var, message_data(unitval(value, units)));
+    };
+    set("LL.HL.transport", tt, U_M3_S);
+    for (int k = 0; k < columns; k++) {
+        const std::string i = "intermediate" + std::to_string(k);
+        const std::string d = "deep" + std::to_string(k);
+        set(i + ".volume_frac", I_frac / columns, U_UNITLESS);
+        set(d + ".volume_frac", D_frac / columns, U_UNITLESS);
+        set(d + ".deep", 1, U_UNDEFINED);
+        set("LL." + i + ".transport", twi / columns, U_M3_S);
+        set("HL." + d + ".transport", (tt + tu) / columns, U_M3_S);
+        set(i + ".LL.transport", (tt + twi) / columns, U_M3_S);
+        set(i + ".HL.transport", tu / columns, U_M3_S);
+        set(i + "." + d + ".transport", tid / columns, U_M3_S);
+        set(d + "." + i + ".transport", (tt + tu + tid) / columns, U_M3_S);
+    }
+    nbox.prepareToRun();
+    nbox.run();
+
+    const char *vars[] = {D_OCEAN_C, D_CARBON_HL, D_CARBON_IO, D_CARBON_DO,
+                          D_PH_HL, D_ATM_OCEAN_FLUX_HL,
+                          D_ATM_OCEAN_FLUX_LL, D_CO2_CONC,
+                          D_GLOBAL_TAS};
+    const double tolerance = 1e-9;
+    for (double date = base.getStartDate() + 1; date <= base.getEndDate(); date += 1.0) {
+        const message_data when(date);
+        for (const char *var : vars) {
+            const unitval expected = base.sendMessage(M_GETDATA, var, when);
+            const unitval actual = nbox.sendMessage(M_GETDATA, var, when);
+            const double e = expected.value(expected.units());
+            EXPECT_NEAR(actual.value(actual.units()), e, tolerance * (std::fabs(e) + 1.0))
+                << var << " " << date;
+        }
+    }
+}
+
+// Transports that don't conserve water at every box are an error: here a
+// new deep box takes water from HL that never comes back
+TEST(OceanNboxTest, RejectsUnbalancedTransports) {
+    Core core(Logger::SEVERE, false, false);
+    setup_core(core, true);
+    core.setData(OCEAN_COMPONENT_NAME, "deep.volume_frac", message_data(unitval(0.5552352461245581, U_UNITLESS)));
+    core.setData(OCEAN_COMPONENT_NAME, "abyss.volume_frac", message_data(unitval(0.2, U_UNITLESS)));
+    core.setData(OCEAN_COMPONENT_NAME, "abyss.deep", message_data(unitval(1, U_UNDEFINED)));
+    core.setData(OCEAN_COMPONENT_NAME, "HL.abyss.transport", message_data(unitval(1.21e8, U_M3_S)));
+    core.setData(OCEAN_COMPONENT_NAME, "deep.abyss.transport", message_data(unitval(1e8, U_M3_S)));
+    core.setData(OCEAN_COMPONENT_NAME, "abyss.deep.transport", message_data(unitval(1e8, U_M3_S)));
+    EXPECT_THROW(core.prepareToRun(), h_exception);
+}
+
+// Surface boxes aren't named until the ocean is set up, but still can't be
+// redefined
+TEST(OceanNboxTest, RejectsSurfaceBoxes) {
+    Core core(Logger::SEVERE, false, false);
+    core.init();
+    EXPECT_THROW(core.setData(OCEAN_COMPONENT_NAME, "HL.volume_frac", message_data(unitval(0.5, U_UNITLESS))),
+                 h_exception);
+    EXPECT_THROW(core.setData(OCEAN_COMPONENT_NAME, "LL.deep", message_data(unitval(1, U_UNDEFINED))),
+                 h_exception);
+}
+
+// Carbon dumped to (or taken from) the deep ocean is spread over the deep
+// boxes by volume
+TEST(OceanNboxTest, DeepDumpSpreadByVolume) {
+    Core core(Logger::SEVERE, false, false);
+    setup_core(core, true);
+    // split the deep box in two
+    const double deep_frac = 0.5552352461245581, abyss_frac = 0.2;
+    core.setData(OCEAN_COMPONENT_NAME, "deep.volume_frac", message_data(unitval(deep_frac, U_UNITLESS)));
+    core.setData(OCEAN_COMPONENT_NAME, "abyss.volume_frac", message_data(unitval(abyss_frac, U_UNITLESS)));
+    core.setData(OCEAN_COMPONENT_NAME, "abyss.deep", message_data(unitval(1, U_UNDEFINED)));
+    core.setData(OCEAN_COMPONENT_NAME, "deep.abyss.transport", message_data(unitval(1e8, U_M3_S)));
+    core.setData(OCEAN_COMPONENT_NAME, "abyss.deep.transport", message_data(unitval(1e8, U_M3_S)));
+    core.setData(core.getComponentName(), D_TRACKING_DATE, message_data(unitval(1900, U_UNITLESS)));
+    core.prepareToRun();
+    core.run(1950);
+
+    const std::map<std::string, double> before = box_carbon(core);
+    ASSERT_EQ(before.size(), 5);
+    const double dump = -10.0;
+    core.sendMessage(M_DUMP_TO_DEEP_OCEAN, D_OCEAN_C, message_data(unitval(dump, U_PGC)));
+    const std::map<std::string, double> after = box_carbon(core);
+
+    for (const auto &box : before) {
+        double expected = box.second;
+        if (box.first == "deep") {
+            expected += dump * deep_frac / (deep_frac + abyss_frac);
+        } else if (box.first == "abyss") {
+            expected += dump * abyss_frac / (deep_frac + abyss_frac);
+        }
+        EXPECT_NEAR(after.at(box.first), expected, 1e-9 * std::fabs(expected)) << box.first;
+    }
+}
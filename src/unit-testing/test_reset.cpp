@@ -0,0 +1,48 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_reset.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "component_data.hpp"
+#include "core.hpp"
+#include "message_data.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+// Resetting to before the start reruns the spinup; what follows must be
+// exactly a new run, even though the chemistry equilibration is then taken
+// from the boxes' caches rather than searched for again
+TEST(ResetTest, RerunMatchesNewRun) {
+    Core fresh(Logger::SEVERE, false, false);
+    setup_ssp245_core(fresh);
+    fresh.run();
+
+    Core rerun(Logger::SEVERE, false, false);
+    setup_ssp245_core(rerun);
+    rerun.run();
+    rerun.reset(0);
+    rerun.run();
+
+    const char *vars[] = {D_OCEAN_C, D_PH_HL, D_PH_LL, D_ATM_OCEAN_FLUX_HL,
+                          D_ATM_OCEAN_FLUX_LL, D_CO2_CONC, D_GLOBAL_TAS};
+    for (double date = fresh.getStartDate() + 1; date <= fresh.getEndDate(); date += 1.0) {
+        const message_data when(date);
+        for (const char *var : vars) {
+            const unitval expected = fresh.sendMessage(M_GETDATA, var, when);
+            const unitval actual = rerun.sendMessage(M_GETDATA, var, when);
+            EXPECT_EQ(actual.units(), expected.units()) << var;
+            EXPECT_EQ(actual.value(actual.units()), expected.value(expected.units()))
+                << var << " " << date;
+        }
+    }
+}
@@ -0,0 +1,99 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_slr.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "component_data.hpp"
+#include "component_names.hpp"
+#include "core.hpp"
+#include "imodel_component.hpp"
+#include "message_data.hpp"
+#include "test_inputs.hpp"
+#include "tseries.hpp"
+
+using namespace Hector;
+
+namespace {
+
+// Largest difference allowed from the reference, cm. Both compute dT/dt
+// from the same few temperatures, so only rounding should separate them.
+const double SLR_TOL = 1e-9;
+
+// Vermeer and Rahmstorf (2009) coefficients, as in slrComponent::compute_slr
+struct vr_params {
+    double a, b, T0;
+};
+
+} // namespace
+
+// slr and slr_no_ice over a full run must match the original computation,
+// which took dT/dt from an interpolated tseries of the whole tgav history
+TEST(SLRTest, MatchesInterpolatedSeriesDerivative) {
+    Core core(Logger::SEVERE, false, false);
+    setup_ssp245_core(core);
+    core.run();
+
+    const int refperiod_low = 1951, refperiod_high = 1980;
+    const int firstdate = core.getStartDate() + 1;
+    const int lastdate = core.getEndDate();
+
+    std::map<int, double> tgav;
+    for (int date = firstdate; date <= lastdate; ++date) {
+        tgav[date] = core.sendMessage(M_GETDATA, D_GLOBAL_TAS, message_data(date))
+                         .value(U_DEGC);
+    }
+    double sum = 0.0;
+    for (int i = refperiod_low; i <= refperiod_high; ++i) {
+        sum += tgav[i];
+    }
+    const double refperiod_tgav = sum / (refperiod_high - refperiod_low + 1);
+
+    // The component computes everything up to the end of the reference period
+    // once it gets there, and each later year as it is run, so the series the
+    // derivative came from ended at refperiod_high or at the date itself
+    tseries<double> tgav_vals;
+    std::map<int, double> dTdt;
+    for (int date = firstdate; date <= lastdate; ++date) {
+        tgav_vals.set(date, tgav[date]);
+        if (date < refperiod_high) {
+            continue;
+        }
+        tgav_vals.allowInterp(true);
+        if (date == refperiod_high) {
+            for (int i = firstdate; i <= refperiod_high; ++i) {
+                dTdt[i] = tgav_vals.get_deriv(i);
+            }
+        } else {
+            dTdt[date] = tgav_vals.get_deriv(date);
+        }
+    }
+
+    // slr registers no capabilities, so ask the component itself
+    IModelComponent *slr_comp = core.getComponentByName(SLR_COMPONENT_NAME);
+    const vr_params with_ice = {0.56, -4.9, -0.41};
+    const vr_params no_ice = {0.08, 2.5, -0.375};
+    double slr = 0.0, slr_no_ice = 0.0;
+    for (int date = firstdate; date <= lastdate; ++date) {
+        const double T = tgav[date] - refperiod_tgav;
+        slr += with_ice.a * (T - with_ice.T0) + with_ice.b * dTdt[date];
+        slr_no_ice += no_ice.a * (T - no_ice.T0) + no_ice.b * dTdt[date];
+
+        const message_data when(date);
+        EXPECT_NEAR(slr_comp->sendMessage(M_GETDATA, D_SLR, when).value(U_CM), slr, SLR_TOL)
+            << date;
+        EXPECT_NEAR(slr_comp->sendMessage(M_GETDATA, D_SLR_NO_ICE, when).value(U_CM),
+                    slr_no_ice, SLR_TOL)
+            << date;
+    }
+}
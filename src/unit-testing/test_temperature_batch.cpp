@@ -0,0 +1,89 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_temperature_batch.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "component_data.hpp"
+#include "core.hpp"
+#include "h_exception.hpp"
+#include "message_data.hpp"
+#include "temperature_component.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+// The FFT batch path, given the effective forcing of a normal run, must
+// reproduce that run's temperatures and heat flux
+TEST(TemperatureBatchTest, MatchesStepByStep) {
+    Core core(Logger::SEVERE, false, false);
+    setup_ssp245_core(core);
+    core.run();
+
+    const double alpha = core.sendMessage(M_GETDATA, D_AERO_SCALE).value(U_UNITLESS);
+    const double volscl = core.sendMessage(M_GETDATA, D_VOLCANIC_SCALE).value(U_UNITLESS);
+    const char *aerosols[] = {D_RF_BC, D_RF_OC, D_RF_NH3, D_RF_SO2, D_RF_ACI};
+
+    // Effective forcing as TemperatureComponent::run computes it; the start
+    // year's forcing doesn't affect the step-by-step run, so it is left zero
+    std::vector<std::vector<double>> forcing(1);
+    for (double date = core.getStartDate(); date <= core.getEndDate(); date += 1.0) {
+        double F = 0.0;
+        if (date > core.getStartDate()) {
+            message_data when(date);
+            double aero = 0.0;
+            for (const char *rf : aerosols) {
+                aero += core.sendMessage(M_GETDATA, rf, when).value(U_W_M2);
+            }
+            F = core.sendMessage(M_GETDATA, D_RF_TOTAL, when).value(U_W_M2) -
+                (1.0 - alpha) * aero -
+                (1.0 - volscl) * core.sendMessage(M_GETDATA, D_RF_VOL, when).value(U_W_M2);
+        }
+        forcing[0].push_back(F);
+    }
+
+    TemperatureComponent *temperature = dynamic_cast<TemperatureComponent *>(
+        core.getComponentByName(TEMPERATURE_COMPONENT_NAME));
+    ASSERT_TRUE(temperature != NULL);
+    const std::vector<TemperatureComponent::batch_result> results =
+        temperature->run_batch(forcing);
+    ASSERT_EQ(results.size(), 1);
+    const TemperatureComponent::batch_result &batch = results[0];
+    ASSERT_EQ(batch.tas.size(), forcing[0].size());
+
+    // FFT round-off only; the temperatures are O(1) degC
+    const double tolerance = 1e-10;
+    for (size_t t = 0; t < batch.tas.size(); ++t) {
+        message_data when(core.getStartDate() + t);
+        EXPECT_NEAR(batch.tas[t], core.sendMessage(M_GETDATA, D_GLOBAL_TAS, when).value(U_DEGC), tolerance);
+        EXPECT_NEAR(batch.tas_land[t], core.sendMessage(M_GETDATA, D_LAND_TAS, when).value(U_DEGC), tolerance);
+        EXPECT_NEAR(batch.sst[t], core.sendMessage(M_GETDATA, D_SST, when).value(U_DEGC), tolerance);
+        EXPECT_NEAR(batch.heatflux[t], core.sendMessage(M_GETDATA, D_HEAT_FLUX, when).value(U_W_M2), tolerance);
+    }
+}
+
+// A temperature constraint can only be applied step by step, so the batch
+// path must refuse rather than return the unconstrained response
+TEST(TemperatureBatchTest, RejectsTemperatureConstraint) {
+    Core core(Logger::SEVERE, false, false);
+    setup_ssp245_core(core, false);
+    core.setData(TEMPERATURE_COMPONENT_NAME, D_TAS_CONSTRAIN,
+                 message_data(2000, unitval(1.0, U_DEGC)));
+    core.prepareToRun();
+
+    TemperatureComponent *temperature = dynamic_cast<TemperatureComponent *>(
+        core.getComponentByName(TEMPERATURE_COMPONENT_NAME));
+    ASSERT_TRUE(temperature != NULL);
+    const std::vector<std::vector<double>> forcing(1, std::vector<double>(10, 1.0));
+    EXPECT_THROW(temperature->run_batch(forcing), h_exception);
+}
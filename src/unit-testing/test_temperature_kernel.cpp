@@ -0,0 +1,132 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_temperature_kernel.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "component_data.hpp"
+#include "core.hpp"
+#include "message_data.hpp"
+#include "test_inputs.hpp"
+
+using namespace Hector;
+
+namespace {
+
+// The tolerance suggested in the input files
+const double KERNEL_TOL = 1e-6;
+
+void setup_core(Core &core, double kernel_tol) {
+    setup_ssp245_core(core, false);
+    core.setData(TEMPERATURE_COMPONENT_NAME, D_KERNEL_TOL,
+                 message_data(unitval(kernel_tol, U_UNITLESS)));
+}
+
+} // namespace
+
+// The sum-of-exponentials kernel must reproduce the exact kernel's
+// temperatures and heat fluxes over a full run
+TEST(TemperatureKernelTest, ExponentialsMatchExactKernel) {
+    Core exact(Logger::SEVERE, false, false);
+    setup_core(exact, 0.0);
+    exact.prepareToRun();
+    exact.run();
+
+    Core approx(Logger::SEVERE, false, false);
+    setup_core(approx, KERNEL_TOL);
+    approx.prepareToRun();
+    approx.run();
+    EXPECT_EQ(approx.sendMessage(M_GETDATA, D_KERNEL_TOL).value(U_UNITLESS), KERNEL_TOL);
+
+    const char *vars[] = {D_GLOBAL_TAS, D_LAND_TAS, D_SST, D_FLUX_MIXED,
+                          D_FLUX_INTERIOR, D_HEAT_FLUX};
+    bool differs = false;
+    for (double date = exact.getStartDate() + 1; date <= exact.getEndDate(); date += 1.0) {
+        const message_data when(date);
+        for (const char *var : vars) {
+            const unitval expected = exact.sendMessage(M_GETDATA, var, when);
+            const unitval actual = approx.sendMessage(M_GETDATA, var, when);
+            ASSERT_EQ(actual.units(), expected.units()) << var;
+            const double e = expected.value(expected.units());
+            const double a = actual.value(actual.units());
+            EXPECT_NEAR(a, e, 1e-5 * (std::fabs(e) + 1)) << var << " " << date;
+            differs = differs || a != e;
+        }
+    }
+    // otherwise the exact kernel was used after all
+    EXPECT_TRUE(differs);
+}
+
+// A tolerance no sum of exponentials can meet falls back to the exact kernel,
+// rather than running with an approximation outside the bound asked for
+TEST(TemperatureKernelTest, UnreachableToleranceUsesExactKernel) {
+    Core exact(Logger::SEVERE, false, false);
+    setup_core(exact, 0.0);
+    exact.prepareToRun();
+    exact.run();
+
+    Core strict(Logger::SEVERE, false, false);
+    setup_core(strict, 1e-15);
+    strict.prepareToRun();
+    strict.run();
+
+    const char *vars[] = {D_GLOBAL_TAS, D_SST, D_HEAT_FLUX};
+    for (double date = exact.getStartDate() + 1; date <= exact.getEndDate(); date += 1.0) {
+        const message_data when(date);
+        for (const char *var : vars) {
+            const unitval expected = exact.sendMessage(M_GETDATA, var, when);
+            const unitval actual = strict.sendMessage(M_GETDATA, var, when);
+            EXPECT_EQ(actual.value(actual.units()), expected.value(expected.units()))
+                << var << " " << date;
+        }
+    }
+}
+
+// Running past endDate grows the time horizon as it goes; the years after
+// endDate must come out as in a run whose endDate covers them from the start
+TEST(TemperatureKernelTest, RunsPastEndDate) {
+    const double endDate = 2100, runDate = 2200;
+    const char *vars[] = {D_GLOBAL_TAS, D_SST, D_HEAT_FLUX};
+    const double tolerances[] = {0.0, KERNEL_TOL};
+    for (double kernel_tol : tolerances) {
+        Core grown(Logger::SEVERE, false, false);
+        setup_core(grown, kernel_tol);
+        grown.setData(CORE_COMPONENT_NAME, D_END_DATE, message_data(unitval(endDate, U_UNDEFINED)));
+        grown.prepareToRun();
+        grown.run(runDate);
+        ASSERT_EQ(grown.getCurrentDate(), runDate);
+
+        Core full(Logger::SEVERE, false, false);
+        setup_core(full, kernel_tol);
+        full.setData(CORE_COMPONENT_NAME, D_END_DATE, message_data(unitval(runDate, U_UNDEFINED)));
+        full.prepareToRun();
+        full.run();
+
+        for (double date = full.getStartDate() + 1; date <= runDate; date += 1.0) {
+            const message_data when(date);
+            for (const char *var : vars) {
+                const unitval expected = full.sendMessage(M_GETDATA, var, when);
+                const unitval actual = grown.sendMessage(M_GETDATA, var, when);
+                const double e = expected.value(expected.units());
+                const double a = actual.value(actual.units());
+                if (kernel_tol == 0) {
+                    // the exact kernel doesn't depend on the horizon
+                    EXPECT_EQ(a, e) << var << " " << date;
+                } else {
+                    // the exponentials are refitted to the grown horizon
+                    EXPECT_NEAR(a, e, 1e-5 * (std::fabs(e) + 1)) << var << " " << date;
+                }
+            }
+        }
+    }
+}
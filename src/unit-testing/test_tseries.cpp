@@ -298,3 +298,75 @@ TEST(TSeriesTest, PartialInterp) {
     EXPECT_THROW( test.get( 3 ), h_exception );
     EXPECT_NO_THROW( test.get( 1.5 ) );
 }
+
+TEST(TSeriesTest, BulkSet) {
+
+    Hector::tseries<double> test;
+    test.set( 2, 20 );
+    test.set( 5, 50 );
+
+    // Overwrites existing dates and fills in around them, in or out of order
+    const double d[] = { 1, 2, 3, 4, 6, 0 };
+    const double v[] = { 1, 2, 3, 4, 6, 0 };
+    test.set( vector<double>( d, d + 6 ), vector<double>( v, v + 6 ) );
+
+    EXPECT_EQ( test.size(), 7 );
+    EXPECT_EQ( test.firstdate(), 0 );
+    EXPECT_EQ( test.lastdate(), 6 );
+    EXPECT_EQ( test.get( 2 ), 2 );
+    EXPECT_EQ( test.get( 5 ), 50 );
+    EXPECT_EQ( test.get( 6 ), 6 );
+
+    EXPECT_THROW( test.set( vector<double>( 2, 1.0 ), vector<double>( 1, 1.0 ) ),
+                  h_exception );
+
+    Hector::tseries<Hector::unitval> uv;
+    EXPECT_NO_THROW( Hector::set_series( uv, vector<double>( d, d + 2 ),
+                                         vector<double>( v, v + 2 ),
+                                         Hector::U_UNDEFINED, Hector::U_TG ) );
+    EXPECT_EQ( uv.get( 2 ).units(), Hector::U_TG );
+    EXPECT_THROW( Hector::set_series( uv, vector<double>( d, d + 2 ),
+                                      vector<double>( v, v + 2 ),
+                                      Hector::U_GG, Hector::U_TG ),
+                  h_exception );
+}
+
+TEST(TSeriesTest, SharedData) {
+
+    Hector::tseries<double> a;
+    a.set( 1, 10 );
+    a.set( 2, 20 );
+
+    // A shared series sees the same data, but changing either copies it
+    Hector::tseries<double> b;
+    b.allowInterp( true );
+    b.share( a );
+    EXPECT_EQ( b.size(), 2 );
+    EXPECT_EQ( b.get( 1.5 ), 15 );
+    b.set( 3, 30 );
+    EXPECT_EQ( a.size(), 2 );
+    EXPECT_EQ( b.size(), 3 );
+    a.truncate( 1 );
+    EXPECT_EQ( a.size(), 1 );
+    EXPECT_EQ( b.get( 2 ), 20 );
+
+    // set_series shares values already in the expected units...
+    const double d[] = { 1, 2 };
+    const double v[] = { 1, 2 };
+    const Hector::tseries<Hector::unitval> tg =
+        Hector::make_series( vector<double>( d, d + 2 ),
+                             vector<double>( v, v + 2 ), Hector::U_TG );
+    Hector::tseries<Hector::unitval> uv;
+    Hector::set_series( uv, tg, Hector::U_TG );
+    EXPECT_EQ( &*uv.begin(), &*tg.begin() );
+
+    // ...and copies them in otherwise
+    Hector::tseries<Hector::unitval> undef =
+        Hector::make_series( vector<double>( d, d + 2 ),
+                             vector<double>( v, v + 2 ), Hector::U_UNDEFINED );
+    Hector::tseries<Hector::unitval> uv2;
+    Hector::set_series( uv2, undef, Hector::U_TG );
+    EXPECT_NE( &*uv2.begin(), &*undef.begin() );
+    EXPECT_EQ( uv2.get( 2 ).units(), Hector::U_TG );
+    EXPECT_THROW( Hector::set_series( uv2, tg, Hector::U_GG ), h_exception );
+}
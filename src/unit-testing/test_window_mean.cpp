@@ -0,0 +1,89 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_window_mean.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "h_exception.hpp"
+#include "window_mean.hpp"
+
+using namespace Hector;
+
+// Direct sum, padding with the first/last values as tseries would
+static double direct_mean(const double *v, int n, int first, int t, int len,
+                          int lag) {
+    double sum = 0.0;
+    for(int y = t - lag - len; y < t - lag; y++) {
+        int i = y - first;
+        if(i < 0) i = 0;
+        if(i >= n) i = n - 1;
+        sum += v[i];
+    }
+    return sum / len;
+}
+
+TEST(WindowMeanTest, RejectsBadInput) {
+    window_mean w;
+    EXPECT_THROW(w.mean(2000), h_exception);
+    EXPECT_THROW(w.set_window(0, 0), h_exception);
+    EXPECT_THROW(w.set_window(5, -1), h_exception);
+
+    w.set(1850, 1.0);
+    w.set(1851, 2.0);
+    EXPECT_THROW(w.set(1853, 3.0), h_exception);
+    EXPECT_THROW(w.set(1849, 3.0), h_exception);
+}
+
+TEST(WindowMeanTest, MatchesDirectSum) {
+    const double v[] = {0.1, -0.3, 0.5, 0.9, 1.4, 1.2, 2.0, 2.7};
+    const int n = 8;
+    window_mean w;
+    for(int i = 0; i < n; i++) {
+        w.set(1850 + i, v[i]);
+    }
+
+    const int lens[] = {1, 3, 20};
+    const int lags[] = {0, 2, 15};
+    for(int len : lens) {
+        for(int lag : lags) {
+            w.set_window(len, lag);
+            for(int t = 1820; t < 1890; t++) {
+                EXPECT_NEAR(w.mean(t), direct_mean(v, n, 1850, t, len, lag),
+                            1e-12) << "len=" << len << " lag=" << lag
+                                   << " t=" << t;
+            }
+        }
+    }
+}
+
+TEST(WindowMeanTest, TruncateAndRerun) {
+    window_mean w;
+    w.set_window(3, 0);
+    for(int i = 0; i < 10; i++) {
+        w.set(2000 + i, i);
+    }
+    EXPECT_DOUBLE_EQ(w.mean(2010), 8.0);
+
+    // Rewriting the latest year replaces it
+    w.set(2009, 12.0);
+    EXPECT_DOUBLE_EQ(w.mean(2010), 9.0);
+
+    w.truncate(2004);
+    EXPECT_EQ(w.size(), 5);
+    EXPECT_DOUBLE_EQ(w.mean(2010), 4.0);
+    w.set(2005, 7.0);
+    EXPECT_DOUBLE_EQ(w.mean(2006), 14.0 / 3.0);
+
+    w.truncate(1990);
+    EXPECT_EQ(w.size(), 0);
+    w.set(2020, 1.5);
+    EXPECT_DOUBLE_EQ(w.mean(2000), 1.5);
+}
@@ -0,0 +1,121 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2022  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  window_mean.cpp
+ *  hector
+ *
+ *  Annual record with O(1) lagged moving-window means.
+ *
+ */
+
+#include <algorithm>
+
+#include "h_exception.hpp"
+#include "window_mean.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//-----------------------------------------------------------------------
+/*! \brief Constructor
+ */
+window_mean::window_mean() : length(1), lag(0), first(0.0) { clear(); }
+
+//-----------------------------------------------------------------------
+/*! \brief            Set the averaging window
+ *  \param[in] len    number of years averaged (>= 1)
+ *  \param[in] lg     years between the end of the window and the date the
+ *                    mean is for (>= 0)
+ */
+void window_mean::set_window(const int len, const int lg) {
+  H_ASSERT(len >= 1, "window length must be at least one year");
+  H_ASSERT(lg >= 0, "window lag must be non-negative");
+  length = len;
+  lag = lg;
+}
+
+//-----------------------------------------------------------------------
+/*! \brief            Record the value for a year
+ *  \param[in] date   the year; must follow the last recorded year, or
+ *                    overwrite the last recorded year
+ *  \param[in] value  value for that year
+ *  \exception        if a year would be skipped or an earlier one changed
+ */
+void window_mean::set(const double date, const double value) {
+  if (values.empty()) {
+    first = date;
+  } else if (date == first + values.size() - 1) {
+    // Re-setting the latest year (e.g. rerunning it)
+    values.pop_back();
+    running.pop_back();
+  }
+  H_ASSERT(date == first + values.size(), "window_mean dates must be annual");
+  values.push_back(value);
+  running.push_back(running.back() + value);
+}
+
+//-----------------------------------------------------------------------
+/*! \brief            Drop all years after a date
+ *  \param[in] date   last year to keep
+ */
+void window_mean::truncate(const double date) {
+  if (values.empty()) {
+    return;
+  }
+  const double keep = max(0.0, min(double(values.size()), date - first + 1));
+  values.resize(size_t(keep));
+  running.resize(values.size() + 1);
+}
+
+//-----------------------------------------------------------------------
+/*! \brief Drop all years
+ */
+void window_mean::clear() {
+  values.clear();
+  running.assign(1, 0.0);
+}
+
+//-----------------------------------------------------------------------
+/*! \brief         Mean over the window ending lag years before t
+ *  \param[in] t   date the mean is for; the window covers years
+ *                 t-lag-length through t-lag-1
+ *  \returns       the window mean
+ *  \exception     if nothing has been recorded
+ */
+double window_mean::mean(const double t) const {
+  H_ASSERT(!values.empty(), "window_mean has no data");
+
+  const double last = first + values.size() - 1;
+  const double lo = t - lag - length;
+  const double hi = t - lag - 1;
+
+  double sum = 0.0;
+
+  // Years before the record take its first value...
+  const double nbefore = min(hi, first - 1) - lo + 1;
+  if (nbefore > 0) {
+    sum += nbefore * values.front();
+  }
+
+  // ...years after it take its last value...
+  const double nafter = hi - max(lo, last + 1) + 1;
+  if (nafter > 0) {
+    sum += nafter * values.back();
+  }
+
+  // ...and the rest come from the running sums
+  const double a = max(lo, first);
+  const double b = min(hi, last);
+  if (a <= b) {
+    sum += running[size_t(b - first) + 1] - running[size_t(a - first)];
+  }
+
+  return sum / length;
+}
+
+} // namespace Hector